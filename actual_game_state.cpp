@@ -19,17 +19,20 @@
 
 #include "actual_game_state.h"
 
+#include "game_log.h"
 #include "game_type.h"
+#include "logging.h"
 #include "options.h"
 #include "player.h"
 
-#include <iostream>
+#include <ostream>
 
 using namespace std;
 
 ActualGameState::ActualGameState(const Options &options, Player *players_[4], int first_player,
-                                 Cards cards_[4], const bool played_compulsory_solo_[4], bool vorfuehrung)
-    : GameState(options, true) {
+                                 Cards cards_[4], const bool played_compulsory_solo_[4], bool vorfuehrung,
+                                 GameLogWriter *game_log_writer_)
+    : GameState(options, true), game_log_writer(game_log_writer_) {
     for (int i = 0; i < 4; ++i) {
         cards[i] = cards_[i];
         players[i] = players_[i];
@@ -40,11 +43,11 @@ ActualGameState::ActualGameState(const Options &options, Player *players_[4], in
 
 void ActualGameState::print_trick() const {
     // print the last completed trick
-    if (tricks.size() > 1) { // start printing when the first trick is completed, i.e. the second (emtpy) one has been inserted
-        if (tricks.back().empty()) // if the most recent (i.e. current) trick is empty, dump the most recent completed one
-            tricks[tricks.size() - 2].dump();
+    if (number_of_tricks > 1) { // start printing when the first trick is completed, i.e. the second (emtpy) one has been inserted
+        if (get_current_trick().empty()) // if the most recent (i.e. current) trick is empty, dump the most recent completed one
+            tricks[number_of_tricks - 2].dump();
         if (game_finished()) // after the 12th trick, there is no new empty trick being inserted into tricks, therefore dump the last one
-            tricks.back().dump();
+            get_current_trick().dump();
     }
 }
 
@@ -53,6 +56,8 @@ size_t ActualGameState::make_move(int player, const vector<Move> &move_options)
     if (move_no < 0 || move_no >= move_options.size())
         players[player]->invalid_move();
     const Move &move = move_options[move_no];
+    if (game_log_writer != 0)
+        game_log_writer->add_move(player, move);
     for (int i = 0; i < 4; ++i) {
         players[i]->inform_about_move(player, move);
     }
@@ -64,16 +69,16 @@ bool ActualGameState::shorten_reservation_procedure(int player) {
     legal_immediate_solo_moves.push_back(Move(IMMEDIATE_SOLO, false));
     legal_immediate_solo_moves.push_back(Move(IMMEDIATE_SOLO, true));
     size_t move_no = make_move(player, legal_immediate_solo_moves);
-    if (options.use_verbose())
-        cout << "player " << player;
+    if (log_enabled(LOG_GAME, LOG_VERBOSE))
+        log_stream() << "player " << player;
     if (legal_immediate_solo_moves[move_no].get_answer()) {
-        if (options.use_verbose())
-            cout << " shortens reservation procedure and will announce a solo" << endl;
+        if (log_enabled(LOG_GAME, LOG_VERBOSE))
+            log_stream() << " shortens reservation procedure and will announce a solo\n";
         ask_player_for_solo(player);
         return true;
     } else {
-        if (options.use_verbose())
-            cout << " does not announce an immediate solo" << endl;
+        if (log_enabled(LOG_GAME, LOG_VERBOSE))
+            log_stream() << " does not announce an immediate solo\n";
     }
     return false;
 }
@@ -93,9 +98,11 @@ void ActualGameState::ask_player_for_solo(int player) {
     if (!played_compulsory_solo[player])
         compulsory_solo = true;
     assign_solo_player_to_re_team(player);
-    if (compulsory_solo)
-        cout << "compulsory solo: ";
-    cout << "player " << player << " plays a " << *game_type << endl;
+    if (log_enabled(LOG_GAME, LOG_INFO)) {
+        if (compulsory_solo)
+            log_stream() << "compulsory solo: ";
+        log_stream() << "player " << player << " plays a " << *game_type << '\n';
+    }
 }
 
 void ActualGameState::determine_game_type(int first_player, bool vorfuehrung) {
@@ -107,7 +114,8 @@ void ActualGameState::determine_game_type(int first_player, bool vorfuehrung) {
                 legal_game_type_moves.push_back(Move(&marriage));
                 size_t move_no = make_move(player, legal_game_type_moves);
                 assert(move_no == 0);
-                cout << "player " << player << " has a marriage" << endl;
+                if (log_enabled(LOG_GAME, LOG_INFO))
+                    log_stream() << "player " << player << " has a marriage\n";
                 game_type = &marriage;
                 solo_or_marriage_player = player;
                 players_team[player] = 1;
@@ -123,7 +131,8 @@ void ActualGameState::determine_game_type(int first_player, bool vorfuehrung) {
         }
         // no marriage -> regular game
         // TODO: also this part is copied from below, see "reservation == 0"
-        cout << "regular game will be played" << endl;
+        if (log_enabled(LOG_GAME, LOG_INFO))
+            log_stream() << "regular game will be played\n";
         game_type = &regular;
         for (int i = 0; i < 4; ++i) {
             if (cards[i].contains_card(CQ) || cards[i].contains_card(CQ_))
@@ -136,7 +145,8 @@ void ActualGameState::determine_game_type(int first_player, bool vorfuehrung) {
 
     // in the case of vorfuehrung, just ask the first player for his solo game
     if (vorfuehrung) {
-        cout << "vorfuehrung: ";
+        if (log_enabled(LOG_GAME, LOG_INFO))
+            log_stream() << "vorfuehrung: ";
         ask_player_for_solo(first_player);
         return;
     }
@@ -163,18 +173,18 @@ void ActualGameState::determine_game_type(int first_player, bool vorfuehrung) {
     player = first_player; // iterate starting with first player
     for (int i = 0; i < 4; ++i) {
         size_t move_no = make_move(player, legal_has_reservation_moves);
-        if (options.use_verbose())
-            cout << "player " << player;
+        if (log_enabled(LOG_GAME, LOG_VERBOSE))
+            log_stream() << "player " << player;
         if (legal_has_reservation_moves[move_no].get_answer()) {
-            if (options.use_verbose())
-                cout << " has a reservation" << endl;
+            if (log_enabled(LOG_GAME, LOG_VERBOSE))
+                log_stream() << " has a reservation\n";
             reservations[player] = true;
             ++reservation_count;
             if (!played_compulsory_solo[player])
                 no_player_with_reservation_and_open_compulsory_solo = false;
         } else {
-            if (options.use_verbose())
-                cout << " is gesund" << endl;
+            if (log_enabled(LOG_GAME, LOG_VERBOSE))
+                log_stream() << " is gesund\n";
         }
         // do not ask players again after all 4 have been asked (i.e. in iteration 3)
         if (i != 3) {
@@ -205,7 +215,8 @@ void ActualGameState::determine_game_type(int first_player, bool vorfuehrung) {
 
     // no reservations: play regular game (which may be a secret solo, of course)
     if (reservation_count == 0) {
-        cout << "regular game will be played" << endl;
+        if (log_enabled(LOG_GAME, LOG_INFO))
+            log_stream() << "regular game will be played\n";
         game_type = &regular;
         for (int i = 0; i < 4; ++i) {
             if (cards[i].contains_card(CQ) || cards[i].contains_card(CQ_))
@@ -228,11 +239,11 @@ void ActualGameState::determine_game_type(int first_player, bool vorfuehrung) {
                 legal_is_solo_moves.push_back(Move(IS_SOLO, false));
             legal_is_solo_moves.push_back(Move(IS_SOLO, true));
             size_t move_no = make_move(player, legal_is_solo_moves);
-            if (options.use_verbose())
-                cout << "player " << player;
+            if (log_enabled(LOG_GAME, LOG_VERBOSE))
+                log_stream() << "player " << player;
             if (legal_is_solo_moves[move_no].get_answer()) {
-                if (options.use_verbose())
-                    cout << " wants to play a solo" << endl;
+                if (log_enabled(LOG_GAME, LOG_VERBOSE))
+                    log_stream() << " wants to play a solo\n";
                 if (reservation_count == 1 || !played_compulsory_solo[player] || no_player_with_reservation_and_open_compulsory_solo) {
                     // admit the only player who wants to play solo, first player with a compulsory solo or the first player who wants to play a lust solo if there is no player with open compulsory solo who has a reservation
                     // NOTE: the check for reservation_count == 1 is actually not necessary because if the player is not being asked right here, he still will be asked after this loop has finished (as there are no more cases for which "reservations" is true)
@@ -243,14 +254,15 @@ void ActualGameState::determine_game_type(int first_player, bool vorfuehrung) {
                         first_positioned_player_for_a_lust_solo = player;
                 }
             } else { // no solo reservation => must be a marriage reservation!
-                if (options.use_verbose())
-                    cout << " does not want to play a solo" << endl;
+                if (log_enabled(LOG_GAME, LOG_VERBOSE))
+                    log_stream() << " does not want to play a solo\n";
                 if (reservation_count == 1) { // marriage is only allowed if nobody else has a reservation
                     vector<Move> legal_game_type_moves;
                     legal_game_type_moves.push_back(Move(&marriage));
                     size_t move_no = make_move(player, legal_game_type_moves);
                     assert(move_no == 0);
-                    cout << "player " << player << " has a marriage" << endl;
+                    if (log_enabled(LOG_GAME, LOG_INFO))
+                        log_stream() << "player " << player << " has a marriage\n";
                     game_type = &marriage;
                     solo_or_marriage_player = player;
                     players_team[player] = 1;
@@ -279,7 +291,7 @@ void ActualGameState::play(int first_player, bool vorfuehrung) {
     int players_left_to_ask_about_announcement = 4;
     if (compulsory_solo)
         first_player = solo_or_marriage_player;
-    tricks.push_back(Trick(game_type, first_player));
+    add_trick(first_player);
     int player_to_ask = first_player;
     int current_player = first_player;
     while (!game_finished()) {
@@ -292,8 +304,8 @@ void ActualGameState::play(int first_player, bool vorfuehrung) {
                 size_t move_no = make_move(player_to_ask, legal_announcements);
                 announcement_t announcement = legal_announcements[move_no].get_announcement();
                 if (announcement != NONE) {
-                    if (options.use_verbose())
-                        cout << "player " << player_to_ask << " belonging to team " << (players_team[player_to_ask] == 1 ? "re" : "kontra") << " announced: " << announcement << endl;
+                    if (log_enabled(LOG_GAME, LOG_VERBOSE))
+                        log_stream() << "player " << player_to_ask << " belonging to team " << (players_team[player_to_ask] == 1 ? "re" : "kontra") << " announced: " << announcement << '\n';
                     if (options.get_announcing_version() == 0 || announcement == SCHWARZ || (announcement == REKON && corrected_number_of_cards(cards[player_to_ask].size()) < 11))
                         players_left_to_ask_about_announcement = 3; // do not ask the same player again if he announced black or did a reply
                     else
@@ -302,8 +314,8 @@ void ActualGameState::play(int first_player, bool vorfuehrung) {
                     assert(players_team[player_to_ask] == is_re_player);
                     set_announcement(player_to_ask, announcement, is_re_player, cards[player_to_ask].size());
                 } else {
-                    if (options.use_verbose())
-                        cout << "player " << player_to_ask << " does not announce anything" << endl;
+                    if (log_enabled(LOG_GAME, LOG_VERBOSE))
+                        log_stream() << "player " << player_to_ask << " does not announce anything\n";
                     --players_left_to_ask_about_announcement;
                 }
             } else {
@@ -316,19 +328,20 @@ void ActualGameState::play(int first_player, bool vorfuehrung) {
                 player_to_ask = -1;
         } else {
             vector<Move> legal_cards;
-            tricks.back().get_legal_cards_for_player(current_player, legal_cards, cards[current_player]);
+            get_current_trick().get_legal_cards_for_player(current_player, legal_cards, cards[current_player]);
             size_t move_no = make_move(current_player, legal_cards);
             Card card = legal_cards[move_no].get_card();
-            if (options.use_verbose())
-                cout << "player " << current_player << " played card: " << card << endl;
+            if (log_enabled(LOG_GAME, LOG_VERBOSE))
+                log_stream() << "player " << current_player << " played card: " << card << '\n';
             player_to_ask = next_player(current_player); // next player should be asked for an announcement
             current_player = update(current_player, card);
             //if (cards[0].size() == 10)
                 //assert(false);
             players_left_to_ask_about_announcement = 3;
-            if (options.use_verbose())
+            if (log_enabled(LOG_GAME, LOG_VERBOSE))
                 print_trick();
         }
     }
-    cout << "game finished" << endl << endl;
+    if (log_enabled(LOG_GAME, LOG_INFO))
+        log_stream() << "game finished\n\n";
 }
@@ -32,12 +32,14 @@ Announcements:
 In order to avoid leaking information to players which they cannot have, it is important to always ask *all* players for an announcement as long as *any* player is still allowed to do an announcement. this may result in a move for a player where his only option is to say "no announcement", because he is not allowed anymore to make an announcement.
 */
 
+class GameLogWriter;
 class Player;
 
 class ActualGameState : public GameState {
 private:
     Player *players[4];
     bool played_compulsory_solo[4];
+    GameLogWriter *game_log_writer; // records every move if not 0
 
     void print_trick() const;
     size_t make_move(int player, const std::vector<Move> &move_options) const;
@@ -47,7 +49,8 @@ private:
     void play(int first_player, bool vorfuehrung);
 public:
     ActualGameState(const Options &options, Player *players[4], int first_player,
-                    Cards cards[4], const bool played_compulsory_solo[4], bool vorfuehrung);
+                    Cards cards[4], const bool played_compulsory_solo[4], bool vorfuehrung,
+                    GameLogWriter *game_log_writer);
 };
 
 #endif
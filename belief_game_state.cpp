@@ -20,13 +20,20 @@
 #include "belief_game_state.h"
 
 #include "game_type.h"
+#include "logging.h"
 #include "options.h"
 
+#include <algorithm>
 #include <iostream>
-#include <set>
+#include <sstream>
+#include <string>
+#include <type_traits>
 
 using namespace std;
 
+// Uct copies the state for every rollout; these copies should stay plain memory copies (see GameState::tricks)
+static_assert(is_trivially_copyable<BeliefGameState>::value, "BeliefGameState must be trivially copyable");
+
 BeliefGameState::BeliefGameState(const Options &options, int player_number_, const bool played_compulsory_solo_[4],
                                  bool vorfuehrung, int first_player_, Cards players_cards)
     : GameState(options, false), player_number(player_number_), first_player(first_player_),
@@ -53,6 +60,10 @@ BeliefGameState::BeliefGameState(const Options &options, int player_number_, con
     no_player_with_reservation_and_open_compulsory_solo = true;
     players_left_to_ask_about_is_solo_move = 0;
     first_positioned_player_for_a_lust_solo = -1;
+    // not needed before being set in set_move, but initialized such that equal states have equal serializations
+    player_after_last_player_allowed_to_shorten = -1;
+    players_left_to_ask_about_announcement = 0;
+    player_to_play_card = -1;
 
     determine_first_move(vorfuehrung);
 }
@@ -63,13 +74,13 @@ void BeliefGameState::determine_first_move(bool vorfuehrung) {
         // the first move is an announcement move. We capture the case of a
         // marriage in set_move().
         game_type = &regular;
-        assert(tricks.empty());
-        tricks.push_back(Trick(game_type, player_to_move)); // initialize tricks already here that get_legal_moves works also for an uct player who is starting the card play (thus setting it when playing the first card would be too late)
+        assert(number_of_tricks == 0);
+        add_trick(player_to_move); // initialize tricks already here that get_legal_moves works also for an uct player who is starting the card play (thus setting it when playing the first card would be too late)
         next_move_type = Move(NONE, false);
-        if (options.use_debug() && uct_output)
-            cout << "regular game will be played" << endl;
-        if (options.use_debug() && uct_output)
-            cout << "next move will be: announcement move" << endl;
+        if (log_enabled(LOG_BELIEF_STATE, LOG_DEBUG) && uct_output)
+            log_stream() << "regular game will be played\n";
+        if (log_enabled(LOG_BELIEF_STATE, LOG_DEBUG) && uct_output)
+            log_stream() << "next move will be: announcement move\n";
     } else if (vorfuehrung) {
         next_move_type = Move(&regular);
     } else {
@@ -128,18 +139,18 @@ void BeliefGameState::set_immediate_solo_move(const Move &move) {
         //cout << "set move: move is immediate solo move" << endl;
     // player announces an immediate solo
     if (move.get_answer()) {
-        if (options.use_debug() && uct_output)
-            cout << " shortens reservation procedure and will announce a solo" << endl;
+        if (log_enabled(LOG_BELIEF_STATE, LOG_DEBUG) && uct_output)
+            log_stream() << " shortens reservation procedure and will announce a solo\n";
         next_move_type = Move(&regular);
         // no need to update player_to_move
-        if (options.use_debug() && uct_output)
-            cout << "next move will be: game type move" << endl;
+        if (log_enabled(LOG_BELIEF_STATE, LOG_DEBUG) && uct_output)
+            log_stream() << "next move will be: game type move\n";
         return;
     }
 
     // else: player does not announce an immediate solo
-    if (options.use_debug() && uct_output)
-        cout << " does not announce an immediate solo" << endl;
+    if (log_enabled(LOG_BELIEF_STATE, LOG_DEBUG) && uct_output)
+        log_stream() << " does not announce an immediate solo\n";
     next_move_type = Move(HAS_RESERVATION, false);
     player_after_last_player_allowed_to_shorten = next_player(player_to_move);
     if (players_left_to_ask_a_question == 4) {
@@ -150,24 +161,24 @@ void BeliefGameState::set_immediate_solo_move(const Move &move) {
         // go back to the next player who needs to be asekd for a regular reservation
         player_to_move = player_to_ask_after_next_immediate_solo_move;
     }
-    if (options.use_debug() && uct_output)
-        cout << "next move will be: has reservation move" << endl;
+    if (log_enabled(LOG_BELIEF_STATE, LOG_DEBUG) && uct_output)
+        log_stream() << "next move will be: has reservation move\n";
 }
 
 void BeliefGameState::set_has_reservation_move(const Move &move) {
     //if (options.use_debug() && uct_output)
         //cout << "set move: move is has reservation move" << endl;
     if (move.get_answer()) {
-        if (options.use_debug() && uct_output)
-            cout << " has a reservation" << endl;
+        if (log_enabled(LOG_BELIEF_STATE, LOG_DEBUG) && uct_output)
+            log_stream() << " has a reservation\n";
         has_reservation[player_to_move] = true;
         ++reservation_count;
         if (!played_compulsory_solo[player_to_move])
             no_player_with_reservation_and_open_compulsory_solo = false;
         ++players_left_to_ask_about_is_solo_move;
     } else {
-        if (options.use_debug() && uct_output)
-            cout << " is gesund" << endl;
+        if (log_enabled(LOG_BELIEF_STATE, LOG_DEBUG) && uct_output)
+            log_stream() << " is gesund\n";
     }
     player_to_move = next_player(player_to_move);
     if (players_left_to_ask_a_question > 0) {
@@ -186,13 +197,13 @@ void BeliefGameState::set_has_reservation_move(const Move &move) {
             if (player_it != first_player) // found a player who is now allowed to shorten the reservation procedure
                 player_to_move = player_it;
             // else: no need to update player_to_move as the player who just denied an immediate solo is going to be asked for a regular reservation
-            if (options.use_debug() && uct_output)
-                cout << "next move will be: immediate solo move" << endl;
+            if (log_enabled(LOG_BELIEF_STATE, LOG_DEBUG) && uct_output)
+                log_stream() << "next move will be: immediate solo move\n";
         } else {
             // no need to update next_move_type
             // player_to_move already updated
-            if (options.use_debug() && uct_output)
-                cout << "next move will be: has reservation move" << endl;
+            if (log_enabled(LOG_BELIEF_STATE, LOG_DEBUG) && uct_output)
+                log_stream() << "next move will be: has reservation move\n";
         }
         return;
     }
@@ -207,20 +218,20 @@ void BeliefGameState::set_has_reservation_move(const Move &move) {
             player_to_move = next_player(player_to_move);
         }
         --players_left_to_ask_about_is_solo_move; // first player is going to be asked next
-        if (options.use_debug() && uct_output)
-            cout << "next move will be: is solo move" << endl;
+        if (log_enabled(LOG_BELIEF_STATE, LOG_DEBUG) && uct_output)
+            log_stream() << "next move will be: is solo move\n";
         return;
     }
 
     // else: no reservations, thus play regular game
     game_type = &regular;
-    assert(tricks.empty());
-    tricks.push_back(Trick(game_type, player_to_move)); // initialize tricks already here that get_legal_moves works also for an uct player who is starting the card play (thus setting it when playing the first card would be too late)
+    assert(number_of_tricks == 0);
+    add_trick(player_to_move); // initialize tricks already here that get_legal_moves works also for an uct player who is starting the card play (thus setting it when playing the first card would be too late)
     next_move_type = Move(NONE, false);
-    if (options.use_debug() && uct_output)
-        cout << "regular game will be played" << endl;
-    if (options.use_debug() && uct_output)
-        cout << "next move will be: announcement move" << endl;
+    if (log_enabled(LOG_BELIEF_STATE, LOG_DEBUG) && uct_output)
+        log_stream() << "regular game will be played\n";
+    if (log_enabled(LOG_BELIEF_STATE, LOG_DEBUG) && uct_output)
+        log_stream() << "next move will be: announcement move\n";
 }
 
 void BeliefGameState::set_is_solo_move(const Move &move) {
@@ -228,14 +239,14 @@ void BeliefGameState::set_is_solo_move(const Move &move) {
     //cout << "set move: move is is solo move" << endl;
     // player wants to play a solo
     if (move.get_answer()) {
-        if (options.use_debug() && uct_output)
-            cout << " wants to play a solo" << endl;
+        if (log_enabled(LOG_BELIEF_STATE, LOG_DEBUG) && uct_output)
+            log_stream() << " wants to play a solo\n";
         // admit a player to play solo if there is only one reservation, if he did not play a compulsory solo (i.e. he is the first positioned player with an open compulsory solo and thus has highest priority) or if there is no player with open compulsory solo and a reservation (i.e. he is the first positioned player to play a solo and nobody else can have higher priority than he does)
         if (reservation_count == 1 || !played_compulsory_solo[player_to_move] || no_player_with_reservation_and_open_compulsory_solo) {
             next_move_type = Move(&regular);
             // no need to update player_to_move
-            if (options.use_debug() && uct_output)
-                cout << "next move will be: game type move" << endl;
+            if (log_enabled(LOG_BELIEF_STATE, LOG_DEBUG) && uct_output)
+                log_stream() << "next move will be: game type move\n";
             return;
         }
 
@@ -246,8 +257,8 @@ void BeliefGameState::set_is_solo_move(const Move &move) {
 
     // player does not want to play a solo
     if (!move.get_answer()) {
-        if (options.use_debug() && uct_output)
-            cout << " does not want to play a solo" << endl;
+        if (log_enabled(LOG_BELIEF_STATE, LOG_DEBUG) && uct_output)
+            log_stream() << " does not want to play a solo\n";
         // answering no implies the player wants to play a marriage
         set_player_to_have_queen_of_clubs(player_to_move, CQ);
         set_player_to_have_queen_of_clubs(player_to_move, CQ_);
@@ -255,8 +266,8 @@ void BeliefGameState::set_is_solo_move(const Move &move) {
             next_move_type = Move(&regular);
             // no need to update player_to_move
             is_marriage = true;
-            if (options.use_debug() && uct_output)
-                cout << "next move will be: game type move" << endl;
+            if (log_enabled(LOG_BELIEF_STATE, LOG_DEBUG) && uct_output)
+                log_stream() << "next move will be: game type move\n";
             return;
         }
     }
@@ -270,8 +281,8 @@ void BeliefGameState::set_is_solo_move(const Move &move) {
         while (!has_reservation[player_to_move]) {
             player_to_move = next_player(player_to_move);
         }
-        if (options.use_debug() && uct_output)
-            cout << "next move will be: is solo move" << endl;
+        if (log_enabled(LOG_BELIEF_STATE, LOG_DEBUG) && uct_output)
+            log_stream() << "next move will be: is solo move\n";
         return;
     }
 
@@ -279,8 +290,8 @@ void BeliefGameState::set_is_solo_move(const Move &move) {
     next_move_type = Move(&regular);
     assert(first_positioned_player_for_a_lust_solo != -1);
     player_to_move = first_positioned_player_for_a_lust_solo;
-    if (options.use_debug() && uct_output)
-        cout << "next move will be: game type move" << endl;
+    if (log_enabled(LOG_BELIEF_STATE, LOG_DEBUG) && uct_output)
+        log_stream() << "next move will be: game type move\n";
 }
 
 void BeliefGameState::set_game_type_move(const Move &move) {
@@ -291,8 +302,8 @@ void BeliefGameState::set_game_type_move(const Move &move) {
     solo_or_marriage_player = player_to_move;
     // player_to_move plays a solo
     if (*game_type != marriage) {
-        if (options.use_debug() && uct_output)
-            cout << " plays a " << *game_type << endl;
+        if (log_enabled(LOG_BELIEF_STATE, LOG_DEBUG) && uct_output)
+            log_stream() << " plays a " << *game_type << '\n';
         assign_solo_player_to_re_team(player_to_move);
         next_move_type = Move(NONE, false);
         if (!played_compulsory_solo[player_to_move]) {
@@ -302,8 +313,8 @@ void BeliefGameState::set_game_type_move(const Move &move) {
             player_to_move = first_player;
         }
         assert(announcement_possible(player_to_move, players_cards_count[player_to_move]));
-        if (options.use_debug() && uct_output)
-            cout << "next move will be: announcement move" << endl;
+        if (log_enabled(LOG_BELIEF_STATE, LOG_DEBUG) && uct_output)
+            log_stream() << "next move will be: announcement move\n";
         return;
     }
 
@@ -320,10 +331,10 @@ void BeliefGameState::set_game_type_move(const Move &move) {
     }
     next_move_type = Move(no_card);
     player_to_move = first_player;
-    if (options.use_debug() && uct_output)
-        cout << " has a marriage" << endl;
-    if (options.use_debug() && uct_output)
-        cout << "next move will be: card move" << endl;
+    if (log_enabled(LOG_BELIEF_STATE, LOG_DEBUG) && uct_output)
+        log_stream() << " has a marriage\n";
+    if (log_enabled(LOG_BELIEF_STATE, LOG_DEBUG) && uct_output)
+        log_stream() << "next move will be: card move\n";
 }
 
 void BeliefGameState::set_announcement_move(const Move &move) {
@@ -334,8 +345,8 @@ void BeliefGameState::set_announcement_move(const Move &move) {
     // player is doing an announcement
     if (announcement != NONE) {
         bool is_re_player = move.get_re_team();
-        if (options.use_debug() && uct_output)
-            cout << " belonging to team " << (is_re_player ? "re" : "kontra") << " announced: " << announcement << endl;
+        if (log_enabled(LOG_BELIEF_STATE, LOG_DEBUG) && uct_output)
+            log_stream() << " belonging to team " << (is_re_player ? "re" : "kontra") << " announced: " << announcement << '\n';
 
         // set cards which players cannot have / must have (queens of clubs) (avoid setting this repeatedly because when a player finally played a queen of clubs, players_must_have_queen_of_clubs is set false for him and could become true again which causes problems to card assignment)
         if (*game_type == regular && player_to_move != player_number && players_known_team[player_to_move] == -1) {
@@ -399,8 +410,8 @@ void BeliefGameState::set_announcement_move(const Move &move) {
 
     // player does not do an announcement, thus just finish asking the remaining players
     if (announcement == NONE) {
-        if (options.use_debug() && uct_output)
-            cout << " does not announce anything" << endl;
+        if (log_enabled(LOG_BELIEF_STATE, LOG_DEBUG) && uct_output)
+            log_stream() << " does not announce anything\n";
     }
 
     if (players_left_to_ask_about_announcement != 4) // players_left_to_ask_about_announcement can only be set to four if the announcing version used is 1 and if a player just did an announcement and thus he should be asked again. otherwise the next player should be asked, no matter which announcing version is being used
@@ -413,8 +424,8 @@ void BeliefGameState::set_card_move(const Move &move) {
         //cout << "set move: move is card move" << endl;
     --players_cards_count[player_to_move];
     Card card = move.get_card();
-    if (options.use_debug() && uct_output)
-        cout << " played card " << card << endl;
+    if (log_enabled(LOG_BELIEF_STATE, LOG_DEBUG) && uct_output)
+        log_stream() << " played card " << card << '\n';
     // for a regular game and if a queen of clubs was played, update cards_that_players_cannot_have
     if (*game_type == regular && (card == CQ || card == CQ_)) {
         if (players_must_have_queen_of_clubs[player_to_move])
@@ -438,7 +449,7 @@ void BeliefGameState::set_card_move(const Move &move) {
     if (!cards[player_to_move].contains_card(card))
         cards[player_to_move].add_card(card);
     played_cards.add_card(card);
-    Cards trick_suit = tricks.back().get_trick_suit();
+    Cards trick_suit = get_current_trick().get_trick_suit();
     if (!trick_suit.contains_card(card))
         cards_that_players_cannot_have[player_to_move].add_cards(trick_suit);
     player_to_move = next_player(player_to_move); // next player should be asked for an announcement
@@ -450,26 +461,26 @@ void BeliefGameState::set_move(int player, const Move &move) {
     if (options.solo_disabled() && move.is_game_type_move()) {
         // undo regular game assumption
         game_type = 0;
-        tricks.clear();
+        number_of_tricks = 0;
         player_to_move = player;
         next_move_type = Move(&regular);
     }
     if (player != player_to_move)
-        cout << player << " " << player_to_move << endl;
+        log_stream() << player << " " << player_to_move << '\n';
     assert(player == player_to_move);
     if (move.is_question_move() != next_move_type.is_question_move() || move.is_game_type_move() != next_move_type.is_game_type_move()
         || move.is_announcement_move() != next_move_type.is_announcement_move() || move.is_card_move() != next_move_type.is_card_move()) {
-        cout << move.is_question_move() << " " << next_move_type.is_question_move() << endl;
-        cout << move.is_game_type_move() << " " << next_move_type.is_game_type_move() << endl;
-        cout << move.is_announcement_move() << " " << next_move_type.is_announcement_move() << endl;
-        cout << move.is_card_move() << " " << next_move_type.is_card_move() << endl;
+        log_stream() << move.is_question_move() << " " << next_move_type.is_question_move() << '\n';
+        log_stream() << move.is_game_type_move() << " " << next_move_type.is_game_type_move() << '\n';
+        log_stream() << move.is_announcement_move() << " " << next_move_type.is_announcement_move() << '\n';
+        log_stream() << move.is_card_move() << " " << next_move_type.is_card_move() << '\n';
     }
     assert(move.is_question_move() == next_move_type.is_question_move());
     assert(move.is_game_type_move() == next_move_type.is_game_type_move());
     assert(move.is_announcement_move() == next_move_type.is_announcement_move());
     assert(move.is_card_move() == next_move_type.is_card_move());
-    if (options.use_debug() && uct_output)
-        cout << "(uct instance) player " << player;
+    if (log_enabled(LOG_BELIEF_STATE, LOG_DEBUG) && uct_output)
+        log_stream() << "(uct instance) player " << player;
     if (move.is_question_move()) {
         switch (move.get_question_type()) {
             case IMMEDIATE_SOLO:
@@ -486,8 +497,8 @@ void BeliefGameState::set_move(int player, const Move &move) {
     if (move.is_game_type_move()) {
         set_game_type_move(move);
         // TODO: the following two lines also exist in set_has_reservation_move()
-        assert(tricks.empty());
-        tricks.push_back(Trick(game_type, player_to_move)); // initialize tricks already here such that get_legal_moves works also for an uct player who is starting the card play (thus setting it when playing the first card would be too late)
+        assert(number_of_tricks == 0);
+        add_trick(player_to_move); // initialize tricks already here such that get_legal_moves works also for an uct player who is starting the card play (thus setting it when playing the first card would be too late)
         return;
     }
 
@@ -509,8 +520,8 @@ void BeliefGameState::set_move(int player, const Move &move) {
         bool ann_poss = announcement_possible(player_to_move, players_cards_count[player_to_move]);
         if (ann_poss) {
             next_move_type = Move(NONE, false);
-            if (options.use_debug() && uct_output)
-                cout << "next move will be: announcement move" << endl;
+            if (log_enabled(LOG_BELIEF_STATE, LOG_DEBUG) && uct_output)
+                log_stream() << "next move will be: announcement move\n";
             return;
         }
         player_to_move = next_player(player_to_move);
@@ -518,16 +529,16 @@ void BeliefGameState::set_move(int player, const Move &move) {
     assert(players_left_to_ask_about_announcement == 0); // all players have been asked for an announcement (or no player is allowed to do any further announcements), thus the next move is a card move
     next_move_type = Move(no_card);
     player_to_move = player_to_play_card;
-    if (options.use_debug() && uct_output)
-        cout << "next move will be: card move" << endl;
+    if (log_enabled(LOG_BELIEF_STATE, LOG_DEBUG) && uct_output)
+        log_stream() << "next move will be: card move\n";
 }
 
 void BeliefGameState::get_legal_moves(vector<Move> &legal_moves) const {
     if (!(!cards[0].empty() || !cards[1].empty() || !cards[2].empty() || !cards[3].empty())) {
-        cout << "player 0: " << cards[0] << endl;
-        cout << "player 1: " << cards[1] << endl;
-        cout << "player 2: " << cards[2] << endl;
-        cout << "player 3: " << cards[3] << endl;
+        log_stream() << "player 0: " << cards[0] << '\n';
+        log_stream() << "player 1: " << cards[1] << '\n';
+        log_stream() << "player 2: " << cards[2] << '\n';
+        log_stream() << "player 3: " << cards[3] << '\n';
     }
     assert(!cards[0].empty() || !cards[1].empty() || !cards[2].empty() || !cards[3].empty());
     if (next_move_type.is_question_move()) {
@@ -562,197 +573,1038 @@ void BeliefGameState::get_legal_moves(vector<Move> &legal_moves) const {
         assert(announcement_possible(player_to_move, players_cards_count[player_to_move]));
         get_legal_announcements_for_player(player_to_move, legal_moves);
     } else if (next_move_type.is_card_move()) {
-        tricks.back().get_legal_cards_for_player(player_to_move, legal_moves, cards[player_to_move]);
+        get_current_trick().get_legal_cards_for_player(player_to_move, legal_moves, cards[player_to_move]);
     }
 }
 
-int BeliefGameState::play_valuable_card(const vector<Card> &possible_cards) const {
-    int value_to_check = 11;
-    while (true) {
-        // iterate over all cards searching for a card worth value_to_check points. if not successful, decrease value_to_check and repeat.
-        for (size_t i = 0; i < possible_cards.size(); ++i) {
-            if (possible_cards[i].get_value() == value_to_check)
-                return i;
+void BeliefGameState::get_owners_legal_moves(vector<Move> &legal_moves) const {
+    assert(player_to_move == player_number);
+    BeliefGameState state(*this);
+    Cards no_cards[4];
+    state.set_other_players_cards(no_cards);
+    state.get_legal_moves(legal_moves);
+}
+
+void BeliefGameState::merge_equivalent_cards(vector<Move> &legal_cards) const {
+    // the cards of the current trick still take part in deciding who wins the trick, thus only count cards of completed tricks as known
+    Cards known_cards = played_cards;
+    known_cards.remove_cards(get_current_trick().get_cards());
+    known_cards.add_cards(cards[player_to_move]);
+    // cards with side effects are never merged with cards of other ranks: a club jack winning the last trick scores a charlie and, while the teams of a regular game are not known, playing a queen of clubs reveals the player's team
+    Cards special_cards;
+    special_cards.add_card(CJ);
+    special_cards.add_card(CJ_);
+    if (*game_type == regular && !teams_are_known) {
+        special_cards.add_card(CQ);
+        special_cards.add_card(CQ_);
+    }
+    size_t number_of_cards = 0;
+    for (size_t i = 0; i < legal_cards.size(); ++i) {
+        Card card = legal_cards[i].get_card();
+        bool equivalent_card_found = false;
+        if (!special_cards.contains_card(card)) {
+            // equivalence is transitive, thus comparing to the first card of every class suffices
+            for (size_t j = 0; j < number_of_cards; ++j) {
+                Card other_card = legal_cards[j].get_card();
+                if (!special_cards.contains_card(other_card) && game_type->are_equivalent(card, other_card, known_cards)) {
+                    equivalent_card_found = true;
+                    break;
+                }
+            }
         }
-        if (value_to_check == 11 || value_to_check == 4 || value_to_check == 3)
-            --value_to_check;
-        else if (value_to_check == 10)
-            value_to_check = 4;
-        else if (value_to_check == 2)
-            value_to_check = 0;
-        else
-            assert(false);
+        if (!equivalent_card_found)
+            legal_cards[number_of_cards++] = legal_cards[i];
     }
+    legal_cards.resize(number_of_cards);
 }
 
-int BeliefGameState::get_best_move_index(const vector<Move> &legal_moves) const {
-    assert(legal_moves[0].is_card_move());
-    /*cout << "calling get best move index, player to move: " << player_to_move << endl;
-    for (int i = 0; i < 4; ++i) {
-        cout << "player " << i << "'s team: " << players_team[i] << endl;
+// returns the highest ranked card of legal_cards, iterating over the cards in the same order as Trick::get_legal_cards_for_player lists them and comparing them like the original implementation get_best_move_index_reference (see reference.h) does (a trump card always beats a non trump card, otherwise the ranks are compared even across different suits)
+static Card get_highest_card(const GameType *game_type, Cards legal_cards) {
+    Card highest_card = legal_cards.get_first_card();
+    legal_cards.remove_card(highest_card);
+    unsigned int highest_card_rank = game_type->get_rank(highest_card);
+    while (!legal_cards.empty()) {
+        Card legal_card = legal_cards.get_first_card();
+        legal_cards.remove_card(legal_card);
+        if (game_type->get_rank(legal_card) < highest_card_rank ||
+            (game_type->is_trump(legal_card) && !game_type->is_trump(highest_card))) {
+            highest_card_rank = game_type->get_rank(legal_card);
+            highest_card = legal_card;
+        }
     }
-    cout << "legal cards to play: " << endl;
+    return highest_card;
+}
+
+int BeliefGameState::play_valuable_card(const vector<Move> &legal_moves, Cards possible_cards) const {
+    // the first of the possible cards with the highest value, i.e. the same card as chosen by play_valuable_card_reference (see reference.h)
+    int chosen_index = -1;
+    int highest_value = -1;
     for (size_t i = 0; i < legal_moves.size(); ++i) {
-        assert(legal_moves[i].is_card_move());
-        //cout << legal_moves[i].get_card();
+        Card card = legal_moves[i].get_card();
+        if (possible_cards.contains_card(card) && card.get_value() > highest_value) {
+            highest_value = card.get_value();
+            chosen_index = i;
+        }
     }
-    cout << endl;
-    cout << "other players cards: " << endl;
-    int playerit = next_player(player_to_move);
-    for (int i = 0; i < 3; ++i) {
-        cout << "player " << playerit << " " << cards[playerit] << endl;
-        playerit = next_player(playerit);
-    }*/
-
-    int trick_size = tricks.back().get_size();
-    if (!tricks.back().empty()) {
-        assert(trick_size < 4);
-        int trick_taken_by = tricks.back().taken_by();
-        //cout << "trick taken by so far: " << trick_taken_by << endl;
+    assert(chosen_index != -1);
+    return chosen_index;
+}
+
+int BeliefGameState::get_best_move_index(const vector<Move> &legal_moves) const {
+    assert(legal_moves[0].is_card_move());
+    // the trick is simulated on copies of the current trick, which are plain values on the stack. all sets of cards are represented as Cards.
+    const Trick &trick = get_current_trick();
+    int number_of_following_players = 4 - trick.get_size() - 1;
+    if (!trick.empty()) {
+        int trick_taken_by = trick.taken_by();
         if (players_team[trick_taken_by] == players_team[player_to_move]) {
             // trick is owned by a teammate so far, check if a player of the other team can play a higher card
-            Trick current_trick(tricks.back());
-            current_trick.set_card(player_to_move, no_card);
+            Trick current_trick(trick);
             int player_it = next_player(player_to_move);
-            for (int i = 0; i < 4 - trick_size - 1; ++i) {
-                if (players_team[player_it] == players_team[player_to_move]) {
-                    // play dummy card if player is in the same team
-                    current_trick.set_card(player_it, no_card);
-                } else {
-                    vector<Move> legal_cards;
-                    current_trick.get_legal_cards_for_player(player_it, legal_cards, cards[player_it]);
-                    // search for the highest ranked card the player can play
-                    unsigned int highest_card_rank = game_type->get_rank(legal_cards[0].get_card());
-                    size_t highest_card_rank_index = 0;
-                    for (size_t k = 1; k < legal_cards.size(); ++k) {
-                        Card legal_card = legal_cards[k].get_card();
-                        if (game_type->get_rank(legal_card) < highest_card_rank ||
-                            (game_type->is_trump(legal_card) && !game_type->is_trump(legal_cards[highest_card_rank_index].get_card()))) {
-                            // the second check allows a lower rank of a trump card to be of global higher rank if the highest ranked card so far is a non trump) {
-                            highest_card_rank = game_type->get_rank(legal_card);
-                            highest_card_rank_index = k;
-                        }
-                    }
-                    current_trick.set_card(player_it, legal_cards[highest_card_rank_index].get_card());
-                }
+            for (int i = 0; i < number_of_following_players; ++i) {
+                if (players_team[player_it] != players_team[player_to_move])
+                    current_trick.set_card(player_it, get_highest_card(game_type, current_trick.get_legal_cards(cards[player_it])));
                 player_it = next_player(player_it);
             }
-            int trick_now_taken_by = current_trick.taken_by();
-            if (trick_taken_by == trick_now_taken_by) {
-                // trick is safe, player is free to play any valuable card
-                vector<Card> possible_cards;
-                for (size_t i = 0; i < legal_moves.size(); ++i) {
-                    possible_cards.push_back(legal_moves[i].get_card());
-                }
-                int chosen_index = play_valuable_card(possible_cards);
-                //cout << "returning index of a valuable card for a safe trick: " << chosen_index << endl;
-                return chosen_index;
-            }
-            //cout << "but not safe" << endl;
+            if (current_trick.taken_by() == trick_taken_by) // trick is safe, player is free to play any valuable card
+                return play_valuable_card(legal_moves, cards[player_to_move]);
         }
     }
 
-    // ending up here means that either the current trick is empty (i.e. player to move starts a new trick) or the trick contains one or more cards already, but it is not owned by a teammate of player to move so far or it is not safe because another player can still play a higher card.
-    vector<int> safe_card_indices; // set of indices of safe cards that win the trick
-    set<Cards> safe_suits; // set of safe suits to play because a teammate can win the trick
+    int first_safe_card_index = -1; // the first card that wins the trick
+    int first_safe_non_trump_card_index = -1;
+    Cards safe_suits[5]; // the suits which are safe to play because a teammate wins the trick (at most the trump suit and four non trump suits in a jacks or queens solo)
+    int number_of_safe_suits = 0;
+    // the highest cards of the following players only depend on the suit of the trick, thus they are only recomputed if the suit differs from the one of the previous legal card (which can only happen if player to move starts the trick)
+    Cards highest_cards_suit;
+    Card highest_cards[3];
     for (size_t i = 0; i < legal_moves.size(); ++i) {
         Card current_card = legal_moves[i].get_card();
-        Trick current_trick1(tricks.back());
-        current_trick1.set_card(player_to_move, current_card); // every player plays his highest card into this trick
-        Trick current_trick2(tricks.back());
-        current_trick2.set_card(player_to_move, current_card); // only opponent players play their highest card into this trick, i.e. in the end, if the trick is owned by player to move, the card is a safe card.
-        // iterate over the next players, let them play their highest ranked legal card. if player_to_move wins the trick, the card played is a safe card; if a teammate wins the trick, the played card's suit is safe and otherwise, no good card can be played.
+        Trick current_trick1(trick); // every player plays his highest card into this trick
+        current_trick1.set_card(player_to_move, current_card);
+        Trick current_trick2(current_trick1); // only opponent players play their highest card into this trick
+        Cards trick_suit = current_trick1.get_trick_suit();
+        bool compute_highest_cards = i == 0 || !(trick_suit == highest_cards_suit);
+        highest_cards_suit = trick_suit;
         int player_it = next_player(player_to_move);
-        for (int j = 0; j < 4 - trick_size - 1; ++j) {
-            vector<Move> legal_cards;
-            current_trick1.get_legal_cards_for_player(player_it, legal_cards, cards[player_it]);
-            // search for the highest ranked card the player can play
-            unsigned int highest_card_rank = game_type->get_rank(legal_cards[0].get_card());
-            size_t highest_card_rank_index = 0;
-            for (size_t k = 1; k < legal_cards.size(); ++k) {
-                Card legal_card = legal_cards[k].get_card();
-                if (game_type->get_rank(legal_card) < highest_card_rank ||
-                    (game_type->is_trump(legal_card) && !game_type->is_trump(legal_cards[highest_card_rank_index].get_card()))) {
-                    // the second check allows a lower rank of a trump card to be of global higher rank if the highest ranked card so far is a non trump
-                    highest_card_rank = game_type->get_rank(legal_card);
-                    highest_card_rank_index = k;
-                }
+        for (int j = 0; j < number_of_following_players; ++j) {
+            if (compute_highest_cards)
+                highest_cards[j] = get_highest_card(game_type, current_trick1.get_legal_cards(cards[player_it]));
+            if (players_team[player_it] != players_team[player_to_move])
+                current_trick2.set_card(player_it, highest_cards[j]);
+            current_trick1.set_card(player_it, highest_cards[j]);
+            player_it = next_player(player_it);
+        }
+        if (current_trick2.taken_by() == player_to_move) {
+            if (first_safe_card_index == -1)
+                first_safe_card_index = i;
+            if (first_safe_non_trump_card_index == -1 && !game_type->is_trump(current_card))
+                first_safe_non_trump_card_index = i;
+        } else if (players_team[current_trick1.taken_by()] == players_team[player_to_move]) {
+            Cards suit = game_type->get_suit(current_card);
+            int k = 0;
+            while (k < number_of_safe_suits && !(safe_suits[k] == suit))
+                ++k;
+            if (k == number_of_safe_suits)
+                safe_suits[number_of_safe_suits++] = suit;
+        }
+    }
+
+    // the same order of preferences as in get_best_move_index_reference: a safe non trump card, a valuable card of a safe non trump suit (the one which get_best_move_index_reference encounters first in its set of suits), a safe trump card and a valuable card of the trump suit if it is safe
+    if (first_safe_non_trump_card_index != -1)
+        return first_safe_non_trump_card_index;
+    int first_safe_non_trump_suit = -1;
+    bool trump_suit_is_safe = false;
+    for (int k = 0; k < number_of_safe_suits; ++k) {
+        if (safe_suits[k] == game_type->get_trump_suit())
+            trump_suit_is_safe = true;
+        else if (first_safe_non_trump_suit == -1 || safe_suits[k] < safe_suits[first_safe_non_trump_suit])
+            first_safe_non_trump_suit = k;
+    }
+    if (first_safe_non_trump_suit != -1)
+        return play_valuable_card(legal_moves, safe_suits[first_safe_non_trump_suit]);
+    if (first_safe_card_index != -1) {
+        assert(game_type->is_trump(legal_moves[first_safe_card_index].get_card()));
+        return first_safe_card_index;
+    }
+    if (trump_suit_is_safe)
+        return play_valuable_card(legal_moves, game_type->get_trump_suit());
+    return -1;
+}
+
+/*
+  Serialization: the serializers below are used by serialize_fields() to
+  either write or read every field. Writers take the values of the fields of
+  a const state, readers references to the fields of the state being read.
+  Readers record the first error (see fail()) and go on reading default
+  values, such that the caller decides what to do with malformed data.
+*/
+
+class BinaryWriter {
+private:
+    vector<unsigned char> &binary;
+public:
+    explicit BinaryWriter(vector<unsigned char> &binary_) : binary(binary_) {
+    }
+    void begin_field(const char *) {
+    }
+    void end_field() {
+    }
+    void fail(const string &) {
+        assert(false); // the fields of a state are always valid
+    }
+    template<class T>
+    void integer(T value) { // T is int, bool or an enum
+        int number = value;
+        assert(number >= -128 && number < 128); // all fields are small numbers
+        binary.push_back(static_cast<unsigned char>(number));
+    }
+    void card(Card card) {
+        binary.push_back(static_cast<unsigned char>(card.get_index())); // no_card has index -1
+    }
+    void cards(Cards cards) {
+        for (int i = 0; i < 48; i += 8) {
+            unsigned char byte = 0;
+            for (int j = 0; j < 8; ++j) {
+                if (cards.contains_card(Card(i + j)))
+                    byte |= 1 << j;
             }
-            if (players_team[player_it] != players_team[player_to_move]) {
-                current_trick2.set_card(player_it, legal_cards[highest_card_rank_index].get_card());
-            } else {
-                current_trick2.set_card(player_it, no_card);
+            binary.push_back(byte);
+        }
+    }
+    void game_type(const GameType *game_type) {
+        binary.push_back(static_cast<unsigned char>(game_type == 0 ? -1 : game_type->get_index()));
+    }
+};
+
+// booleans are only read from 0 and 1 such that a state read serializes to the data it was read from
+template<class T>
+static bool is_valid_integer(int number) {
+    return !is_same<T, bool>::value || number == 0 || number == 1;
+}
+
+class BinaryReader {
+private:
+    const vector<unsigned char> &binary;
+    size_t position;
+    string error;
+    unsigned char next_byte() {
+        if (position == binary.size()) {
+            fail("binary data too short");
+            return 0;
+        }
+        return binary[position++];
+    }
+public:
+    explicit BinaryReader(const vector<unsigned char> &binary_) : binary(binary_), position(0) {
+    }
+    void begin_field(const char *) {
+    }
+    void end_field() {
+    }
+    void fail(const string &reason) { // only the first error is kept
+        if (error.empty())
+            error = reason;
+    }
+    const string &get_error() const {
+        return error;
+    }
+    template<class T>
+    void integer(T &value) {
+        int number = static_cast<signed char>(next_byte());
+        if (!is_valid_integer<T>(number)) {
+            fail("invalid boolean");
+            number = 0;
+        }
+        value = static_cast<T>(number);
+    }
+    void card(Card &card) {
+        int index = static_cast<signed char>(next_byte());
+        if (index < -1 || index >= 48) {
+            fail("invalid card");
+            index = -1;
+        }
+        card = index == -1 ? no_card : Card(index);
+    }
+    void cards(Cards &cards) {
+        cards = Cards();
+        for (int i = 0; i < 48; i += 8) {
+            unsigned char byte = next_byte();
+            for (int j = 0; j < 8; ++j) {
+                if (byte & (1 << j))
+                    cards.add_card(Card(i + j));
             }
-            current_trick1.set_card(player_it, legal_cards[highest_card_rank_index].get_card());
-            player_it = next_player(player_it);
         }
-        int trick1_taken_by = current_trick1.taken_by();
-        int trick2_taken_by = current_trick2.taken_by();
-        if (trick2_taken_by == player_to_move) {
-            // player to move can play a safe card that wins the trick
-            safe_card_indices.push_back(i);
-        } else {
-            assert(trick1_taken_by != player_to_move); // if player to move did not win trick 2, he cannot have won trick 1 where more players have played their cards.
-            if (players_team[trick1_taken_by] == players_team[player_to_move]) {
-                // a teammate of player to move won the trick, i.e. the played card's suit is safe to play
-                safe_suits.insert(game_type->get_suit(current_card));
+    }
+    void game_type(const GameType *&game_type) {
+        int index = static_cast<signed char>(next_byte());
+        if (index < -1 || index >= GameType::NUMBER_OF_GAME_TYPES) {
+            fail("invalid game type");
+            index = -1;
+        }
+        game_type = index == -1 ? 0 : GameType::from_index(index);
+    }
+    void check_end() {
+        if (position != binary.size())
+            fail("binary data too long");
+    }
+};
+
+// cards are written by their names, followed by '_' for the second copy of a card (like the constants in cards.h)
+static void write_card_name(ostream &text, Card card) {
+    text << card.get_name();
+    if (card.get_index() % 2 == 1)
+        text << "_";
+}
+
+// game types are written by their names with underscores instead of spaces (like the constants in game_type.h)
+static string get_game_type_name(const GameType *game_type) {
+    if (game_type == 0)
+        return "none";
+    ostringstream stream;
+    stream << *game_type;
+    string name = stream.str();
+    replace(name.begin(), name.end(), ' ', '_');
+    return name;
+}
+
+// returns no_card if name is not the name of a card
+static Card read_card_name(const string &name) {
+    bool second_copy = !name.empty() && name[name.size() - 1] == '_';
+    string card_name = second_copy ? name.substr(0, name.size() - 1) : name;
+    if (!is_valid_card_name(card_name))
+        return no_card;
+    pair<Card, Card> cards = get_cards_for_name(card_name);
+    return second_copy ? cards.second : cards.first;
+}
+
+class TextWriter {
+private:
+    ostream &text;
+public:
+    explicit TextWriter(ostream &text_) : text(text_) {
+    }
+    void begin_field(const char *name) {
+        text << name;
+    }
+    void end_field() {
+        text << "\n";
+    }
+    void fail(const string &) {
+        assert(false); // the fields of a state are always valid
+    }
+    template<class T>
+    void integer(T value) {
+        text << " " << static_cast<int>(value);
+    }
+    void card(Card card) {
+        text << " ";
+        if (card == no_card)
+            text << "-";
+        else
+            write_card_name(text, card);
+    }
+    void cards(Cards cards) { // all cards separated by commas, ordered by index
+        text << " ";
+        if (cards.empty())
+            text << "-";
+        bool first = true;
+        for (int i = 0; i < 48; ++i) {
+            if (cards.contains_card(Card(i))) {
+                if (!first)
+                    text << ",";
+                write_card_name(text, Card(i));
+                first = false;
             }
         }
     }
+    void game_type(const GameType *game_type) {
+        text << " " << get_game_type_name(game_type);
+    }
+};
 
-    // iterate over all safe cards
-    for (size_t i = 0; i < safe_card_indices.size(); ++i) {
-        Card current_card = legal_moves[safe_card_indices[i]].get_card();
-        if (game_type->is_trump(current_card)) // prefer to play a safe non trump card over playing a safe trump card
-            continue;
-        int chosen_index = safe_card_indices[i];
-        //cout << "returning index of a safe non trump card:  " << chosen_index << endl;
-        return chosen_index;
+static const char *LAST_FIELD_NAME = "player_to_play_card"; // the last field written by serialize_fields()
+
+/*
+  Reads one field per line. After an error, no further lines are read by the
+  fields, but skip_to_end() consumes the lines up to the last field of the
+  state, such that the next state of the stream can be read.
+*/
+class TextReader {
+private:
+    istream &text;
+    string field_name;
+    istringstream line;
+    string error;
+    bool last_field_read;
+    string next_token() {
+        string token;
+        if (!(line >> token))
+            fail("missing value for " + field_name);
+        return token;
     }
-    // if we are here, then because all safe cards are only trump cards or because there are no safe cards at all. we even prefer playing a safe suit where a teammate can win the trick over playing a safe trump card because playing a high trump card is many times a waste.
-    for (set<Cards>::const_iterator it = safe_suits.begin(); it != safe_suits.end(); ++it) {
-        if (*it == game_type->get_trump_suit()) // prefer playing a safe non trump suit over playing trump
-            continue;
-        vector<Card> possible_cards;
-        vector<size_t> index_to_index(legal_moves.size());
-        for (size_t i = 0; i < legal_moves.size(); ++i) {
-            Card current_card = legal_moves[i].get_card();
-            if (it->contains_card(current_card)) {
-                possible_cards.push_back(current_card);
-                index_to_index[possible_cards.size() - 1] = i;
+public:
+    explicit TextReader(istream &text_) : text(text_), last_field_read(false) {
+    }
+    void begin_field(const char *name) {
+        field_name = name;
+        line.clear();
+        line.str("");
+        if (!error.empty())
+            return;
+        string line_string;
+        if (!getline(text, line_string)) {
+            fail("missing field " + field_name);
+            return;
+        }
+        line.str(line_string);
+        string token;
+        line >> token;
+        if (token == LAST_FIELD_NAME)
+            last_field_read = true;
+        if (token != field_name)
+            fail("expected field " + field_name + " instead of " + line_string);
+    }
+    void end_field() {
+        string token;
+        if (line >> token)
+            fail("too many values for " + field_name);
+    }
+    void fail(const string &reason) { // only the first error is kept
+        if (error.empty())
+            error = reason;
+    }
+    const string &get_error() const {
+        return error;
+    }
+    void skip_to_end() {
+        string line_string;
+        while (!last_field_read && getline(text, line_string)) {
+            istringstream stream(line_string);
+            string token;
+            stream >> token;
+            last_field_read = token == LAST_FIELD_NAME;
+        }
+    }
+    template<class T>
+    void integer(T &value) {
+        string token = next_token();
+        istringstream stream(token);
+        int number;
+        if (!(stream >> number) || !stream.eof() || !is_valid_integer<T>(number)) {
+            if (!token.empty())
+                fail("invalid number " + token + " for " + field_name);
+            number = 0;
+        }
+        value = static_cast<T>(number);
+    }
+    void card(Card &card) {
+        string token = next_token();
+        card = token == "-" || token.empty() ? no_card : read_card_name(token);
+        if (card == no_card && token != "-" && !token.empty())
+            fail("invalid card " + token);
+    }
+    void cards(Cards &cards) {
+        string token = next_token();
+        cards = Cards();
+        if (token == "-" || token.empty())
+            return;
+        istringstream stream(token);
+        string name;
+        while (getline(stream, name, ',')) {
+            Card card = read_card_name(name);
+            if (card == no_card)
+                fail("invalid card " + name);
+            else
+                cards.add_card(card);
+        }
+    }
+    void game_type(const GameType *&game_type) {
+        string token = next_token();
+        game_type = 0;
+        if (token == "none" || token.empty())
+            return;
+        for (int i = 0; i < GameType::NUMBER_OF_GAME_TYPES; ++i) {
+            if (get_game_type_name(GameType::from_index(i)) == token) {
+                game_type = GameType::from_index(i);
+                return;
             }
         }
-        int chosen_index = play_valuable_card(possible_cards);
-        chosen_index = index_to_index[chosen_index];
-        //cout << "returning index of a valuable card for safe non trump suit: " << chosen_index << endl;
-        return chosen_index;
-    }
-    // if we are here, then because all safe cards are only trump cards or because there are no safe cards at all and because the only safe suit to play is the trump suit or because there is no safe suit at all. prefer playing a safe trump card if exists over playing a low trump card.
-    if (!safe_card_indices.empty()) {
-        int chosen_index = safe_card_indices.front(); // legal moves are ordered in ascending rank order and thus the first element in safe_card_indices is the lowest safe trump card
-        // TODO: better play valuable safe low trump card
-        assert(game_type->is_trump(legal_moves[chosen_index].get_card()));
-        //cout << "returning index of a safe trump card: " << chosen_index << endl;
-        return chosen_index;
-    }
-    // if we are here, then because there is no safe card at all and no safe non trump suit.
-    if (!safe_suits.empty()) {
-        assert(safe_suits.size() == 1); // only the trump suit can be a safe suit
-        assert(*safe_suits.begin() == game_type->get_trump_suit());
-        vector<Card> possible_cards;
-        vector<size_t> index_to_index(legal_moves.size());
-        for (size_t i = 0; i < legal_moves.size(); ++i) {
-            Card current_card = legal_moves[i].get_card();
-            if (safe_suits.begin()->contains_card(current_card)) {
-                possible_cards.push_back(current_card);
-                index_to_index[possible_cards.size() - 1] = i;
+        fail("invalid game type " + token);
+    }
+};
+
+static const int SERIALIZATION_FORMAT_VERSION = 1;
+
+// the format version and the options which influence the course of a game, followed by the player number. returns the player number (read or written)
+template<class Serializer>
+static int serialize_header(Serializer &serializer, const Options &options, int player_number) {
+    const char *names[4] = { "format_version", "no_solo", "compulsory_solo", "announcing_version" };
+    int values[4] = { SERIALIZATION_FORMAT_VERSION, options.solo_disabled(), options.use_compulsory_solo(),
+                      options.get_announcing_version() };
+    for (int i = 0; i < 4; ++i) {
+        int value = values[i];
+        serializer.begin_field(names[i]);
+        serializer.integer(value);
+        serializer.end_field();
+        if (value != values[i])
+            serializer.fail(string(names[i]) + " does not match");
+    }
+    serializer.begin_field("player_number");
+    serializer.integer(player_number);
+    serializer.end_field();
+    if (player_number < 0 || player_number >= 4) {
+        serializer.fail("invalid player number");
+        player_number = 0;
+    }
+    return player_number;
+}
+
+template<class Serializer, class T>
+static void serialize_integers(Serializer &serializer, const char *name, T *values, int size = 1) { // T is (const) int, bool or an enum
+    serializer.begin_field(name);
+    for (int i = 0; i < size; ++i)
+        serializer.integer(values[i]);
+    serializer.end_field();
+}
+
+template<class Serializer, class T>
+static void serialize_cards(Serializer &serializer, const char *name, T *values, int size = 1) { // T is (const) Cards
+    serializer.begin_field(name);
+    for (int i = 0; i < size; ++i)
+        serializer.cards(values[i]);
+    serializer.end_field();
+}
+
+// a trick is written as its first player followed by the cards of the four players
+template<class Serializer>
+static void serialize_trick(Serializer &serializer, const Trick &trick, const GameType *) {
+    serializer.begin_field("trick");
+    serializer.integer(trick.get_first_player());
+    for (int j = 0; j < 4; ++j)
+        serializer.card(trick.get_card(j));
+    serializer.end_field();
+}
+
+template<class Serializer>
+static void serialize_trick(Serializer &serializer, Trick &trick, const GameType *game_type) {
+    int trick_first_player = 0;
+    Card trick_cards[4];
+    serializer.begin_field("trick");
+    serializer.integer(trick_first_player);
+    for (int j = 0; j < 4; ++j)
+        serializer.card(trick_cards[j]);
+    serializer.end_field();
+    if (trick_first_player < 0 || trick_first_player >= 4) {
+        serializer.fail("invalid first player of a trick");
+        trick_first_player = 0;
+    }
+    trick = Trick(game_type, trick_first_player);
+    for (int j = 0; j < 4; ++j)
+        trick.set_card(j, trick_cards[j]);
+}
+
+// the next move type is written as the id of the move, or -1 for the card move with no_card (which has no id)
+template<class Serializer>
+static void serialize_next_move_type(Serializer &serializer, const Move &next_move_type) {
+    int next_move_id = next_move_type.is_card_move() && next_move_type.get_card() == no_card ? -1 : next_move_type.get_id();
+    serialize_integers(serializer, "next_move_type", &next_move_id);
+}
+
+template<class Serializer>
+static void serialize_next_move_type(Serializer &serializer, Move &next_move_type) {
+    int next_move_id = 0;
+    serialize_integers(serializer, "next_move_type", &next_move_id);
+    if (next_move_id < -1 || next_move_id >= NUM_MOVE_IDS) {
+        serializer.fail("invalid next move type");
+        next_move_id = -1;
+    }
+    next_move_type = next_move_id == -1 ? Move(no_card) : Move::from_id(next_move_id);
+}
+
+// writing a const state or reading into a state, thus the overloads of serialize_trick and serialize_next_move_type for const and non-const fields are chosen by the type of state
+template<class Serializer, class State>
+void BeliefGameState::serialize_fields(Serializer &serializer, State &state) {
+    // fields of GameState
+    serialize_cards(serializer, "cards", state.cards, 4);
+    serializer.begin_field("game_type");
+    serializer.game_type(state.game_type);
+    serializer.end_field();
+    serialize_integers(serializer, "players_team", state.players_team, 4);
+    serialize_integers(serializer, "number_of_tricks", &state.number_of_tricks);
+    bool valid_number_of_tricks = state.number_of_tricks >= 0 && state.number_of_tricks <= 12 && (state.number_of_tricks == 0 || state.game_type != 0);
+    if (!valid_number_of_tricks)
+        serializer.fail("invalid number of tricks");
+    for (int i = 0; valid_number_of_tricks && i < state.number_of_tricks; ++i)
+        serialize_trick(serializer, state.tricks[i], state.game_type);
+    serialize_integers(serializer, "session_instance", &state.session_instance);
+    serialize_integers(serializer, "player_played_queen_of_clubs", &state.player_played_queen_of_clubs);
+    serialize_integers(serializer, "players_latest_moment_for_announcement", state.players_latest_moment_for_announcement, 4);
+    serialize_integers(serializer, "announcements", state.announcements, 2);
+    serialize_integers(serializer, "first_announcement_in_time", state.first_announcement_in_time, 2);
+    serialize_integers(serializer, "card_number_for_latest_possible_reply", state.card_number_for_latest_possible_reply, 2);
+    serialize_integers(serializer, "players_known_team", state.players_known_team, 4);
+    serialize_integers(serializer, "teams_are_known", &state.teams_are_known);
+    serialize_integers(serializer, "solo_or_marriage_player", &state.solo_or_marriage_player);
+    serialize_integers(serializer, "compulsory_solo", &state.compulsory_solo);
+    serialize_integers(serializer, "number_of_clarification_trick", &state.number_of_clarification_trick);
+
+    // fields of BeliefGameState
+    serialize_integers(serializer, "played_compulsory_solo", state.played_compulsory_solo, 4);
+    serialize_integers(serializer, "first_player", &state.first_player);
+    serialize_integers(serializer, "player_to_move", &state.player_to_move);
+    serialize_next_move_type(serializer, state.next_move_type);
+    serialize_cards(serializer, "played_cards", &state.played_cards);
+    serialize_integers(serializer, "players_cards_count", state.players_cards_count, 4);
+    serialize_cards(serializer, "cards_that_players_cannot_have", state.cards_that_players_cannot_have, 4);
+    serialize_integers(serializer, "players_must_have_queen_of_clubs", state.players_must_have_queen_of_clubs, 4);
+    serialize_integers(serializer, "uct_output", &state.uct_output);
+    serialize_integers(serializer, "is_marriage", &state.is_marriage);
+    serialize_integers(serializer, "initialized", &state.initialized);
+    serialize_integers(serializer, "players_left_to_ask_a_question", &state.players_left_to_ask_a_question);
+    serialize_integers(serializer, "has_reservation", state.has_reservation, 4);
+    serialize_integers(serializer, "reservation_count", &state.reservation_count);
+    serialize_integers(serializer, "player_after_last_player_allowed_to_shorten", &state.player_after_last_player_allowed_to_shorten);
+    serialize_integers(serializer, "player_to_ask_after_next_immediate_solo_move", &state.player_to_ask_after_next_immediate_solo_move);
+    serialize_integers(serializer, "no_player_with_reservation_and_open_compulsory_solo",
+                       &state.no_player_with_reservation_and_open_compulsory_solo);
+    serialize_integers(serializer, "players_left_to_ask_about_is_solo_move", &state.players_left_to_ask_about_is_solo_move);
+    serialize_integers(serializer, "first_positioned_player_for_a_lust_solo", &state.first_positioned_player_for_a_lust_solo);
+    serialize_integers(serializer, "players_left_to_ask_about_announcement", &state.players_left_to_ask_about_announcement);
+    serialize_integers(serializer, "player_to_play_card", &state.player_to_play_card);
+}
+
+static int read_binary_header(const Options &options, const vector<unsigned char> &binary, string &error) {
+    BinaryReader reader(binary);
+    int player_number = serialize_header(reader, options, -1);
+    error = reader.get_error();
+    return player_number;
+}
+
+BeliefGameState::BeliefGameState(const Options &options, const vector<unsigned char> &binary, string &error)
+    : GameState(options, false), player_number(read_binary_header(options, binary, error)) {
+    if (!error.empty())
+        return;
+    BinaryReader reader(binary);
+    serialize_header(reader, options, player_number);
+    serialize_fields(reader, *this);
+    reader.check_end();
+    error = reader.get_error();
+    if (error.empty())
+        error = get_inconsistency();
+}
+
+static int read_text_header(const Options &options, istream &text, string &error) {
+    TextReader reader(text);
+    int player_number = serialize_header(reader, options, -1);
+    error = reader.get_error();
+    if (!error.empty())
+        reader.skip_to_end();
+    return player_number;
+}
+
+BeliefGameState::BeliefGameState(const Options &options, istream &text, string &error)
+    : GameState(options, false), player_number(read_text_header(options, text, error)) {
+    if (!error.empty())
+        return;
+    TextReader reader(text); // continues after the header
+    serialize_fields(reader, *this);
+    error = reader.get_error();
+    if (!error.empty())
+        reader.skip_to_end();
+    else
+        error = get_inconsistency();
+}
+
+void BeliefGameState::write_binary(vector<unsigned char> &binary) const {
+    binary.clear();
+    BinaryWriter writer(binary);
+    serialize_header(writer, options, player_number);
+    serialize_fields(writer, *this);
+}
+
+void BeliefGameState::write_text(ostream &text) const {
+    TextWriter writer(text);
+    serialize_header(writer, options, player_number);
+    serialize_fields(writer, *this);
+}
+
+/*
+  Validation of states read: set_move() and the methods used by Uct assert
+  the invariants of the states which set_move() reaches, thus a state read
+  is only accepted if it satisfies them. Before the game type is known, the
+  reachable states are few and compared as a whole; afterwards, the fields
+  are checked against the tricks, the cards and each other.
+*/
+
+static bool is_in_range(int value, int min, int max) {
+    return value >= min && value <= max;
+}
+
+string BeliefGameState::get_inconsistency() const {
+    // ranges of the fields (booleans and enums other than announcements are checked when reading)
+    if (session_instance)
+        return "session_instance must be false";
+    if (!is_in_range(first_player, 0, 3) || !is_in_range(player_to_move, 0, 3) || !is_in_range(player_played_queen_of_clubs, -1, 3)
+        || !is_in_range(solo_or_marriage_player, -1, 3) || !is_in_range(player_after_last_player_allowed_to_shorten, -1, 3)
+        || !is_in_range(player_to_ask_after_next_immediate_solo_move, -1, 3)
+        || !is_in_range(first_positioned_player_for_a_lust_solo, -1, 3) || !is_in_range(player_to_play_card, -1, 3))
+        return "invalid player";
+    if (!is_in_range(players_left_to_ask_a_question, 0, 4) || !is_in_range(players_left_to_ask_about_is_solo_move, 0, 4)
+        || !is_in_range(players_left_to_ask_about_announcement, 0, 3))
+        return "invalid number of players left to ask";
+    int number_of_reservations = 0;
+    for (int i = 0; i < 4; ++i) {
+        if (!is_in_range(players_team[i], -1, 1) || !is_in_range(players_known_team[i], -1, 1))
+            return "invalid team";
+        if (players_known_team[i] != -1 && players_team[i] != players_known_team[i])
+            return "known team differs from team";
+        number_of_reservations += has_reservation[i];
+    }
+    if (reservation_count != number_of_reservations)
+        return "invalid number of reservations";
+    for (int i = 0; i < 2; ++i) {
+        if (!is_in_range(announcements[i], NONE, SCHWARZ))
+            return "invalid announcement";
+    }
+
+    // tricks: the players play in turn, the winner of a trick leads the next one and a player who does not follow suit has no card of that suit
+    Cards players_played_cards[4];
+    Cards cards_in_tricks;
+    for (int k = 0; k < number_of_tricks; ++k) {
+        const Trick &trick = tricks[k];
+        int size = trick.get_size();
+        int trick_first_player = k == 0 ? (compulsory_solo ? solo_or_marriage_player : first_player) : tricks[k - 1].taken_by();
+        if (trick.get_first_player() != trick_first_player)
+            return "wrong first player of a trick";
+        if (size != 4 && k != number_of_tricks - 1)
+            return "incomplete trick followed by another trick";
+        if (size == 4 && k == number_of_tricks - 1 && number_of_tricks != 12)
+            return "completed trick not followed by another trick";
+        for (int j = 0; j < 4; ++j) {
+            int player = (trick_first_player + j) % 4;
+            Card card = trick.get_card(player);
+            if ((card != no_card) != (j < size))
+                return "cards of a trick not played in turn";
+            if (card == no_card)
+                continue;
+            if (cards_in_tricks.contains_card(card))
+                return "card played twice";
+            cards_in_tricks.add_card(card);
+            players_played_cards[player].add_card(card);
+            Cards trick_suit = trick.get_trick_suit();
+            if (!trick_suit.contains_card(card) && !cards_that_players_cannot_have[player].contains_cards(trick_suit))
+                return "player not following suit can have cards of the suit";
+        }
+    }
+    if (!(played_cards == cards_in_tricks))
+        return "played cards differ from the cards of the tricks";
+
+    // hands: disjoint, with one card for every card a player did not play. only the owner's hand is known or, in rollouts of Uct, all hands
+    Cards dealt_cards = played_cards;
+    bool complete_information = true;
+    for (int i = 0; i < 4; ++i) {
+        if (players_cards_count[i] != 12 - players_played_cards[i].size())
+            return "number of cards differs from the cards played";
+        if (!dealt_cards.get_intersection(cards[i]).empty())
+            return "card dealt twice";
+        dealt_cards.add_cards(cards[i]);
+        if (cards[i].size() != players_cards_count[i]) {
+            if (i == player_number || !cards[i].empty())
+                return "number of cards differs from the cards held";
+            complete_information = false;
+        }
+        if (!cards[i].get_intersection(cards_that_players_cannot_have[i]).empty())
+            return "player holds a card he cannot have";
+    }
+
+    if (game_type == 0)
+        return is_reachable_before_game_type(complete_information) ? "" : "unreachable state before the game type is known";
+
+    // the next move is an announcement or a card, see set_move()
+    if (next_move_type.is_card_move() ? next_move_type.get_card() != no_card : next_move_type.get_id() != Move(NONE, false).get_id())
+        return "invalid next move type";
+    if (options.solo_disabled() && *game_type != regular && *game_type != marriage)
+        return "solo although solos are disabled";
+    // the cards a player cannot have are whole suits (except for the queens of clubs of another player)
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 48; ++j) {
+            Card card(j);
+            if (card != CQ && card != CQ_ && cards_that_players_cannot_have[i].contains_card(card)
+                && !cards_that_players_cannot_have[i].contains_cards(game_type->get_suit(card)))
+                return "player cannot have a part of a suit";
+        }
+    }
+    if (!initialized) {
+        if (number_of_tricks != 1 || !played_cards.empty() || player_to_play_card != -1 || players_left_to_ask_about_announcement != 0
+            || player_to_move != tricks[0].get_first_player())
+            return "invalid state before the first card or announcement";
+    } else if (player_to_play_card != (get_current_trick().get_first_player() + get_current_trick().get_size()) % 4) {
+        return "invalid player to play a card";
+    }
+    if (next_move_type.is_card_move()) {
+        if (players_left_to_ask_about_announcement != 0 || (initialized && player_to_move != player_to_play_card))
+            return "invalid player to play a card";
+    } else if (!announcement_possible(player_to_move, players_cards_count[player_to_move])) {
+        return "player to move cannot announce";
+    }
+
+    // teams, see set_game_type_move() and GameState::update()
+    int known_re_players = 0;
+    int known_kontra_players = 0;
+    for (int i = 0; i < 4; ++i) {
+        if (players_known_team[i] == 1)
+            ++known_re_players;
+        else if (players_known_team[i] == 0)
+            ++known_kontra_players;
+    }
+    if (*game_type == regular) {
+        if (solo_or_marriage_player != -1 || compulsory_solo || number_of_clarification_trick != -1 || is_marriage)
+            return "invalid fields for a regular game";
+        if (teams_are_known ? known_re_players + known_kontra_players != 4 || (known_re_players != 2 && known_kontra_players != 3)
+            : known_re_players >= 2 || known_kontra_players >= 3)
+            return "invalid known teams";
+        // the player who played the last queen of clubs while the teams were not known
+        int last_player_played_queen_of_clubs = -1;
+        for (int k = 0; k < number_of_tricks; ++k) {
+            for (int j = 0; j < 4; ++j) {
+                int player = (tricks[k].get_first_player() + j) % 4;
+                if (tricks[k].get_card(player) == CQ || tricks[k].get_card(player) == CQ_)
+                    last_player_played_queen_of_clubs = player;
+            }
+        }
+        if (teams_are_known ? player_played_queen_of_clubs != -1 && !players_played_cards[player_played_queen_of_clubs].contains_card(CQ)
+            && !players_played_cards[player_played_queen_of_clubs].contains_card(CQ_)
+            : player_played_queen_of_clubs != last_player_played_queen_of_clubs)
+            return "invalid player who played a queen of clubs";
+        for (int i = 0; i < 4; ++i) {
+            bool has_queen_of_clubs = cards[i].contains_card(CQ) || cards[i].contains_card(CQ_)
+                || players_played_cards[i].contains_card(CQ) || players_played_cards[i].contains_card(CQ_);
+            // a team not known to all players is only set if the player's cards are known (in rollouts of Uct, see set_other_players_cards)
+            if (players_known_team[i] == -1 && players_team[i] != -1
+                && ((i != player_number && !complete_information) || players_team[i] != has_queen_of_clubs))
+                return "invalid team";
+            if (players_must_have_queen_of_clubs[i]
+                && (i == player_number || players_known_team[i] != 1 || played_cards.contains_card(CQ) || played_cards.contains_card(CQ_)
+                    || cards[player_number].contains_card(CQ) || cards[player_number].contains_card(CQ_)))
+                return "player cannot be known to have a queen of clubs";
+        }
+    } else {
+        if (!is_in_range(solo_or_marriage_player, 0, 3) || teams_are_known != (*game_type != marriage || number_of_clarification_trick != -1))
+            return "invalid fields for a solo or marriage";
+        int re_player = -1; // the player playing with the solo or marriage player
+        if (*game_type == marriage) {
+            if (compulsory_solo)
+                return "invalid fields for a marriage";
+            // the marriage is clarified by the first trick not won by the marriage player or after the third trick
+            int clarification_trick = -1;
+            for (int k = 0; k < number_of_tricks && k < 3 && clarification_trick == -1; ++k) {
+                if (tricks[k].completed() && (k == 2 || tricks[k].taken_by() != solo_or_marriage_player))
+                    clarification_trick = k;
             }
+            if (number_of_clarification_trick != clarification_trick)
+                return "invalid clarification trick";
+            if (clarification_trick != -1 && tricks[clarification_trick].taken_by() != solo_or_marriage_player)
+                re_player = tricks[clarification_trick].taken_by();
+        } else if (is_marriage || number_of_clarification_trick != -1 || compulsory_solo == played_compulsory_solo[solo_or_marriage_player]) {
+            return "invalid fields for a solo";
+        }
+        for (int i = 0; i < 4; ++i) {
+            if (players_known_team[i] != (i == solo_or_marriage_player || i == re_player))
+                return "invalid team";
+            if (players_must_have_queen_of_clubs[i])
+                return "player cannot be known to have a queen of clubs";
         }
-        int chosen_index = play_valuable_card(possible_cards);
-        chosen_index = index_to_index[chosen_index];
-        //cout << "returning index of a valuable card for safe trump suit: " << chosen_index << endl;
-        return chosen_index;
     }
-    // if we are here, then because there is neither a safe card nor a safe suit to play.
-    return -1;
+    if (player_played_queen_of_clubs != -1 && *game_type != regular)
+        return "invalid player who played a queen of clubs";
+
+    // announcements, see GameState::set_announcement() and GameState::check_teams_are_known()
+    if (*game_type == marriage && number_of_clarification_trick == -1) {
+        for (int i = 0; i < 4; ++i) {
+            if (players_latest_moment_for_announcement[i] != 11)
+                return "invalid latest moment for announcements";
+        }
+        for (int i = 0; i < 2; ++i) {
+            if (announcements[i] != NONE || first_announcement_in_time[i] || card_number_for_latest_possible_reply[i] != -1)
+                return "announcement before the clarification trick";
+        }
+    } else {
+        for (int i = 0; i < 4; ++i) {
+            int latest_moment = players_latest_moment_for_announcement[i];
+            if (latest_moment != 13 && (latest_moment < corrected_number_of_cards(6) || latest_moment > corrected_number_of_cards(11)))
+                return "invalid latest moment for announcements";
+        }
+        for (int i = 0; i < 2; ++i) {
+            if (card_number_for_latest_possible_reply[i] != (announcements[!i] == NONE ? -1 : get_number_of_cards_for_announcement(announcements[!i])))
+                return "invalid number of cards for the latest reply";
+            if (first_announcement_in_time[i] && announcements[i] == NONE)
+                return "announcement in time without announcement";
+            if (announcements[i] != NONE && players_known_team[0] != i && players_known_team[1] != i && players_known_team[2] != i
+                && players_known_team[3] != i)
+                return "announcement without a player of the team";
+        }
+        if (!teams_are_known) {
+            // the latest moments must not be too high for any of the teams a player may belong to
+            for (int i = 0; i < 4; ++i) {
+                announcement_t announcement = get_announcement_for_number_of_cards(players_latest_moment_for_announcement[i]);
+                for (int team = 0; team < 2; ++team) {
+                    if (players_known_team[i] == !team)
+                        continue;
+                    if (announcements[team] < announcement && (announcements[!team] < announcement || announcements[team] >= REKON)
+                        && players_latest_moment_for_announcement[i] > get_number_of_cards_for_announcement(announcements[team]))
+                        return "invalid latest moment for announcements";
+                }
+            }
+        }
+    }
+
+    return get_card_distribution_inconsistency(players_played_cards, complete_information);
+}
+
+// true iff the state is reached by answering the questions of set_move() from the start of the game with the first player, compulsory solos and cards of the state
+bool BeliefGameState::is_reachable_before_game_type(bool complete_information) const {
+    vector<unsigned char> binary;
+    write_binary(binary);
+    Cards other_players_cards[4];
+    for (int i = 0; i < 4; ++i) {
+        if (i != player_number)
+            other_players_cards[i] = cards[i];
+    }
+    for (int vorfuehrung = 0; vorfuehrung < 2; ++vorfuehrung) {
+        BeliefGameState start(options, player_number, played_compulsory_solo, vorfuehrung, first_player, cards[player_number]);
+        start.set_uct_output(uct_output);
+        if (complete_information)
+            start.set_other_players_cards(other_players_cards);
+        vector<BeliefGameState> open_states(1, start);
+        while (!open_states.empty()) {
+            BeliefGameState state = open_states.back();
+            open_states.pop_back();
+            vector<unsigned char> state_binary;
+            state.write_binary(state_binary);
+            if (state_binary == binary)
+                return true;
+            if (state.game_type != 0 || !state.next_move_type.is_question_move())
+                continue;
+            int player = state.player_to_move;
+            for (int answer = 0; answer < 2; ++answer) {
+                // answering no to IS_SOLO announces a marriage, which only the player holding both queens of clubs can
+                if (state.next_move_type.get_question_type() == IS_SOLO && !answer
+                    && (player == player_number || complete_information ? !state.has_both_queens_of_clubs(player)
+                        : state.cards[player_number].contains_card(CQ) || state.cards[player_number].contains_card(CQ_)
+                          || state.cards_that_players_cannot_have[player].contains_card(CQ)))
+                    continue;
+                open_states.push_back(state);
+                open_states.back().set_move(player, Move(state.next_move_type.get_question_type(), answer));
+            }
+        }
+    }
+    return false;
+}
+
+// Hall's condition: the cards can be dealt to the players other than the owner if for every set of players, the cards which only these players can have are not more than they need
+static bool can_deal_cards(Cards cards, const Cards cards_that_players_cannot_have[4], const int players_cards_count[4], int owner) {
+    vector<Card> single_cards;
+    cards.get_single_cards(single_cards);
+    int number_of_cards[16] = { 0 }; // by the set of players who can have the cards
+    for (size_t i = 0; i < single_cards.size(); ++i) {
+        int players = 0;
+        for (int j = 0; j < 4; ++j) {
+            if (j != owner && players_cards_count[j] > 0 && !cards_that_players_cannot_have[j].contains_card(single_cards[i]))
+                players |= 1 << j;
+        }
+        ++number_of_cards[players];
+    }
+    for (int players = 0; players < 16; ++players) {
+        int needed_cards = 0;
+        for (int j = 0; j < 4; ++j) {
+            if (players & (1 << j))
+                needed_cards += players_cards_count[j];
+        }
+        int cards_only_for_players = 0;
+        for (int subset = 0; subset < 16; ++subset) {
+            if ((subset & players) == subset)
+                cards_only_for_players += number_of_cards[subset];
+        }
+        if (cards_only_for_players > needed_cards || (players == (15 & ~(1 << owner)) && cards_only_for_players != needed_cards))
+            return false;
+    }
+    return true;
+}
+
+/*
+  The cards which are neither played nor held by the owner need to be dealt
+  to the other players by CardAssignment, such that every player gets as many
+  cards as he still holds, none of the cards he cannot have and a queen of
+  clubs if he must have one. In every such deal of a regular game, the known
+  teams need to match the queens of clubs, because set_move() asserts this
+  when the cards are played.
+*/
+string BeliefGameState::get_card_distribution_inconsistency(const Cards players_played_cards[4], bool complete_information) const {
+    Cards queens_of_clubs;
+    queens_of_clubs.add_card(CQ);
+    queens_of_clubs.add_card(CQ_);
+    Cards remaining_cards;
+    for (int i = 0; i < 48; ++i) {
+        if (!played_cards.contains_card(Card(i)) && !cards[player_number].contains_card(Card(i)))
+            remaining_cards.add_card(Card(i));
+    }
+    vector<Card> remaining_queens_of_clubs;
+    remaining_cards.get_intersection(queens_of_clubs).get_single_cards(remaining_queens_of_clubs);
+    remaining_cards.remove_cards(queens_of_clubs);
+
+    if (complete_information) { // the actual deal needs to be one of them
+        for (int i = 0; i < 4; ++i) {
+            if (players_must_have_queen_of_clubs[i] && cards[i].get_intersection(queens_of_clubs).empty())
+                return "player does not hold the queen of clubs he must have";
+        }
+    }
+    // like the assertion in CardAssignment::assign_cards_to_players, a queen of clubs which only one player can have makes the queen of clubs other players must have known
+    for (size_t j = 0; j < remaining_queens_of_clubs.size(); ++j) {
+        int number_of_players = 0;
+        int player = -1;
+        for (int i = 0; i < 4; ++i) {
+            if (i != player_number && players_cards_count[i] > 0 && !cards_that_players_cannot_have[i].contains_card(remaining_queens_of_clubs[j])) {
+                ++number_of_players;
+                player = i;
+            }
+        }
+        for (int i = 0; i < 4 && number_of_players == 1; ++i) {
+            if (i != player && players_must_have_queen_of_clubs[i])
+                return "player must have a queen of clubs which another player has";
+        }
+    }
+
+    // try every deal of the queens of clubs, encoded by two bits for the player of each queen
+    bool deal_exists = false;
+    for (int deal = 0; deal < (1 << (2 * remaining_queens_of_clubs.size())); ++deal) {
+        Cards players_queens_of_clubs[4];
+        int players_cards_count_without_queens[4];
+        bool possible = true;
+        for (size_t j = 0; j < remaining_queens_of_clubs.size(); ++j) {
+            int player = (deal >> (2 * j)) & 3;
+            if (player == player_number || cards_that_players_cannot_have[player].contains_card(remaining_queens_of_clubs[j]))
+                possible = false;
+            players_queens_of_clubs[player].add_card(remaining_queens_of_clubs[j]);
+        }
+        for (int i = 0; i < 4; ++i) {
+            players_cards_count_without_queens[i] = players_cards_count[i] - players_queens_of_clubs[i].size();
+            if (players_cards_count_without_queens[i] < 0 || (players_must_have_queen_of_clubs[i] && players_queens_of_clubs[i].empty()))
+                possible = false;
+        }
+        if (!possible || !can_deal_cards(remaining_cards, cards_that_players_cannot_have, players_cards_count_without_queens, player_number))
+            continue;
+        deal_exists = true;
+        if (*game_type != regular)
+            continue;
+        for (int i = 0; i < 4; ++i) {
+            bool has_queen_of_clubs = !players_queens_of_clubs[i].empty() || !cards[i].get_intersection(queens_of_clubs).empty()
+                || !players_played_cards[i].get_intersection(queens_of_clubs).empty();
+            if (players_known_team[i] != -1 && players_known_team[i] != has_queen_of_clubs)
+                return "known team does not match the queens of clubs";
+        }
+    }
+    if (!deal_exists)
+        return "the remaining cards cannot be dealt to the players";
+    return "";
 }
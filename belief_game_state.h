@@ -23,9 +23,15 @@
 #include "game_state.h"
 
 #include <cassert>
+#include <iosfwd>
+#include <string>
+#include <vector>
 
 /**
 BeliefGameState is designed for the use by players, especially uct-players who need to keep track of the current game without having complete information, though. The mechanics of this class are somewhat complicated, although there are only two central methods: set_move() and get_legal_moves(). The functionallity of the two methods mirrors the one of ActualGameState with the only difference being that this class does not play the real game, but gets updated according to what happens in the real (or in a simulated) game. Thus set_move() needs to compute which player has to play next and what kind of move is next and needs to be able to return the legal moves for that player (which is done in get_legal_moves()). The latter is only needed for algorithms such as the uct-algorithm that simulates the game further on, i.e. this class is being needed for node-expansion in a game tree search.
+
+Serialization:
+A state can be written as a compact binary blob (less than 200 bytes) or as human readable text with one field per line, and an identical state can be constructed from either (given Options with the same solo and announcement settings, which are stored with the state). Both forms contain all fields in a fixed order (see serialize_fields()), i.e. equal states have equal serializations. This allows to capture positions from real games and to search them again elsewhere. As positions may come from other programs (see server.h), reading never terminates the program: malformed data and states which set_move() cannot reach (see get_inconsistency()) are reported as an error instead, because the methods used by Uct assert the invariants of reachable states.
 */
 
 class BeliefGameState : public GameState {
@@ -56,6 +62,11 @@ private:
     int player_to_play_card; // next player to play a card
 
     void determine_first_move(bool vorfuehrung);
+    template<class Serializer, class State>
+    static void serialize_fields(Serializer &serializer, State &state); // writes all fields of a const state or reads all fields into a state, except for options and player_number
+    std::string get_inconsistency() const; // the reason why a state read cannot be reached by set_move(), or an empty string
+    bool is_reachable_before_game_type(bool complete_information) const;
+    std::string get_card_distribution_inconsistency(const Cards players_played_cards[4], bool complete_information) const;
     void set_player_to_have_queen_of_clubs(int player, Card queen_of_clubs); // this method sets all other players than player to not have the given queen of clubs
     // when calling the methods set_xxx_move from set_move, "player" is always equal to "player_to_move", thus the extra argument is omitted
     void set_immediate_solo_move(const Move &move);
@@ -66,16 +77,32 @@ private:
     void set_card_move(const Move &move);
 
     // method related to heuristic move computation get_best_move_index()
-    int play_valuable_card(const std::vector<Card> &possible_cards) const;
+    int play_valuable_card(const std::vector<Move> &legal_moves, Cards possible_cards) const;
 public:
     BeliefGameState(const Options &options, int player_number, const bool played_compulsory_solo[4],
                     bool vorfuehrung, int first_player, Cards players_cards);
+    // see write_binary and write_text. error is set to the reason if the data is malformed or the state inconsistent, in which case the state must not be used. reading text always consumes the lines up to the last field, such that a stream of states can be read on after an error
+    BeliefGameState(const Options &options, const std::vector<unsigned char> &binary, std::string &error);
+    BeliefGameState(const Options &options, std::istream &text, std::string &error);
     void set_other_players_cards(const Cards cards[4]);
     void set_move(int player, const Move &move);
     int get_player_to_move() const {
         return player_to_move;
     }
+    int get_player_number() const { // added for the analysis server
+        return player_number;
+    }
+    Cards get_players_cards() const { // the remaining cards of the player owning the instance, added for the analysis server
+        return cards[player_number];
+    }
     void get_legal_moves(std::vector<Move> &legal_moves) const;
+    // the legal moves of the owner in its own state, in which the owner's team is not set in a regular game before it is known to the other players (see set_other_players_cards). added for the analysis server
+    void get_owners_legal_moves(std::vector<Move> &legal_moves) const;
+    // keeps only one card of every class of equivalent legal cards (see GameType::are_equivalent), assuming that the player to move plays a card. legal_cards must be ordered by ids. added for Uct
+    void merge_equivalent_cards(std::vector<Move> &legal_cards) const;
+    bool has_both_queens_of_clubs(int player) const { // i.e. can play a marriage. for other players than the owning one only known with complete information. added for GameLog
+        return cards[player].contains_card(CQ) && cards[player].contains_card(CQ_);
+    }
     Cards get_played_cards() const {
         return played_cards;
     }
@@ -91,6 +118,8 @@ public:
     void set_uct_output(bool value) {
         uct_output = value;
     }
+    void write_binary(std::vector<unsigned char> &binary) const;
+    void write_text(std::ostream &text) const;
     bool operator==(const BeliefGameState &rhs) const {
         //const Options &options;
         for (int i = 0; i < 4; ++i) {
@@ -110,8 +139,8 @@ public:
             assert(card_number_for_latest_possible_reply[i] == rhs.card_number_for_latest_possible_reply[i]);
         }
         assert(game_type == rhs.game_type);
-        assert(tricks.size() == rhs.tricks.size());
-        for (size_t i = 0; i < tricks.size(); ++i)
+        assert(number_of_tricks == rhs.number_of_tricks);
+        for (int i = 0; i < number_of_tricks; ++i)
             assert(tricks[i] == rhs.tricks[i]);
         assert(session_instance == rhs.session_instance);
         assert(player_played_queen_of_clubs == rhs.player_played_queen_of_clubs);
@@ -138,6 +167,7 @@ public:
         assert(player_to_play_card == rhs.player_to_play_card);
         return true;
     }
+    /* heuristic choice of a card for the player to move: a card which wins the trick against the highest legal cards of all following opponents or a valuable card if the trick is already safe for the player's team. returns -1 if there is no such card. works on Cards masks only and needs no heap allocation because it is called for every card played in a heuristic rollout of Uct */
     int get_best_move_index(const std::vector<Move> &legal_moves) const;
 };
 
@@ -0,0 +1,102 @@
+/*
+  doko is a C++ doppelkopf program with an integrated UCT player.
+  Copyright (c) 2011-2016 Silvan Sievers
+  For questions, please write to: silvan.sievers@unibas.ch
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "belief_player.h"
+
+#include "belief_game_state.h"
+#include "checkpoint.h"
+#include "options.h"
+
+#include <cassert>
+
+using namespace std;
+
+BeliefPlayer::BeliefPlayer(int player_number, const Options &options_) : Player(player_number), options(options_),
+    current_belief_state(0), first_player(0), vorfuehrung(false), number_of_current_game(0) {
+    for (int i = 0; i < 4; ++i) {
+        if (options.use_compulsory_solo())
+            played_compulsory_solo[i] = false;
+        else
+            played_compulsory_solo[i] = true;
+    }
+}
+
+BeliefPlayer::~BeliefPlayer() {
+    delete current_belief_state;
+}
+
+void BeliefPlayer::check_vorfuehrung(int number_of_remaining_games) {
+    int remaining_compulsory_solos = 0;
+    for (int i = 0; i < 4; ++i) {
+        if (!played_compulsory_solo[i])
+            ++remaining_compulsory_solos;
+    }
+    assert(remaining_compulsory_solos <= number_of_remaining_games);
+    if (remaining_compulsory_solos == number_of_remaining_games) {
+        vorfuehrung = true;
+    }
+}
+
+void BeliefPlayer::set_cards(Cards cards_) {
+    Player::set_cards(cards_);
+    delete current_belief_state;
+    if (!vorfuehrung)
+        check_vorfuehrung(options.get_number_of_games() - number_of_current_game);
+    current_belief_state = new BeliefGameState(options, id, played_compulsory_solo, vorfuehrung, first_player, cards);
+}
+
+void BeliefPlayer::inform_about_move(int player, const Move &move) {
+    Player::inform_about_move(player, move);
+    current_belief_state->set_move(player, move);
+}
+
+void BeliefPlayer::inform_about_game_end(const int players_game_points[4]) {
+    ++number_of_current_game;
+    int new_points[4] = { 0, 0, 0, 0 };
+    int new_points2[4] = { 0, 0, 0, 0 };
+    // pass new_points2 as a dummy just to avoid output in GameState
+    current_belief_state->get_score_points(new_points, new_points2);
+    for (int i = 0; i < 4; ++i) {
+        assert(players_game_points[i] == new_points[i]);
+    }
+    if (current_belief_state->is_compulsory_solo()) {
+        int solo_player = current_belief_state->get_compulsory_solo_player();
+        played_compulsory_solo[solo_player] = true;
+    }
+    if (!current_belief_state->is_compulsory_solo() || vorfuehrung)
+        first_player = next_player(first_player);
+}
+
+void BeliefPlayer::write_checkpoint(CheckpointWriter &writer) const {
+    for (int i = 0; i < 4; ++i)
+        writer.write_bool(played_compulsory_solo[i]);
+    writer.write_int(first_player);
+    writer.write_bool(vorfuehrung);
+    writer.write_int(number_of_current_game);
+}
+
+void BeliefPlayer::read_checkpoint(CheckpointReader &reader) {
+    for (int i = 0; i < 4; ++i)
+        played_compulsory_solo[i] = reader.read_bool();
+    first_player = reader.read_int();
+    vorfuehrung = reader.read_bool();
+    number_of_current_game = reader.read_int();
+    if (first_player < 0 || first_player > 3 || number_of_current_game < 0)
+        reader.exit_with_invalid_checkpoint("invalid player state");
+}
@@ -0,0 +1,51 @@
+/*
+  doko is a C++ doppelkopf program with an integrated UCT player.
+  Copyright (c) 2011-2016 Silvan Sievers
+  For questions, please write to: silvan.sievers@unibas.ch
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef BELIEF_PLAYER_H
+#define BELIEF_PLAYER_H
+
+#include "player.h"
+
+class BeliefGameState;
+class Options;
+
+/**
+A player which keeps track of the game from its point of view with a BeliefGameState (UctPlayer and HeuristicPlayer). It also keeps track of the session: the compulsory solos played so far, the first player of the next game and whether the remaining games are all compulsory solos (vorfuehrung), which are stored in checkpoints.
+*/
+
+class BeliefPlayer : public Player {
+    void check_vorfuehrung(int number_of_remaining_games);
+protected:
+    const Options &options;
+    BeliefGameState *current_belief_state;
+    bool played_compulsory_solo[4];
+    int first_player;
+    bool vorfuehrung;
+    int number_of_current_game;
+public:
+    BeliefPlayer(int player_number, const Options &options);
+    virtual ~BeliefPlayer();
+    virtual void set_cards(Cards cards); // starts a new belief state
+    virtual void inform_about_move(int player, const Move &move);
+    virtual void inform_about_game_end(const int players_game_points[4]);
+    virtual void write_checkpoint(CheckpointWriter &writer) const;
+    virtual void read_checkpoint(CheckpointReader &reader);
+};
+
+#endif
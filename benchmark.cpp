@@ -0,0 +1,521 @@
+/*
+  doko is a C++ doppelkopf program with an integrated UCT player.
+  Copyright (c) 2011-2016 Silvan Sievers
+  For questions, please write to: silvan.sievers@unibas.ch
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+  Micro benchmarks for operations that are performed very often during a
+  UCT search. Usage: benchmark [number of iterations]
+*/
+
+#include "belief_game_state.h"
+#include "card_assignment.h"
+#include "game_type.h"
+#include "options.h"
+#include "reference.h"
+#include "rng.h"
+#include "timer.h"
+#include "uct.h"
+#include "uct_formula.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// prevents the compiler from optimizing away (parts of) the memory written to at the given address
+static void escape(void *pointer) {
+    asm volatile("" : : "g"(pointer) : "memory");
+}
+
+/*
+  Deals random cards and plays random moves until the given number of cards
+  has been played, i.e. returns a typical state as encountered by Uct.
+*/
+static BeliefGameState create_state(const Options &options, RandomNumberGenerator &rng, int number_of_cards) {
+    Card deck[48];
+    for (int i = 0; i < 48; ++i)
+        deck[i] = Card(i);
+    random_shuffle(deck, deck + 48, rng);
+    Cards cards[4];
+    for (int i = 0; i < 48; ++i)
+        cards[i / 12].add_card(deck[i]);
+    bool played_compulsory_solo[4] = { true, true, true, true };
+    BeliefGameState state(options, 0, played_compulsory_solo, false, 0, cards[0]);
+    state.set_uct_output(false);
+    Cards other_players_cards[4] = { Cards(), cards[1], cards[2], cards[3] };
+    state.set_other_players_cards(other_players_cards);
+    int cards_played = 0;
+    while (cards_played < number_of_cards) {
+        vector<Move> legal_moves;
+        state.get_legal_moves(legal_moves);
+        size_t move_index = 0; // do not play solos or make any announcements
+        if (legal_moves[0].is_card_move()) {
+            move_index = rng.next(legal_moves.size());
+            ++cards_played;
+        }
+        state.set_move(state.get_player_to_move(), legal_moves[move_index]);
+    }
+    return state;
+}
+
+static void benchmark_random_number_generator(int iterations) {
+    double times[2];
+    int checksum = 0;
+    for (int type = XOSHIRO; type <= MERSENNE_TWISTER; ++type) {
+        RandomNumberGenerator rng(2011, 0, static_cast<rng_t>(type));
+        Timer timer;
+        for (int i = 0; i < iterations; ++i)
+            checksum += rng.next(i % 13 + 1); // the typical numbers of legal moves and players
+        times[type] = timer();
+    }
+    escape(&checksum);
+    cout << "random bounded integer: " << times[XOSHIRO] / iterations * 1e9 << " ns (mersenne twister: "
+         << times[MERSENNE_TWISTER] / iterations * 1e9 << " ns)" << endl;
+}
+
+static void benchmark_belief_game_state_copy(const Options &options, int iterations) {
+    RandomNumberGenerator rng(2011);
+    vector<BeliefGameState> states;
+    for (int i = 0; i < 16; ++i)
+        states.push_back(create_state(options, rng, 3 * i));
+    void *memory = ::operator new(sizeof(BeliefGameState));
+    Timer timer;
+    for (int i = 0; i < iterations; ++i) {
+        BeliefGameState *copy = new (memory) BeliefGameState(states[i % states.size()]);
+        escape(copy);
+        copy->~BeliefGameState();
+    }
+    double time = timer();
+    ::operator delete(memory);
+    cout << "copying a BeliefGameState (" << sizeof(BeliefGameState) << " bytes): "
+         << time / iterations * 1e9 << " ns" << endl;
+}
+
+static void benchmark_best_move_index(const Options &options, int iterations) {
+    RandomNumberGenerator rng(2011);
+    vector<BeliefGameState> states;
+    vector<vector<Move> > legal_moves(44);
+    for (int i = 0; i < 44; ++i) {
+        states.push_back(create_state(options, rng, i));
+        states.back().get_legal_moves(legal_moves[i]);
+        while (!legal_moves[i][0].is_card_move()) { // do not make any announcements
+            states.back().set_move(states.back().get_player_to_move(), legal_moves[i][0]);
+            legal_moves[i].clear();
+            states.back().get_legal_moves(legal_moves[i]);
+        }
+    }
+    int checksum = 0;
+    Timer timer;
+    for (int i = 0; i < iterations; ++i)
+        checksum += get_best_move_index_reference(states[i % states.size()], legal_moves[i % states.size()]);
+    double reference_time = timer();
+    timer.reset();
+    for (int i = 0; i < iterations; ++i)
+        checksum -= states[i % states.size()].get_best_move_index(legal_moves[i % states.size()]);
+    double time = timer();
+    escape(&checksum);
+    assert(checksum == 0);
+    cout << "heuristic card choice: " << time / iterations * 1e9 << " ns (reference implementation: "
+         << reference_time / iterations * 1e9 << " ns)" << endl;
+}
+
+/*
+  Compares select_uct_successor with the scalar uct formula computing the
+  logarithm for every successor, for nodes with the typical numbers of
+  successors of card moves.
+*/
+static void benchmark_uct_formula(int iterations) {
+    RandomNumberGenerator rng(2011);
+    vector<UctSuccessors> nodes(16);
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        nodes[i].number_of_successors = 2 + i % 11;
+        for (int j = 0; j < nodes[i].number_of_successors; ++j) {
+            nodes[i].visits[j] = 1 + rng.next(1000);
+            nodes[i].accumulated_rewards[j] = (rng.next_half_open() - 0.5) * 1000 * nodes[i].visits[j];
+            nodes[i].log_trials[j] = log(10000);
+            nodes[i].selectable[j] = rng.next(4) != 0 || j == 0;
+        }
+    }
+    const double epsilon = 0.0000001;
+    int checksum = 0;
+    Timer timer;
+    for (int i = 0; i < iterations; ++i) {
+        const UctSuccessors &node = nodes[i % nodes.size()];
+        int node_visits = 10000 + i % 2; // as computed for every node
+        int best_index = -1;
+        double best_value = 0;
+        for (int j = 0; j < node.number_of_successors; ++j) {
+            if (!node.selectable[j])
+                continue;
+            double value = node.accumulated_rewards[j] / node.visits[j];
+            value += 20000.0 * sqrt(log(node_visits) / node.visits[j]);
+            if (best_index == -1 || value - best_value > epsilon) {
+                best_value = value;
+                best_index = j;
+            }
+        }
+        checksum += best_index;
+    }
+    double reference_time = timer();
+    timer.reset();
+    for (int i = 0; i < iterations; ++i) {
+        UctSuccessors &node = nodes[i % nodes.size()];
+        double log_trials = log(10000 + i % 2);
+        for (int j = 0; j < node.number_of_successors; ++j)
+            node.log_trials[j] = log_trials;
+        checksum -= select_uct_successor(node, 20000.0, epsilon);
+    }
+    double time = timer();
+    escape(&checksum);
+    assert(checksum == 0);
+    cout << "uct formula for all successors of a node: " << time / iterations * 1e9 << " ns (scalar formula: "
+         << reference_time / iterations * 1e9 << " ns)" << endl;
+}
+
+/*
+  Plays complete games with complete information like the heuristic rollouts
+  of Uct (the card of get_best_move_index if there is one and a random card
+  otherwise, no announcements), once as regular games and once as every solo,
+  reporting the time per game.
+*/
+static void benchmark_playouts(const Options &options, int number_of_games) {
+    const GameType *game_types[8] = { &regular, &diamonds_solo, &hearts_solo, &spades_solo, &clubs_solo, &jacks_solo,
+                                      &queens_solo, &aces_solo };
+    RandomNumberGenerator rng(2011);
+    vector<BeliefGameState> states; // the same deals for every game type
+    for (int game = 0; game < number_of_games; ++game) {
+        Card deck[48];
+        for (int i = 0; i < 48; ++i)
+            deck[i] = Card(i);
+        random_shuffle(deck, deck + 48, rng);
+        Cards cards[4];
+        for (int i = 0; i < 48; ++i)
+            cards[i / 12].add_card(deck[i]);
+        bool played_compulsory_solo[4] = { true, true, true, true };
+        states.push_back(BeliefGameState(options, 0, played_compulsory_solo, false, 0, cards[0]));
+        states.back().set_uct_output(false);
+        Cards other_players_cards[4] = { Cards(), cards[1], cards[2], cards[3] };
+        states.back().set_other_players_cards(other_players_cards);
+    }
+    cout << "playouts:";
+    vector<Move> legal_moves;
+    for (int type = 0; type < 8; ++type) {
+        Timer timer;
+        for (int game = 0; game < number_of_games; ++game) {
+            BeliefGameState state(states[game]);
+            while (!state.game_finished()) {
+                legal_moves.clear();
+                state.get_legal_moves(legal_moves);
+                int move_index = 0; // "no" to all questions and no announcements
+                if (legal_moves[0].is_question_move()) {
+                    if (type > 0 && legal_moves[0].get_question_type() == IMMEDIATE_SOLO)
+                        move_index = 1;
+                } else if (legal_moves[0].is_game_type_move()) {
+                    while (!(legal_moves[move_index] == Move(game_types[type])))
+                        ++move_index;
+                } else if (legal_moves[0].is_card_move()) {
+                    move_index = state.get_best_move_index(legal_moves);
+                    if (move_index == -1)
+                        move_index = rng.next(legal_moves.size());
+                }
+                state.set_move(state.get_player_to_move(), legal_moves[move_index]);
+            }
+        }
+        double time = timer();
+        cout << " " << *game_types[type] << " " << time / number_of_games * 1e6 << " us";
+    }
+    cout << " per game" << endl;
+}
+
+/*
+  Plays random games from the point of view of all four players and runs a
+  Uct search for the player to move at every card move with more than one
+  option after the first trick, reporting the branching factor at these
+  positions (with and without merging both copies of a card and equivalent
+  cards, see Uct) and the size (nodes and memory) of the search trees.
+*/
+static void benchmark_uct_tree_size(const Options &options, int number_of_games) {
+    RandomNumberGenerator rng(2011);
+    int number_of_positions = 0;
+    int legal_moves_sum = 0;
+    int merged_moves_sum = 0;
+    int equivalence_classes_sum = 0;
+    long nodes_sum = 0;
+    double bytes_sum = 0;
+    Timer timer;
+    for (int game = 0; game < number_of_games; ++game) {
+        Card deck[48];
+        for (int i = 0; i < 48; ++i)
+            deck[i] = Card(i);
+        random_shuffle(deck, deck + 48, rng);
+        Cards cards[4];
+        for (int i = 0; i < 48; ++i)
+            cards[i / 12].add_card(deck[i]);
+        bool played_compulsory_solo[4] = { true, true, true, true };
+        vector<BeliefGameState> states; // the game from the point of view of every player plus the complete game
+        for (int player = 0; player < 5; ++player) {
+            states.push_back(BeliefGameState(options, player % 4, played_compulsory_solo, false, 0, cards[player % 4]));
+            states.back().set_uct_output(false);
+        }
+        Cards other_players_cards[4] = { Cards(), cards[1], cards[2], cards[3] };
+        states[4].set_other_players_cards(other_players_cards);
+        int cards_played = 0;
+        while (cards_played < 44) { // Uct does not support the last trick
+            int player = states[4].get_player_to_move();
+            vector<Move> legal_moves;
+            states[4].get_legal_moves(legal_moves);
+            size_t move_index = 0; // do not play solos or make any announcements
+            if (legal_moves[0].is_card_move()) {
+                if (cards_played >= 4 && legal_moves.size() > 1) {
+                    vector<Move> merged_moves(legal_moves);
+                    merge_duplicate_cards(merged_moves);
+                    merged_moves_sum += merged_moves.size();
+                    states[player].merge_equivalent_cards(merged_moves);
+                    equivalence_classes_sum += merged_moves.size();
+                    Uct uct(options, states[player], cards[player], 0);
+                    ++number_of_positions;
+                    legal_moves_sum += legal_moves.size();
+                    nodes_sum += uct.get_number_of_nodes();
+                    bytes_sum += uct.get_tree_bytes();
+                }
+                move_index = rng.next(legal_moves.size()); // the same positions independently of the search
+                cards[player].remove_card(legal_moves[move_index].get_card());
+                ++cards_played;
+            }
+            for (int i = 0; i < 5; ++i)
+                states[i].set_move(player, legal_moves[move_index]);
+        }
+    }
+    double time = timer();
+    cout << "uct searches at " << number_of_positions << " positions: average branching factor "
+         << static_cast<double>(legal_moves_sum) / number_of_positions << " (merging copies: "
+         << static_cast<double>(merged_moves_sum) / number_of_positions << ", merging equivalent cards: "
+         << static_cast<double>(equivalence_classes_sum) / number_of_positions << "), average number of nodes "
+         << static_cast<double>(nodes_sum) / number_of_positions << " (" << bytes_sum / number_of_positions / 1024
+         << " KB), " << time / number_of_positions * 1e3
+         << " ms per search" << endl;
+}
+
+// the defaults of main.cpp with the given number of rollouts and the given value of one other option
+static Options create_uct_options(int rollouts, int option, int value) {
+    int uct_player_options[] = { 1, 500, 1, 1, 20000, rollouts, 10, 2, 0, 0, 0, 0, 0, 0, 0, 0 };
+    uct_player_options[option] = value;
+    vector<vector<int> > uct_players_options(4, vector<int>(uct_player_options, uct_player_options + NUMBER_OF_PLAYER_OPTIONS));
+    return Options(4, false, false, vector<player_t>(4, UCT), true, 2012, XOSHIRO, false, false, false, false,
+                   uct_players_options, false, 1, "", "");
+}
+
+/*
+  Compares the decisions of searches with few rollouts with an option of the
+  selection of successors being switched off (0) or on (1) at positions with
+  many legal cards: a search with many rollouts evaluates all moves, and the
+  regret of a decision is the difference between the best evaluation and the
+  one of the chosen move.
+*/
+static void benchmark_selection(int number_of_games, int option, const string &name) {
+    const int reference_rollouts = 8000;
+    const int rollouts[2] = { 250, 1000 };
+    Options reference_options = create_uct_options(reference_rollouts, option, 0);
+    RandomNumberGenerator rng(2011);
+    int number_of_positions = 0;
+    double regret_sum[2][2] = { { 0, 0 }, { 0, 0 } }; // rollouts, value of the option
+    double time_sum[2][2] = { { 0, 0 }, { 0, 0 } };
+    for (int game = 0; game < number_of_games; ++game) {
+        Card deck[48];
+        for (int i = 0; i < 48; ++i)
+            deck[i] = Card(i);
+        random_shuffle(deck, deck + 48, rng);
+        Cards cards[4];
+        for (int i = 0; i < 48; ++i)
+            cards[i / 12].add_card(deck[i]);
+        bool played_compulsory_solo[4] = { true, true, true, true };
+        vector<BeliefGameState> states; // the game from the point of view of every player plus the complete game
+        for (int player = 0; player < 5; ++player) {
+            states.push_back(BeliefGameState(reference_options, player % 4, played_compulsory_solo, false, 0,
+                                             cards[player % 4]));
+            states.back().set_uct_output(false);
+        }
+        Cards other_players_cards[4] = { Cards(), cards[1], cards[2], cards[3] };
+        states[4].set_other_players_cards(other_players_cards);
+        int cards_played = 0;
+        while (cards_played < 24) { // wide roots occur in the first half of the game
+            int player = states[4].get_player_to_move();
+            vector<Move> legal_moves;
+            states[4].get_legal_moves(legal_moves);
+            size_t move_index = 0; // do not play solos or make any announcements
+            if (legal_moves[0].is_card_move()) {
+                if (cards_played >= 4 && legal_moves.size() >= 6) {
+                    Uct reference(reference_options, states[player], cards[player], 0);
+                    vector<Move> moves;
+                    vector<int> visits;
+                    vector<double> rewards;
+                    reference.get_root_statistics(moves, visits, rewards);
+                    double best_reward = *max_element(rewards.begin(), rewards.end());
+                    for (int i = 0; i < 2; ++i) {
+                        for (int value = 0; value < 2; ++value) {
+                            Options options = create_uct_options(rollouts[i], option, value);
+                            Timer timer;
+                            Uct uct(options, states[player], cards[player], 0);
+                            int chosen = legal_moves[uct.get_best_move()].get_merged_id();
+                            time_sum[i][value] += timer();
+                            for (size_t j = 0; j < moves.size(); ++j) {
+                                if (moves[j].get_merged_id() == chosen)
+                                    regret_sum[i][value] += best_reward - rewards[j];
+                            }
+                        }
+                    }
+                    ++number_of_positions;
+                }
+                move_index = rng.next(legal_moves.size()); // the same positions independently of the searches
+                cards[player].remove_card(legal_moves[move_index].get_card());
+                ++cards_played;
+            }
+            for (int i = 0; i < 5; ++i)
+                states[i].set_move(player, legal_moves[move_index]);
+        }
+    }
+    for (int i = 0; i < 2; ++i) {
+        cout << name << " with " << rollouts[i] << " rollouts at " << number_of_positions
+             << " positions: average regret off " << regret_sum[i][0] / number_of_positions << " ("
+             << time_sum[i][0] / number_of_positions * 1e3 << " ms per search), on "
+             << regret_sum[i][1] / number_of_positions << " (" << time_sum[i][1] / number_of_positions * 1e3
+             << " ms per search), evaluated by " << reference_rollouts << " rollouts" << endl;
+    }
+}
+
+/*
+  Compares the decisions of searches sampling the card assignments with the
+  ones of searches enumerating them (see Uct) at the positions of the last
+  four tricks where the player to move has a choice and there are at most 100
+  card assignments, like benchmark_selection. The reference search uses all
+  card assignments, i.e. the exact distribution of the card assignments.
+*/
+static void benchmark_card_assignments_enumeration(int number_of_games) {
+    const int reference_rollouts = 8000;
+    const int rollouts = 1000;
+    const int limit = 100;
+    Options reference_options = create_uct_options(reference_rollouts, 15, limit);
+    Options options[2] = { create_uct_options(rollouts, 15, 0), create_uct_options(rollouts, 15, limit) };
+    RandomNumberGenerator rng(2011);
+    int number_of_positions = 0;
+    double regret_sum[2] = { 0, 0 };
+    double time_sum[2] = { 0, 0 };
+    for (int game = 0; game < number_of_games; ++game) {
+        Card deck[48];
+        for (int i = 0; i < 48; ++i)
+            deck[i] = Card(i);
+        random_shuffle(deck, deck + 48, rng);
+        Cards cards[4];
+        for (int i = 0; i < 48; ++i)
+            cards[i / 12].add_card(deck[i]);
+        bool played_compulsory_solo[4] = { true, true, true, true };
+        vector<BeliefGameState> states; // the game from the point of view of every player plus the complete game
+        for (int player = 0; player < 5; ++player) {
+            states.push_back(BeliefGameState(reference_options, player % 4, played_compulsory_solo, false, 0,
+                                             cards[player % 4]));
+            states.back().set_uct_output(false);
+        }
+        Cards other_players_cards[4] = { Cards(), cards[1], cards[2], cards[3] };
+        states[4].set_other_players_cards(other_players_cards);
+        while (!states[4].game_finished()) {
+            int player = states[4].get_player_to_move();
+            vector<Move> legal_moves;
+            states[4].get_legal_moves(legal_moves);
+            size_t move_index = 0; // do not play solos or make any announcements
+            if (legal_moves[0].is_card_move()) {
+                int completed_tricks = states[4].get_number_of_completed_tricks();
+                vector<WeightedCardAssignment> card_assignments;
+                if (completed_tricks >= 8 && completed_tricks < 11 && legal_moves.size() >= 2
+                    && CardAssignment(states[player], cards[player]).enumerate_card_assignments(states[player], limit,
+                                                                                                card_assignments)) {
+                    Uct reference(reference_options, states[player], cards[player], 0);
+                    vector<Move> moves;
+                    vector<int> visits;
+                    vector<double> rewards;
+                    reference.get_root_statistics(moves, visits, rewards);
+                    double best_reward = *max_element(rewards.begin(), rewards.end());
+                    for (int value = 0; value < 2; ++value) {
+                        Timer timer;
+                        Uct uct(options[value], states[player], cards[player], 0);
+                        int chosen = legal_moves[uct.get_best_move()].get_merged_id();
+                        time_sum[value] += timer();
+                        for (size_t j = 0; j < moves.size(); ++j) {
+                            if (moves[j].get_merged_id() == chosen)
+                                regret_sum[value] += best_reward - rewards[j];
+                        }
+                    }
+                    ++number_of_positions;
+                }
+                move_index = rng.next(legal_moves.size()); // the same positions independently of the searches
+                cards[player].remove_card(legal_moves[move_index].get_card());
+            }
+            for (int i = 0; i < 5; ++i)
+                states[i].set_move(player, legal_moves[move_index]);
+        }
+    }
+    cout << "card assignments with " << rollouts << " rollouts at " << number_of_positions
+         << " positions of the last four tricks: average regret sampled "
+         << regret_sum[0] / number_of_positions << " (" << time_sum[0] / number_of_positions * 1e3
+         << " ms per search), enumerated " << regret_sum[1] / number_of_positions << " ("
+         << time_sum[1] / number_of_positions * 1e3 << " ms per search), evaluated by " << reference_rollouts
+         << " rollouts with all card assignments" << endl;
+}
+
+int main(int argc, char *argv[]) {
+    int iterations = 10000000;
+    if (argc > 1)
+        iterations = atoi(argv[1]);
+    Cards::setup_bit_count();
+    vector<player_t> players_types(4, RANDOM);
+    vector<vector<int> > players_options(4);
+    Options options(4, false, false, players_types, true, 2012, XOSHIRO, false, false, false, false, players_options, false, 1, "", "");
+    benchmark_random_number_generator(iterations);
+    benchmark_belief_game_state_copy(options, iterations);
+    benchmark_best_move_index(options, iterations / 10);
+    benchmark_uct_formula(iterations);
+    benchmark_playouts(options, 20000);
+
+    vector<player_t> uct_players_types(4, UCT);
+    for (int rollout_truncation = 0; rollout_truncation <= 4; rollout_truncation += 2) {
+        int uct_player_options[] = { 1, 500, 1, 1, 20000, 1000, 10, 2, 0, 0, 0, rollout_truncation, 0, 0, 0, 0 }; // the defaults of main.cpp
+        vector<vector<int> > uct_players_options(4, vector<int>(uct_player_options, uct_player_options + NUMBER_OF_PLAYER_OPTIONS));
+        Options uct_options(4, false, false, uct_players_types, true, 2012, XOSHIRO, false, false, false, false, uct_players_options,
+                            false, 1, "", "");
+        cout << "rollout truncation " << rollout_truncation << ": ";
+        benchmark_uct_tree_size(uct_options, 10);
+    }
+    // adding all nodes encountered during a rollout, where the tree grows fastest
+    for (int node_budget = 0; node_budget <= 20000; node_budget += 10000) {
+        int uct_player_options[] = { 1, 500, 1, 1, 20000, 5000, 10, 2, 0, 0, 0, 0, node_budget, 0, 0, 0 };
+        vector<vector<int> > uct_players_options(4, vector<int>(uct_player_options, uct_player_options + NUMBER_OF_PLAYER_OPTIONS));
+        Options uct_options(4, false, false, uct_players_types, true, 2012, XOSHIRO, false, false, false, false, uct_players_options,
+                            false, 1, "", "");
+        cout << "adding all nodes, node budget " << node_budget << ": ";
+        benchmark_uct_tree_size(uct_options, 2);
+    }
+    benchmark_selection(10, 13, "sequential halving at the root");
+    benchmark_selection(10, 14, "availability counts");
+    benchmark_card_assignments_enumeration(20);
+    return 0;
+}
@@ -20,7 +20,6 @@
 #include "card_assignment.h"
 
 #include "belief_game_state.h"
-#include "options.h"
 
 #include <cassert>
 #include <iostream>
@@ -31,7 +30,7 @@ static void remove_player_who_got_all_cards(int player, vector<vector<int> > &ca
 static void remove_players_from_card_which_is_uniquely_assigned(int player, int index_of_card_that_player_must_have, vector<vector<int> > &card_to_players_who_can_have_it);
 static bool check_if_player_needs_as_many_cards_as_he_can_get(int player, const vector<Card> &remaining_cards, vector<vector<int> > &card_to_players_who_can_have_it, int cards_count);
 
-CardAssignment::CardAssignment(const Options &options_, const BeliefGameState &state, Cards players_cards) : options(options_), rng(2011) {
+CardAssignment::CardAssignment(const BeliefGameState &state, Cards players_cards) {
     assert(players_cards.size() >= 1);
     Cards played_cards = state.get_played_cards();
     int player_to_move = state.get_player_to_move();
@@ -68,7 +67,7 @@ CardAssignment::CardAssignment(const Options &options_, const BeliefGameState &s
             for (size_t k = 0; k < remaining_cards.size(); ++k)
                 if (single_cards[j] == remaining_cards[k])
                     contains_card = true;
-                assert(contains_card);
+            assert(contains_card);
         }
     }
 
@@ -149,7 +148,7 @@ bool check_if_player_needs_as_many_cards_as_he_can_get(int player, const vector<
     return false;
 }
 
-void CardAssignment::assign_cards_to_players(BeliefGameState &state) const {
+void CardAssignment::assign_cards_to_players(BeliefGameState &state, RandomNumberGenerator &rng) const {
     // need to make a copy because it will be changed later
     vector<Card> _remaining_cards(remaining_cards);
     vector<vector<int> > _card_to_players_who_can_have_it(card_to_players_who_can_have_it);
@@ -264,3 +263,81 @@ void CardAssignment::assign_cards_to_players(BeliefGameState &state) const {
 
     state.set_other_players_cards(players_assigned_cards);
 }
+
+bool CardAssignment::enumerate_card_assignments(const BeliefGameState &state, int max_number_of_card_assignments,
+                                                vector<WeightedCardAssignment> &card_assignments) const {
+    assert(max_number_of_card_assignments > 0);
+    card_assignments.clear();
+    int cards_players_can_get[4] = { 0, 0, 0, 0 }; // among the cards which have not been assigned yet
+    for (size_t i = 0; i < card_to_players_who_can_have_it.size(); ++i) {
+        for (size_t j = 0; j < card_to_players_who_can_have_it[i].size(); ++j)
+            ++cards_players_can_get[card_to_players_who_can_have_it[i][j]];
+    }
+    WeightedCardAssignment card_assignment;
+    card_assignment.weight = 1;
+    return enumerate_card_assignments_rec(state, 0, cards_players_can_get, card_assignment, max_number_of_card_assignments,
+                                          card_assignments);
+}
+
+// assigns the card at index of remaining_cards (and recursively all further cards) in every possible way. returns false as soon as there are too many card assignments
+bool CardAssignment::enumerate_card_assignments_rec(const BeliefGameState &state, size_t index, int *cards_players_can_get,
+                                                    WeightedCardAssignment &card_assignment, int max_number_of_card_assignments,
+                                                    vector<WeightedCardAssignment> &card_assignments) const {
+    const int *players_cards_count = state.get_players_cards_count();
+    if (index == remaining_cards.size()) {
+        const bool *players_must_have_queen_of_clubs = state.get_players_must_have_queen_of_clubs();
+        for (int i = 0; i < 4; ++i) {
+            if (players_must_have_queen_of_clubs[i] && !card_assignment.players_cards[i].contains_card(CQ)
+                && !card_assignment.players_cards[i].contains_card(CQ_))
+                return true;
+        }
+        if (static_cast<int>(card_assignments.size()) == max_number_of_card_assignments)
+            return false;
+        card_assignments.push_back(card_assignment);
+        return true;
+    }
+
+    Card card = remaining_cards[index];
+    const vector<int> &players_for_card = card_to_players_who_can_have_it[index];
+    for (size_t i = 0; i < players_for_card.size(); ++i)
+        --cards_players_can_get[players_for_card[i]];
+    // the first copy of the card is at the index before if the player does not own it (cards are ordered by indices and the copies of a card have neighboured indices)
+    int player_of_first_copy = -1;
+    int card_index = card.get_index();
+    if (card_index % 2 == 1 && index > 0 && remaining_cards[index - 1] == Card(card_index - 1)
+        && card_to_players_who_can_have_it[index - 1] == players_for_card) {
+        for (int i = 0; i < 4; ++i) {
+            if (card_assignment.players_cards[i].contains_card(remaining_cards[index - 1]))
+                player_of_first_copy = i;
+        }
+        assert(player_of_first_copy != -1);
+    }
+    bool complete = true;
+    for (size_t i = 0; i < players_for_card.size() && complete; ++i) {
+        int player = players_for_card[i];
+        if (player < player_of_first_copy || card_assignment.players_cards[player].size() == players_cards_count[player])
+            continue;
+        card_assignment.players_cards[player].add_card(card);
+        // every player needs to be able to get all cards he still needs from the cards which have not been assigned yet
+        bool possible = true;
+        for (int j = 0; j < 4; ++j) {
+            if (j != state.get_player_to_move()
+                && players_cards_count[j] - card_assignment.players_cards[j].size() > cards_players_can_get[j]) {
+                possible = false;
+                break;
+            }
+        }
+        if (possible) {
+            int weight = card_assignment.weight;
+            if (player_of_first_copy != -1 && player != player_of_first_copy)
+                card_assignment.weight *= 2;
+            complete = enumerate_card_assignments_rec(state, index + 1, cards_players_can_get, card_assignment,
+                                                      max_number_of_card_assignments, card_assignments);
+            card_assignment.weight = weight;
+        }
+        card_assignment.players_cards[player].remove_card(card);
+    }
+    for (size_t i = 0; i < players_for_card.size(); ++i)
+        ++cards_players_can_get[players_for_card[i]];
+    return complete;
+}
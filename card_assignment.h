@@ -33,20 +33,31 @@ Now the loop works as follows: for each iteration, "size_to_check" is fixed for
 In iterations where size_to_check is set to 2 or 3, the card being currently considered is randomly assigned to one of those 2 or 3 players, then running the checks again. Whenever one of those checks succeeds (i.e. a player is completely removed from all lists because he got all cards he needs or a player needs to get all cards he may get), size_to_check is decremented by 1 and the loop is repeated.
 
 This is not a strictly uniform random assignment but should get quite close to it.
+
+In the last tricks, there are often only few card assignments consistent with the above information. enumerate_card_assignments() then computes all of them with a simple backtracking search over the remaining cards in which a card is only assigned to a player if all players can still get as many cards as they need. As every card exists twice, assigning the first copy of a card to one player and the second copy to another one results in the same game as the other way round, thus if both copies can be assigned to the same players, the second copy is only assigned to the player of the first copy or a later one and the card assignment counts twice. The weight of a card assignment is the product of these factors, i.e. the number of deals of the (distinguishable) copies resulting in it, and thus proportional to its probability if all deals consistent with the information are equally likely.
 */
 
+struct WeightedCardAssignment { // added for the enumeration of card assignments
+    Cards players_cards[4]; // empty for the player owning the CardAssignment instance
+    int weight;
+};
+
 class BeliefGameState;
-class Options;
 
 class CardAssignment {
 private:
-    const Options &options;
-    mutable RandomNumberGenerator rng;
     std::vector<Card> remaining_cards;
     std::vector<std::vector<int> > card_to_players_who_can_have_it;
+    bool enumerate_card_assignments_rec(const BeliefGameState &state, size_t index, int *cards_players_can_get,
+                                        WeightedCardAssignment &card_assignment, int max_number_of_card_assignments,
+                                        std::vector<WeightedCardAssignment> &card_assignments) const;
 public:
-    CardAssignment(const Options &options, const BeliefGameState &state, Cards players_cards);
-    void assign_cards_to_players(BeliefGameState &state) const;
+    CardAssignment(const BeliefGameState &state, Cards players_cards);
+    // rng is the generator of the user of the instance (see CARD_ASSIGNMENT_STREAM), such that repeated assignments continue its sequence
+    void assign_cards_to_players(BeliefGameState &state, RandomNumberGenerator &rng) const;
+    /* computes all card assignments (see above), returns false if there are more than max_number_of_card_assignments of them, in which case card_assignments is incomplete */
+    bool enumerate_card_assignments(const BeliefGameState &state, int max_number_of_card_assignments,
+                                    std::vector<WeightedCardAssignment> &card_assignments) const;
 };
 
 #endif
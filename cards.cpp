@@ -36,12 +36,6 @@
 
 using namespace std;
 
-Card::Card() : value(0) {
-}
-
-Card::Card(int number) : value(1ULL << number) {
-}
-
 const int Card::card_to_index[53]= {
     -1, 0, 1, 17, 2, 47, 18, 14, 3, 34,
     -1, 6, 19, 24, 15, 12, 4, 10, 35, 37,
@@ -81,33 +75,12 @@ struct CardComparator {
     const GameType *game_type;
     CardComparator(const GameType *game_type_) : game_type(game_type_) {}
     bool operator()(Card lhs, Card rhs) const {
-        bool lhs_is_trump = game_type->get_trump_suit().contains_card(lhs);
-        bool rhs_is_trump = game_type->get_trump_suit().contains_card(rhs);
-        if (lhs_is_trump != rhs_is_trump) { // one card is trump, the other is not
-            return lhs_is_trump;
-        } else {
-            if (lhs_is_trump) { // both cards are trump
-                return game_type->get_trump_rank(lhs) <= game_type->get_trump_rank(rhs);
-            } else { // both cards are non trump
-                const vector<Cards> &non_trump_suits = game_type->get_non_trump_suits();
-                for (size_t i = non_trump_suits.size() - 1; i >= 0; --i) {
-                    bool lhs_is_of_current_suit = non_trump_suits[i].contains_card(lhs);
-                    bool rhs_is_of_current_suit = non_trump_suits[i].contains_card(rhs);
-                    if (lhs_is_of_current_suit && rhs_is_of_current_suit) // both cards are of the current non trump suit
-                        return game_type->get_non_trump_rank(lhs) <= game_type->get_non_trump_rank(rhs);
-                    if (lhs_is_of_current_suit) // only lhs is of the current non trump suit, thus ordering it before rhs
-                        return true;
-                    if (rhs_is_of_current_suit) // only rhs is of the current non trump suit, thus ordering lhs behind rhs
-                        return false;
-                    if (i == 0) { // avoid letting get i negative (which would cause an overflow, because its of type size_t)
-                        assert(false); // in the last iteration, one of the three tests above MUST succeed! thus we never reach this
-                        break;
-                    }
-                }
-            }
-            assert(false);
-            return true;
-        }
+        // trump cards come first (the trump suit has the highest suit index), then the non trump suits from clubs to diamonds, each ordered by rank
+        int lhs_suit = game_type->get_suit_index(lhs);
+        int rhs_suit = game_type->get_suit_index(rhs);
+        if (lhs_suit != rhs_suit)
+            return lhs_suit > rhs_suit;
+        return game_type->get_rank(lhs) < game_type->get_rank(rhs);
     }
 };
 
@@ -149,20 +122,8 @@ void Cards::remove_card(const Card &card) {
 }
 
 void Cards::remove_cards(const Cards &cards) {
-    vector<Card> single_cards;
-    cards.get_single_cards(single_cards);
-    for (size_t i = 0; i < single_cards.size(); ++i) {
-        Card card = single_cards[i];
-        if (contains_card(single_cards[i])) {
-            remove_card(card);
-        }
-    }
-    // TODO: why does this not work?
-    /*value ^= cards.value;
-    vector<Card> single_cards;
-    cards.get_single_cards(single_cards);
-    for (size_t i = 0; i < single_cards.size(); ++i)
-        assert(!contains_card(single_cards[i]));*/
+    // cards may contain cards which are not contained in this, thus "value ^= cards.value" would add these
+    value &= ~cards.value;
 }
 
 Cards Cards::get_intersection(const Cards &cards) const {
@@ -54,8 +54,8 @@ private:
     static const char *const card_names[48];
     static const int card_values[48];
 public:
-    Card();
-    Card(int number);
+    Card() : value(0) {}
+    Card(int number) : value(1ULL << number) {}
 
     // non class function get_cards_for_name needs access to card_names
     static const char *const *get_card_names() {
@@ -81,10 +81,6 @@ public:
         cards.value |= rhs.value;
         return cards;
     }
-    Card &operator=(const Card &rhs) { // this operator is probably not necessary because the compiler could infer it
-        value = rhs.value;
-        return *this;
-    }
     bool operator==(const Card &rhs) const {
         return value == rhs.value;
     }
@@ -122,17 +118,22 @@ public:
     bool contains_card(const Card &card) const {
         return (value & card.value) != 0;
     }
+    bool contains_cards(const Cards &cards) const { // added for GameType::are_equivalent
+        return (value & cards.value) == cards.value;
+    }
     Cards get_intersection(const Cards &cards) const;
     int size() const;
     bool empty() const {
         return size() == 0;
     }
     void get_single_cards(std::vector<Card> &cards) const;
-
-    Cards &operator=(const Cards &rhs) { // this operator is probably not necessary because the compiler could infer it
-        value = rhs.value;
-        return *this;
+    Card get_first_card() const { // the card with the smallest index, i.e. the first card returned by get_single_cards. added for BeliefGameState::get_best_move_index and GameState::get_estimated_score_points
+        assert(value != 0);
+        Card card;
+        card.value = value & (~value + 1);
+        return card;
     }
+
     bool operator==(const Cards &rhs) const { // added for BeliefGameState==
         return value == rhs.value;
     }
@@ -142,6 +143,7 @@ public:
 
     void show(const GameType *game_type) const;
     friend std::ostream &operator<<(std::ostream &out, Cards card);
+    friend class GameType;
 };
 
 // NOTE: this cannot be in class Card, because it should return objects of type Card, and it should not be in class Cards either, because it does not really belong there.
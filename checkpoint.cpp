@@ -0,0 +1,129 @@
+/*
+  doko is a C++ doppelkopf program with an integrated UCT player.
+  Copyright (c) 2011-2016 Silvan Sievers
+  For questions, please write to: silvan.sievers@unibas.ch
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "checkpoint.h"
+
+#include "rng.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+using namespace std;
+
+static const char CHECKPOINT_MAGIC[8] = { 'D', 'O', 'K', 'O', 'C', 'K', 'P', '1' };
+
+CheckpointWriter::CheckpointWriter() : bytes(CHECKPOINT_MAGIC, CHECKPOINT_MAGIC + sizeof(CHECKPOINT_MAGIC)) {
+}
+
+void CheckpointWriter::write_int(int value) {
+    unsigned int bits = static_cast<unsigned int>(value);
+    for (int i = 0; i < 4; ++i)
+        bytes.push_back((bits >> (8 * i)) & 0xff);
+}
+
+void CheckpointWriter::write_bool(bool value) {
+    bytes.push_back(value);
+}
+
+void CheckpointWriter::write_uint64(uint64_t value) {
+    for (int i = 0; i < 8; ++i)
+        bytes.push_back((value >> (8 * i)) & 0xff);
+}
+
+void CheckpointWriter::write_rng(const RandomNumberGenerator &rng) {
+    vector<uint64_t> state;
+    rng.get_state(state);
+    write_int(state.size());
+    for (size_t i = 0; i < state.size(); ++i)
+        write_uint64(state[i]);
+}
+
+void CheckpointWriter::save(const string &filename) const {
+    string temporary_filename = filename + ".tmp";
+    ofstream file(temporary_filename.c_str(), ios::binary);
+    file.write(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+    file.close();
+    // rename replaces the previous checkpoint atomically
+    if (!file || rename(temporary_filename.c_str(), filename.c_str()) != 0) {
+        cerr << "could not write checkpoint " << filename << endl;
+        exit(2);
+    }
+}
+
+CheckpointReader::CheckpointReader(const string &filename_) : filename(filename_), position(0) {
+    ifstream file(filename.c_str(), ios::binary);
+    if (!file)
+        exit_with_invalid_checkpoint("cannot open file");
+    bytes.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+    if (bytes.size() < sizeof(CHECKPOINT_MAGIC) || memcmp(bytes.data(), CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC)) != 0)
+        exit_with_invalid_checkpoint("not a checkpoint");
+    position = sizeof(CHECKPOINT_MAGIC);
+}
+
+unsigned char CheckpointReader::next_byte() {
+    if (position == bytes.size())
+        exit_with_invalid_checkpoint("truncated file");
+    return bytes[position++];
+}
+
+int CheckpointReader::read_int() {
+    unsigned int bits = 0;
+    for (int i = 0; i < 4; ++i)
+        bits |= static_cast<unsigned int>(next_byte()) << (8 * i);
+    return static_cast<int>(bits);
+}
+
+bool CheckpointReader::read_bool() {
+    unsigned char value = next_byte();
+    if (value > 1)
+        exit_with_invalid_checkpoint("invalid boolean");
+    return value == 1;
+}
+
+uint64_t CheckpointReader::read_uint64() {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i)
+        value |= static_cast<uint64_t>(next_byte()) << (8 * i);
+    return value;
+}
+
+void CheckpointReader::read_rng(RandomNumberGenerator &rng) {
+    int size = read_int();
+    if (size < 0 || static_cast<size_t>(size) > (bytes.size() - position) / 8)
+        exit_with_invalid_checkpoint("invalid random number generator");
+    vector<uint64_t> state(size);
+    for (int i = 0; i < size; ++i)
+        state[i] = read_uint64();
+    if (!rng.set_state(state))
+        exit_with_invalid_checkpoint("invalid random number generator");
+}
+
+void CheckpointReader::check_end() const {
+    if (position != bytes.size())
+        exit_with_invalid_checkpoint("file too long");
+}
+
+void CheckpointReader::exit_with_invalid_checkpoint(const string &reason) const {
+    cerr << "could not resume from checkpoint " << filename << ": " << reason << endl;
+    exit(2);
+}
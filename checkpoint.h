@@ -0,0 +1,70 @@
+/*
+  doko is a C++ doppelkopf program with an integrated UCT player.
+  Copyright (c) 2011-2016 Silvan Sievers
+  For questions, please write to: silvan.sievers@unibas.ch
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class RandomNumberGenerator;
+
+/**
+A checkpoint stores the state of a session after a game such that an interrupted session can be continued exactly like it would have been played without interruption (see Session and --resume). It is a binary file (all numbers in little endian byte order) consisting of:
+- 8 bytes: the magic DOKOCKP1
+- the options of the session which influence the course of the games (number of games, seed, random number generator, solo and announcing rules, players' types and options, opening book file name), which need to be the same when resuming
+- the number of games played so far, the first player, vorfuehrung, the players' compulsory solos, the players' points and the random number generator for dealing
+- the size of the game log (if any) after the last game, such that records of games played after the checkpoint can be discarded
+- the state every player keeps from game to game (see Player::write_checkpoint())
+
+Integers are stored with four bytes, random number generators with their number of 64 bit values followed by the values. A checkpoint of a session with xoshiro generators only takes a few hundred bytes.
+
+CheckpointWriter::save() writes the checkpoint to a temporary file and then renames it, which atomically replaces the previous checkpoint: if the session is interrupted while writing, the previous checkpoint stays complete.
+*/
+
+class CheckpointWriter {
+private:
+    std::vector<unsigned char> bytes;
+public:
+    CheckpointWriter();
+    void write_int(int value);
+    void write_bool(bool value);
+    void write_uint64(uint64_t value);
+    void write_rng(const RandomNumberGenerator &rng);
+    void save(const std::string &filename) const; // terminates the program if the file cannot be written
+};
+
+class CheckpointReader {
+private:
+    std::string filename;
+    std::vector<unsigned char> bytes;
+    size_t position;
+    unsigned char next_byte();
+public:
+    explicit CheckpointReader(const std::string &filename); // terminates the program if the file is not a checkpoint
+    int read_int();
+    bool read_bool();
+    uint64_t read_uint64();
+    void read_rng(RandomNumberGenerator &rng);
+    void check_end() const;
+    void exit_with_invalid_checkpoint(const std::string &reason) const;
+};
+
+#endif
@@ -0,0 +1,44 @@
+/*
+  doko is a C++ doppelkopf program with an integrated UCT player.
+  Copyright (c) 2011-2016 Silvan Sievers
+  For questions, please write to: silvan.sievers@unibas.ch
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef DOKO_H
+#define DOKO_H
+
+#include "belief_game_state.h"
+#include "cards.h"
+#include "logging.h"
+#include "move.h"
+#include "options.h"
+#include "server.h"
+#include "session.h"
+#include "uct.h"
+
+/**
+The public header of the doko library, which contains the whole engine except for the command line interface of main.cpp. A program embedding the engine calls initialize_doko() once and can then:
+- play a whole session (Session, see main.cpp for the meaning of the Options)
+- construct positions from the point of view of a player (BeliefGameState, which can be serialized to exchange positions with other programs)
+- search the best move of the player to move in such a position (Uct), as the uct player does
+- answer search requests of other programs (run_server())
+- choose which output is written and where to (see logging.h)
+Several positions may be searched at the same time in different threads as long as every search uses its own BeliefGameState and Options and the log of Uct is turned off.
+*/
+
+void initialize_doko(); // sets up the tables shared by all threads, must be called before using the library
+
+#endif
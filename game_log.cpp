@@ -0,0 +1,257 @@
+/*
+  doko is a C++ doppelkopf program with an integrated UCT player.
+  Copyright (c) 2011-2016 Silvan Sievers
+  For questions, please write to: silvan.sievers@unibas.ch
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "game_log.h"
+
+#include "belief_game_state.h"
+#include "game_type.h"
+#include "timer.h"
+
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <unistd.h>
+
+using namespace std;
+
+static const char GAME_LOG_MAGIC[8] = { 'D', 'O', 'K', 'O', 'L', 'O', 'G', '1' };
+static const int GAME_LOG_FORMAT_VERSION = 1;
+static const int RECORD_FIXED_SIZE = 24; // all fields of a record up to and including the number of moves
+
+static void exit_with_invalid_log(const string &filename, const string &reason) {
+    cerr << "could not use game log " << filename << ": " << reason << endl;
+    exit(2);
+}
+
+GameLogWriter::GameLogWriter(const Options &options, const string &filename_)
+    : file(filename_.c_str(), ios::binary), filename(filename_) {
+    GameLogHeader header;
+    memcpy(header.magic, GAME_LOG_MAGIC, sizeof(GAME_LOG_MAGIC));
+    header.format_version = GAME_LOG_FORMAT_VERSION;
+    header.no_solo = options.solo_disabled();
+    header.compulsory_solo = options.use_compulsory_solo();
+    header.announcing_version = options.get_announcing_version();
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.flush();
+    if (!file) {
+        cerr << "could not write game log " << filename << endl;
+        exit(2);
+    }
+    for (int i = 0; i < 4; ++i)
+        players_types[i] = options.get_players_types()[i];
+}
+
+GameLogWriter::GameLogWriter(const Options &options, const string &filename_, uint64_t size) : filename(filename_) {
+    ifstream existing_file(filename.c_str(), ios::binary | ios::ate);
+    if (!existing_file || static_cast<uint64_t>(existing_file.tellg()) < size || size < sizeof(GameLogHeader))
+        exit_with_invalid_log(filename, "shorter than recorded in the checkpoint");
+    existing_file.close();
+    if (truncate(filename.c_str(), size) != 0)
+        exit_with_invalid_log(filename, "cannot truncate file");
+    file.open(filename.c_str(), ios::binary | ios::app | ios::ate);
+    if (!file) {
+        cerr << "could not write game log " << filename << endl;
+        exit(2);
+    }
+    for (int i = 0; i < 4; ++i)
+        players_types[i] = options.get_players_types()[i];
+}
+
+uint64_t GameLogWriter::get_size() {
+    return file.tellp();
+}
+
+void GameLogWriter::start_game(int first_player, bool vorfuehrung, const bool played_compulsory_solo[4], const Cards cards[4]) {
+    record.first_player = first_player;
+    record.vorfuehrung = vorfuehrung;
+    for (int i = 0; i < 4; ++i) {
+        record.played_compulsory_solo[i] = played_compulsory_solo[i];
+        record.players_types[i] = players_types[i];
+        record.cards[i] = cards[i];
+    }
+    record.players.clear();
+    record.moves.clear();
+}
+
+void GameLogWriter::add_move(int player, const Move &move) {
+    record.players.push_back(player);
+    record.moves.push_back(move);
+}
+
+void GameLogWriter::finish_game(const int score_points[4]) {
+    int number_of_moves = record.moves.size();
+    assert(number_of_moves < (1 << 16));
+    buffer.assign(RECORD_FIXED_SIZE + number_of_moves + (number_of_moves + 3) / 4, 0);
+    buffer[0] = record.first_player | (record.vorfuehrung << 2);
+    for (int i = 0; i < 4; ++i) {
+        buffer[0] |= record.played_compulsory_solo[i] << (3 + i);
+        buffer[1] |= players_types[i] << (2 * i);
+    }
+    for (int i = 0; i < 48; ++i) {
+        int owner = 0;
+        while (!record.cards[owner].contains_card(Card(i))) {
+            ++owner;
+            assert(owner < 4);
+        }
+        buffer[2 + i / 4] |= owner << (2 * (i % 4));
+    }
+    for (int i = 0; i < 4; ++i) {
+        unsigned int points = static_cast<unsigned short>(score_points[i]);
+        buffer[14 + 2 * i] = points & 0xff;
+        buffer[15 + 2 * i] = points >> 8;
+    }
+    buffer[22] = number_of_moves & 0xff;
+    buffer[23] = number_of_moves >> 8;
+    for (int i = 0; i < number_of_moves; ++i) {
+        buffer[RECORD_FIXED_SIZE + i] = record.moves[i].get_id();
+        buffer[RECORD_FIXED_SIZE + number_of_moves + i / 4] |= record.players[i] << (2 * (i % 4));
+    }
+    // flushing after every game keeps the log complete if the session is interrupted and costs one system call per game
+    file.write(reinterpret_cast<const char *>(buffer.data()), buffer.size());
+    file.flush();
+    if (!file) {
+        cerr << "could not write game log " << filename << endl;
+        exit(2);
+    }
+}
+
+GameLogReader::GameLogReader(const string &filename_) : file(filename_.c_str(), ios::binary), filename(filename_) {
+    if (!file)
+        exit_with_invalid_log(filename, "cannot open file");
+    file.read(reinterpret_cast<char *>(&header), sizeof(header));
+    if (file.gcount() != sizeof(header) || memcmp(header.magic, GAME_LOG_MAGIC, sizeof(GAME_LOG_MAGIC)) != 0)
+        exit_with_invalid_log(filename, "not a game log");
+    if (header.format_version != GAME_LOG_FORMAT_VERSION)
+        exit_with_invalid_log(filename, "unsupported format version");
+}
+
+bool GameLogReader::read_game(GameRecord &record) {
+    buffer.resize(RECORD_FIXED_SIZE);
+    file.read(reinterpret_cast<char *>(buffer.data()), RECORD_FIXED_SIZE);
+    if (file.gcount() == 0)
+        return false;
+    if (file.gcount() != RECORD_FIXED_SIZE)
+        exit_with_invalid_log(filename, "truncated game record");
+    record.first_player = buffer[0] & 3;
+    record.vorfuehrung = (buffer[0] >> 2) & 1;
+    for (int i = 0; i < 4; ++i) {
+        record.played_compulsory_solo[i] = (buffer[0] >> (3 + i)) & 1;
+        record.players_types[i] = static_cast<player_t>((buffer[1] >> (2 * i)) & 3);
+        record.cards[i] = Cards();
+    }
+    for (int i = 0; i < 48; ++i)
+        record.cards[(buffer[2 + i / 4] >> (2 * (i % 4))) & 3].add_card(Card(i));
+    for (int i = 0; i < 4; ++i)
+        record.score_points[i] = static_cast<short>(buffer[14 + 2 * i] | (buffer[15 + 2 * i] << 8));
+    int number_of_moves = buffer[22] | (buffer[23] << 8);
+    int moves_size = number_of_moves + (number_of_moves + 3) / 4;
+    buffer.resize(moves_size);
+    file.read(reinterpret_cast<char *>(buffer.data()), moves_size);
+    if (file.gcount() != moves_size)
+        exit_with_invalid_log(filename, "truncated game record");
+    record.players.resize(number_of_moves);
+    record.moves.resize(number_of_moves);
+    for (int i = 0; i < number_of_moves; ++i) {
+        if (buffer[i] >= NUM_MOVE_IDS)
+            exit_with_invalid_log(filename, "invalid move");
+        record.moves[i] = Move::from_id(buffer[i]);
+        record.players[i] = (buffer[number_of_moves + i / 4] >> (2 * (i % 4))) & 3;
+    }
+    return true;
+}
+
+string replay_game(const Options &options, const GameRecord &record, int &game_type) {
+    BeliefGameState state(options, 0, record.played_compulsory_solo, record.vorfuehrung, record.first_player,
+                          record.cards[0]);
+    state.set_uct_output(false);
+    Cards other_players_cards[4] = { Cards(), record.cards[1], record.cards[2], record.cards[3] };
+    state.set_other_players_cards(other_players_cards);
+    vector<Move> legal_moves;
+    for (size_t i = 0; i < record.moves.size(); ++i) {
+        // every move is checked before setting it because BeliefGameState asserts that it is legal
+        const Move &move = record.moves[i];
+        bool legal_move;
+        if (state.game_finished()) {
+            legal_move = false;
+        } else if (options.solo_disabled() && move.is_game_type_move()) {
+            // without solos, the marriage player announces the marriage out of turn (see BeliefGameState::set_move)
+            legal_move = i == 0 && move.get_id() == Move(&marriage).get_id() && state.has_both_queens_of_clubs(record.players[i]);
+        } else {
+            legal_moves.clear();
+            state.get_legal_moves(legal_moves);
+            legal_move = false;
+            for (size_t j = 0; j < legal_moves.size(); ++j) {
+                // ids rather than operator== because the team of an announcement needs to be the announcing player's one
+                if (legal_moves[j].get_id() == move.get_id())
+                    legal_move = true;
+            }
+            legal_move = legal_move && state.get_player_to_move() == record.players[i];
+        }
+        if (!legal_move)
+            return "move " + to_string(i) + " cannot be replayed";
+        state.set_move(record.players[i], move);
+    }
+    if (!state.game_finished())
+        return "the game is not finished";
+    int score_points[4] = { 0, 0, 0, 0 };
+    state.get_score_points(score_points);
+    for (int i = 0; i < 4; ++i) {
+        if (score_points[i] != record.score_points[i])
+            return "the score points do not match";
+    }
+    game_type = state.get_game_type()->get_index();
+    return "";
+}
+
+void replay_game_log(const string &filename) {
+    Timer timer;
+    GameLogReader reader(filename);
+    const GameLogHeader &header = reader.get_header();
+    // only the options stored in the header influence the course of a game
+    vector<player_t> players_types(4, RANDOM);
+    vector<vector<int> > players_options(4);
+    Options options(1, header.no_solo, header.compulsory_solo, players_types, true, 0, XOSHIRO, false, false, false, false,
+                    players_options, false, header.announcing_version, "", "");
+    vector<int> game_type_counts(GameType::NUMBER_OF_GAME_TYPES, 0);
+    long players_points[4] = { 0, 0, 0, 0 };
+    long number_of_moves = 0;
+    int number_of_games = 0;
+    GameRecord record;
+    while (reader.read_game(record)) {
+        int game_type = 0;
+        string error = replay_game(options, record, game_type);
+        if (!error.empty())
+            exit_with_invalid_log(filename, "game " + to_string(number_of_games) + ": " + error);
+        for (int i = 0; i < 4; ++i)
+            players_points[i] += record.score_points[i];
+        ++game_type_counts[game_type];
+        number_of_moves += record.moves.size();
+        ++number_of_games;
+    }
+
+    cout << "replayed " << number_of_games << " games (" << number_of_moves << " moves) in " << timer() << "s" << endl;
+    for (int i = 0; i < GameType::NUMBER_OF_GAME_TYPES; ++i) {
+        if (game_type_counts[i] > 0)
+            cout << *GameType::from_index(i) << ": " << game_type_counts[i] << endl;
+    }
+    cout << "accumulated points:" << endl;
+    for (int i = 0; i < 4; ++i)
+        cout << "player " << i << ": " << players_points[i] << endl;
+}
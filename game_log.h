@@ -0,0 +1,102 @@
+/*
+  doko is a C++ doppelkopf program with an integrated UCT player.
+  Copyright (c) 2011-2016 Silvan Sievers
+  For questions, please write to: silvan.sievers@unibas.ch
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAME_LOG_H
+#define GAME_LOG_H
+
+#include "cards.h"
+#include "move.h"
+#include "options.h"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+A game log is a binary file recording the games of a session for offline analysis. It consists of a header with the session options which influence the course of a game (see GameLogHeader) followed by one record per game, which is written as soon as the game is finished, i.e. a log of an interrupted session contains all games finished so far.
+
+A record stores (all numbers in little endian byte order):
+- 1 byte: the first player of the game (bits 0-1), whether the game is a vorfuehrung (bit 2) and which players already played their compulsory solo before the game (bits 3-6)
+- 1 byte: the players' types (two bits per player)
+- 12 bytes: the deal, i.e. the player holding each of the 48 cards (two bits per card, ordered by card index)
+- 8 bytes: the score points of every player (signed 16 bit numbers)
+- 2 bytes: the number of moves
+- the ids of the moves (one byte per move, see Move::get_id()), in the order in which ActualGameState asked the players for them
+- the players who made the moves (two bits per move, rounded up to full bytes)
+
+A typical game thus needs about 100 bytes. GameLogReader reads the records one after another without replaying any player; replay_game_log() additionally reconstructs every game from its moves.
+*/
+
+struct GameLogHeader {
+    char magic[8];
+    unsigned char format_version;
+    unsigned char no_solo;
+    unsigned char compulsory_solo;
+    unsigned char announcing_version;
+};
+
+struct GameRecord {
+    int first_player;
+    bool vorfuehrung;
+    bool played_compulsory_solo[4]; // before the game
+    player_t players_types[4];
+    Cards cards[4];
+    int score_points[4];
+    std::vector<int> players; // the player who made each move
+    std::vector<Move> moves;
+};
+
+class GameLogWriter {
+private:
+    std::ofstream file;
+    std::string filename;
+    player_t players_types[4];
+    GameRecord record; // of the current game, reused to avoid allocations
+    std::vector<unsigned char> buffer; // the encoded record, reused to avoid allocations
+public:
+    GameLogWriter(const Options &options, const std::string &filename); // terminates the program if the file cannot be written
+    GameLogWriter(const Options &options, const std::string &filename, uint64_t size); // continues the log of a resumed session after its first size bytes, discarding the games played after the checkpoint (see Session)
+    uint64_t get_size(); // added for checkpoints
+    void start_game(int first_player, bool vorfuehrung, const bool played_compulsory_solo[4], const Cards cards[4]);
+    void add_move(int player, const Move &move);
+    void finish_game(const int score_points[4]); // writes the record of the game
+};
+
+class GameLogReader {
+private:
+    std::ifstream file;
+    std::string filename;
+    GameLogHeader header;
+    std::vector<unsigned char> buffer;
+public:
+    explicit GameLogReader(const std::string &filename); // terminates the program if the file is not a valid game log
+    const GameLogHeader &get_header() const {
+        return header;
+    }
+    bool read_game(GameRecord &record); // returns false if there are no more games
+};
+
+/* replays the moves of record with a BeliefGameState with complete information, checking that every move is legal before making it and that the moves lead to the recorded score points. returns an empty string and sets game_type to the index of the game type of the game (see GameType::get_index()) if this is the case and the reason why the game cannot be replayed otherwise */
+std::string replay_game(const Options &options, const GameRecord &record, int &game_type);
+
+/* reads all games of the log, replays them (see replay_game()) and prints some statistics */
+void replay_game_log(const std::string &filename);
+
+#endif
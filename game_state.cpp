@@ -20,21 +20,21 @@
 #include "game_state.h"
 
 #include "game_type.h"
+#include "logging.h"
 #include "options.h"
 
-#include <iostream>
+#include <ostream>
 
 using namespace std;
 
 GameState::GameState(const Options &options_, bool session_instance_)
-    : options(options_), game_type(0), session_instance(session_instance_), player_played_queen_of_clubs(-1),
+    : options(options_), game_type(0), number_of_tricks(0), session_instance(session_instance_), player_played_queen_of_clubs(-1),
     teams_are_known(false), solo_or_marriage_player(-1), compulsory_solo(false), number_of_clarification_trick(-1) {
     for (int i = 0; i < 4; ++i) {
         players_team[i] = -1;
         players_latest_moment_for_announcement[i] = 11;
         players_known_team[i] = -1;
     }
-    tricks.reserve(12);
     for (int i = 0; i < 2; ++i) {
         announcements[i] = NONE;
         first_announcement_in_time[i] = false;
@@ -43,7 +43,7 @@ GameState::GameState(const Options &options_, bool session_instance_)
 }
 
 bool GameState::game_finished() const {
-    return (tricks.size() == 12 && tricks.back().completed());
+    return (number_of_tricks == 12 && get_current_trick().completed());
 }
 
 int GameState::corrected_number_of_cards(int number) const {
@@ -319,18 +319,18 @@ int GameState::update(int player, Card card) {
         }
     }
     cards[player].remove_card(card);
-    tricks.back().set_card(player, card);
-    if (tricks.back().completed() && tricks.size() != 12) {
-        player = tricks.back().taken_by();
-        if (*game_type == marriage && number_of_clarification_trick == -1 && tricks.size() <= 3) { // clarification trick not made yet
+    get_current_trick().set_card(player, card);
+    if (get_current_trick().completed() && number_of_tricks != 12) {
+        player = get_current_trick().taken_by();
+        if (*game_type == marriage && number_of_clarification_trick == -1 && number_of_tricks <= 3) { // clarification trick not made yet
             if (player != solo_or_marriage_player) { // found marriage partner
-                number_of_clarification_trick = tricks.size() - 1;
+                number_of_clarification_trick = number_of_tricks - 1;
                 set_latest_moment_for_announcements();
                 teams_are_known = true;
                 players_known_team[player] = 1;
                 players_team[player] = 1;
             } else {
-                if (tricks.size() == 3) { // no marriage partner found
+                if (number_of_tricks == 3) { // no marriage partner found
                     number_of_clarification_trick = 2;
                     set_latest_moment_for_announcements();
                     teams_are_known = true;
@@ -338,7 +338,7 @@ int GameState::update(int player, Card card) {
                 }
             }
         }
-        tricks.push_back(Trick(game_type, player));
+        add_trick(player);
     } else {
         player = next_player(player);
     }
@@ -357,8 +357,9 @@ void GameState::assign_solo_player_to_re_team(int player) {
     teams_are_known = true;
 }
 
-void GameState::get_points_and_special_points(int points[4], int &special_points_for_re, bool black[2], int count_re_players) const {
-    for (size_t i = 0; i < tricks.size(); ++i) {
+void GameState::get_points_and_special_points(int points[4], int &special_points_for_re, bool black[2], int count_re_players,
+                                              int number_of_completed_tricks) const {
+    for (int i = 0; i < number_of_completed_tricks; ++i) {
         // NOTE: Trick::taken_by() is being calculated twice for all tricks; once during the game and once in this method for counting points and special points
         int trick_taken_by = tricks[i].taken_by();
         if (black[0] && !players_team[trick_taken_by]) // kontra still has no trick but now made one
@@ -372,7 +373,7 @@ void GameState::get_points_and_special_points(int points[4], int &special_points
         if (count_re_players == 2) {
             assert(*game_type == regular || *game_type == marriage);
             int special_points_for_trick_winner = tricks[i].get_special_points_for_trick_winner(
-                session_instance, players_team, trick_taken_by, trick_value, i == tricks.size() - 1);
+                session_instance && log_enabled(LOG_GAME, LOG_INFO), players_team, trick_taken_by, trick_value, i == 11);
             if (players_team[trick_taken_by])
                 special_points_for_re += special_points_for_trick_winner;
             else
@@ -381,7 +382,7 @@ void GameState::get_points_and_special_points(int points[4], int &special_points
     }
 }
 
-bool GameState::has_team_lost(bool re_team, int points, const bool black[2]) const {
+bool _has_team_lost(const announcement_t announcements[2], bool re_team, int points, const bool black[2]) {
     if ((announcements[re_team] == SCHWARZ && !black[!re_team]) // team announced black and did not get all tricks
         || (announcements[re_team] == N30 && points <= 210) // team announced no 30 and reached less than 211 points
         || (announcements[re_team] == N60 && points <= 180) // team announced no 60 and reached less than 181 points
@@ -412,6 +413,10 @@ bool GameState::has_team_lost(bool re_team, int points, const bool black[2]) con
     return false;
 }
 
+bool GameState::has_team_lost(bool re_team, int points, const bool black[2]) const {
+    return _has_team_lost(announcements, re_team, points, black);
+}
+
 int GameState::get_team_score_points(bool re_team, int points, const bool black[2]) const {
     int score_points = 0;
     if (black[!re_team]) // other team is black
@@ -474,15 +479,22 @@ void GameState::get_score_points(int *players_score_points, int *players_points,
     int points[4] = { 0, 0, 0, 0 };
     int special_points_for_re = 0;
     bool black[2] = { true, true };
-    get_points_and_special_points(points, special_points_for_re, black, count_re_players);
+    get_points_and_special_points(points, special_points_for_re, black, count_re_players, number_of_tricks);
+    set_score_points(points, special_points_for_re, black, count_re_players, players_score_points, players_points,
+                     team_points);
+}
+
+void GameState::set_score_points(const int points[4], int special_points_for_re, const bool black[2], int count_re_players,
+                                 int *players_score_points, int *players_points, int *team_points) const {
+    bool dump = session_instance && log_enabled(LOG_GAME, LOG_INFO);
     int points_re = 0;
     int points_kontra = 0;
 
-    if (session_instance)
-        cout << "players' playing points:" << endl;
+    if (dump)
+        log_stream() << "players' playing points:\n";
     for (int i = 0; i < 4; ++i) {
-        if (session_instance)
-            cout << i << ": " << points[i] << endl;
+        if (dump)
+            log_stream() << i << ": " << points[i] << '\n';
         if (players_points != 0)
             players_points[i] = points[i];
         if (players_team[i] == 1)
@@ -495,17 +507,17 @@ void GameState::get_score_points(int *players_score_points, int *players_points,
         team_points[1] = points_re;
     }
     assert(points_re + points_kontra == 240);
-    if (session_instance)  {
-        cout << "re: " << points_re << " kontra: " << points_kontra << endl;
+    if (dump) {
+        log_stream() << "re: " << points_re << " kontra: " << points_kontra << '\n';
         if (count_re_players == 2) {
-            cout << "\nspecial points:" << endl;
-            cout << "re: " << special_points_for_re << endl;
-            cout << "kontra: " << -special_points_for_re << endl;
+            log_stream() << "\nspecial points:\n";
+            log_stream() << "re: " << special_points_for_re << '\n';
+            log_stream() << "kontra: " << -special_points_for_re << '\n';
         }
 
-        cout << "\nannouncements:" << endl;
-        cout << "re: " << announcements[1] << endl;
-        cout << "kontra: " << announcements[0] << endl << endl;
+        log_stream() << "\nannouncements:\n";
+        log_stream() << "re: " << announcements[1] << '\n';
+        log_stream() << "kontra: " << announcements[0] << "\n\n";
     }
 
     if (black[0])
@@ -522,38 +534,38 @@ void GameState::get_score_points(int *players_score_points, int *players_points,
         score_points_for_re -= get_winning_team_score_points(false, points_kontra, black);
         if (count_re_players == 2) // won against the elders
             --score_points_for_re;
-        if (session_instance)
-            cout << "kontra has won. score points for re: " << score_points_for_re << endl;
+        if (dump)
+            log_stream() << "kontra has won. score points for re: " << score_points_for_re << '\n';
     } else if (!re_lost && kontra_lost) {
         score_points_for_re += get_team_score_points(true, points_re, black);
         score_points_for_re += get_winning_team_score_points(true, points_re, black);
-        if (session_instance)
-            cout << "re has won. score points for re: " << score_points_for_re << endl;
+        if (dump)
+            log_stream() << "re has won. score points for re: " << score_points_for_re << '\n';
     } else if (re_lost && kontra_lost) {
         int points_for_re = get_team_score_points(true, points_re, black);
         int points_for_kontra = get_team_score_points(false, points_kontra, black);
         score_points_for_re += points_for_re;
         score_points_for_re -= points_for_kontra;
-        if (session_instance)  {
-            cout << "nobody won: " << endl;
-            cout << "score points for re: " << points_for_re << endl;
-            cout << "score points for kontra: " << points_for_kontra << endl;
-            cout << "in total: score points for re: " << score_points_for_re << endl;
+        if (dump) {
+            log_stream() << "nobody won: \n";
+            log_stream() << "score points for re: " << points_for_re << '\n';
+            log_stream() << "score points for kontra: " << points_for_kontra << '\n';
+            log_stream() << "in total: score points for re: " << score_points_for_re << '\n';
         }
     } else {
-        if (session_instance)
-            cout << "both teams did not lose, this cannot happen" << endl;
+        if (dump)
+            log_stream() << "both teams did not lose, this cannot happen\n";
         assert(false);
     }
 
     if (count_re_players == 2) {
         score_points_for_re += special_points_for_re;
-        if (session_instance)
-            cout << "adding up special points. final score points for re: " << score_points_for_re << endl;
+        if (dump)
+            log_stream() << "adding up special points. final score points for re: " << score_points_for_re << '\n';
     } else { // any kind of solo (including failed marriage or "secret solo" (having two queens of clubs))
         assert(special_points_for_re == 0); // no special points have been calculated!
-        if (session_instance)
-            cout << "multiplying by 3 for the solo player. final score points for re: " << 3 * score_points_for_re << endl;
+        if (dump)
+            log_stream() << "multiplying by 3 for the solo player. final score points for re: " << 3 * score_points_for_re << '\n';
     }
     for (int i = 0; i < 4; ++i) {
         if (players_team[i] == 1)
@@ -563,6 +575,76 @@ void GameState::get_score_points(int *players_score_points, int *players_points,
     }
 }
 
-/*bool _has_team_lost(const announcement_t announcements[2], bool re_team, int points, const bool black[2]) {
-    // has been moved back to has_team_lost as the target "test" of the Makefile is not used anymore
-}*/
+int GameState::get_number_of_completed_tricks() const {
+    if (number_of_tricks == 0)
+        return 0;
+    return get_current_trick().completed() ? number_of_tricks : number_of_tricks - 1;
+}
+
+bool GameState::score_points_can_be_estimated() const {
+    if (game_type == 0 || number_of_tricks == 0 || !get_current_trick().empty())
+        return false;
+    // as long as the marriage player may still find a partner, the teams are not known
+    return *game_type != marriage || number_of_clarification_trick != -1 || get_number_of_completed_tricks() >= 3;
+}
+
+int GameState::get_card_strength(Card card) const {
+    // trumps are the stronger the higher they rank (rank 1 is the highest), non trump aces and tens are likely to win a trick of their suit
+    if (game_type->is_trump(card))
+        return 24 - game_type->get_trump_rank(card);
+    unsigned int rank = game_type->get_non_trump_rank(card);
+    if (rank == 1)
+        return 10;
+    if (rank == 2)
+        return 4;
+    return 1;
+}
+
+void GameState::get_estimated_score_points(int *players_score_points, int *players_points, int *team_points) const {
+    assert(score_points_can_be_estimated());
+    int count_re_players = 0;
+    for (int i = 0; i < 4; ++i)
+        if (players_team[i] == 1)
+            ++count_re_players;
+
+    int points[4] = { 0, 0, 0, 0 };
+    int special_points_for_re = 0;
+    bool black[2] = { true, true };
+    int number_of_completed_tricks = get_number_of_completed_tricks();
+    get_points_and_special_points(points, special_points_for_re, black, count_re_players, number_of_completed_tricks);
+
+    // distribute the points of the cards remaining on the players' hands according to the strength of their hands
+    int remaining_points = 240;
+    int strength[4] = { 0, 0, 0, 0 };
+    int total_strength = 0;
+    for (int i = 0; i < 4; ++i) {
+        remaining_points -= points[i];
+        // iterate over the bitmask directly instead of allocating a vector of single cards, this is called at the end of every truncated rollout
+        Cards remaining_cards = cards[i];
+        while (!remaining_cards.empty()) {
+            Card card = remaining_cards.get_first_card();
+            remaining_cards.remove_card(card);
+            strength[i] += get_card_strength(card);
+        }
+        total_strength += strength[i];
+    }
+    assert(total_strength > 0);
+    int distributed_points = 0;
+    for (int i = 0; i < 3; ++i) {
+        int estimated_points = remaining_points * strength[i] / total_strength;
+        points[i] += estimated_points;
+        distributed_points += estimated_points;
+    }
+    points[3] += remaining_points - distributed_points;
+
+    int points_re = 0;
+    for (int i = 0; i < 4; ++i) {
+        if (players_team[i] == 1)
+            points_re += points[i];
+    }
+    // a team only stays black if it is estimated to make no points at all
+    black[0] = black[0] && points_re == 240;
+    black[1] = black[1] && points_re == 0;
+    set_score_points(points, special_points_for_re, black, count_re_players, players_score_points, players_points,
+                     team_points);
+}
@@ -89,7 +89,8 @@ protected:
     Cards cards[4];
     const GameType *game_type;
     int players_team[4]; // saves for each player whether he is part of the re team (1) or the kontra team (0) (uninitialized: -1)
-    std::vector<Trick> tricks; // all tricks that have been played
+    Trick tricks[12]; // all tricks that have been played. stored inline rather than in a vector so that copying a state (done for every rollout in Uct) needs no heap allocation
+    int number_of_tricks;
     bool session_instance; // to know if players' teams need to be assigned (or asserted because it is already known or because the session instance of gamestate knows the true card distribution) when somebody announces something or plays a queen of clubs
     int player_played_queen_of_clubs; // initialized: -1, after the first queen of clubs was played, stores the player who played it. needed to find out if the same plays the second queen of clubs too, in which case all other players must be kontra players (regular game only)
 
@@ -118,11 +119,24 @@ protected:
     void set_latest_moment_for_announcements(); // only called in case of marriage after the clearification trick
     void get_legal_announcements_for_player(int player, std::vector<Move> &legal_announcements) const;
     int update(int player, Card card); // set the card played by splayer and returns the player who is next
+    void add_trick(int first_player) {
+        assert(number_of_tricks < 12);
+        tricks[number_of_tricks++] = Trick(game_type, first_player);
+    }
+    Trick &get_current_trick() {
+        assert(number_of_tricks > 0);
+        return tricks[number_of_tricks - 1];
+    }
     void assign_solo_player_to_re_team(int player);
 
     // after game end: points calculation
     /* computes all points and special points made during the game (iterates over all tricks). also computes whether one team was played black or not. the argument count_re_players serves to determine whether special points must be computed or not. */
-    void get_points_and_special_points(int points[4], int &special_points_for_re, bool black[2], int count_re_players) const;
+    void get_points_and_special_points(int points[4], int &special_points_for_re, bool black[2], int count_re_players,
+                                       int number_of_completed_tricks) const;
+    /* computes the score points (and optionally the players' and teams' points) from the points made by every player (see get_score_points) */
+    void set_score_points(const int points[4], int special_points_for_re, const bool black[2], int count_re_players,
+                          int *players_score_points, int *players_points, int *team_points) const;
+    int get_card_strength(Card card) const; // estimates the contribution of a card to winning tricks, used by get_estimated_score_points
     bool has_team_lost(bool re_team, int points, const bool black[2]) const;
     int get_team_score_points(bool re_team, int points, const bool black[2]) const; // computes score points that will always be distributed, independent of who (or if one team) won. therefore called for both teams.
     int get_winning_team_score_points(bool re_team, int points, const bool black[2]) const; // computes score points that will be granted for the winning team only
@@ -130,6 +144,10 @@ public:
     GameState(const Options &options, bool session_instance);
     bool game_finished() const; // changed to public for Uct
     void get_score_points(int *players_score_points, int *players_points = 0, int *team_points = 0) const; // computes the final score points made by each player. players_points needed by Uct to not only get the score points, but also the points players made during the game. furthermore, if player_points = 0 (the case when Session uses GameState), the score points etc are printed to standard out
+    int get_number_of_completed_tricks() const; // added for Uct
+    bool score_points_can_be_estimated() const; // true between two tricks (after the teams of a marriage have been determined), added for Uct
+    /* like get_score_points, but for an unfinished game: the playing points of the cards remaining on the players' hands are distributed according to the strength of the hands (trumps and high cards) and the resulting playing points are scored like a finished game, i.e. including announcements and special points of completed tricks. added for Uct to truncate rollouts */
+    void get_estimated_score_points(int *players_score_points, int *players_points = 0, int *team_points = 0) const;
     bool is_compulsory_solo() const {
         return compulsory_solo;
     }
@@ -137,13 +155,31 @@ public:
         assert(is_compulsory_solo() && solo_or_marriage_player != -1);
         return solo_or_marriage_player;
     }
+    const GameType *get_game_type() const { // added for replay_game_log
+        return game_type;
+    }
+    bool are_teams_known() const { // added for testing BeliefGameState::merge_equivalent_cards
+        return teams_are_known;
+    }
+    int get_players_known_team(int player) const { // -1 as long as not every player knows the team of player. added for testing BeliefGameState::merge_equivalent_cards
+        return players_known_team[player];
+    }
+    // made public for the reference implementations of reference.h
+    const Trick &get_current_trick() const {
+        assert(number_of_tricks > 0);
+        return tricks[number_of_tricks - 1];
+    }
+    Cards get_remaining_cards(int player) const {
+        return cards[player];
+    }
     int get_players_team(int player) const { // needed by Uct to compute team points
         assert(players_team[player] != -1);
-        assert(players_known_team[player] != -1);
+        assert(players_known_team[player] != -1 || !game_finished()); // the teams of a truncated rollout need not be known to all players yet
         return players_team[player];
     }
 };
 
-//extern bool _has_team_lost(const announcement_t announcements[2], bool re_team, int points, const bool black[2]);
+// the rules deciding whether a team lost, independently of a GameState so that test.cpp can check them
+bool _has_team_lost(const announcement_t announcements[2], bool re_team, int points, const bool black[2]);
 
 #endif
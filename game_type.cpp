@@ -19,169 +19,151 @@
 
 #include "game_type.h"
 
+#include <algorithm>
+
 using namespace std;
 
+/*
+Compile time tables: the suit and the rank of a card only depend on the game type and on the index of the card (see Card), thus they are computed by constexpr functions into one table per game type, together with the cards of every suit as masks. The constructor selects the tables of its game type once, all accessors of GameType (including the evaluation of tricks and the generation of legal cards) read them without any further dispatch on the game type.
+The tables must agree with the rules as implemented originally, which is checked for all tricks encountered in random games by test.cpp (see taken_by_reference() in reference.h).
+*/
+
+namespace {
+const int TRUMP = GameType::TRUMP;
+enum card_kind {
+    NINE,
+    KING,
+    TEN,
+    ACE,
+    JACK,
+    QUEEN
+};
+
+constexpr int get_color(int index) {
+    return index < 6 ? 1 : index < 14 ? 2 : index < 22 ? 3 : index < 30 ? 0 : index < 38 ? (index - 30) / 2
+        : index < 46 ? (index - 38) / 2 : 1;
+}
+
+constexpr int get_kind(int index) {
+    return index < 6 ? (index / 2 == 2 ? ACE : index / 2) // no ten of hearts in the hearts suit
+        : index < 30 ? (index - 6) % 8 / 2 : index < 38 ? JACK : index < 46 ? QUEEN : TEN;
+}
+
+constexpr bool is_trump_card(int type, int index) {
+    return type <= GameType::CLUBS_SOLO ? get_kind(index) == JACK || get_kind(index) == QUEEN || index >= 46
+        || get_color(index) == (type <= GameType::DIAMONDS_SOLO ? 0 : type - GameType::HEARTS_SOLO + 1)
+        : type == GameType::JACKS_SOLO ? get_kind(index) == JACK : type == GameType::QUEENS_SOLO && get_kind(index) == QUEEN;
+}
+
+// lower ranks are better, see the constructor
+constexpr int get_trump_rank(int type, int index) {
+    return type == GameType::JACKS_SOLO ? 4 - (index - 30) / 2 : type == GameType::QUEENS_SOLO ? 4 - (index - 38) / 2
+        : index >= 46 ? 1 : get_kind(index) == QUEEN ? 5 - (index - 38) / 2 : get_kind(index) == JACK ? 9 - (index - 30) / 2
+        : get_kind(index) == ACE ? 10 : get_kind(index) == TEN ? 11
+        : (get_kind(index) == KING ? 12 : 13) - (index < 6 ? 1 : 0); // no ten of hearts in the hearts suit
+}
+
+constexpr int get_non_trump_rank(int index) {
+    return get_kind(index) == ACE ? 1 : get_kind(index) == TEN ? 2 : get_kind(index) == KING ? 3
+        : get_kind(index) == QUEEN ? 4 : get_kind(index) == JACK ? 5 : 6;
+}
+
+constexpr int get_suit(int type, int index) {
+    return is_trump_card(type, index) ? TRUMP : get_color(index);
+}
+
+constexpr int get_rank(int type, int index) {
+    return is_trump_card(type, index) ? get_trump_rank(type, index) : get_non_trump_rank(index);
+}
+
+constexpr unsigned long long get_suit_mask(int type, int suit, int index = 0) {
+    return index == 48 ? 0 : (get_suit(type, index) == suit ? 1ULL << index : 0) | get_suit_mask(type, suit, index + 1);
+}
+
+static_assert(get_rank(GameType::REGULAR, 46) == 1 && get_rank(GameType::REGULAR, 44) == 2
+              && get_rank(GameType::REGULAR, 22) == 13 && get_rank(GameType::HEARTS_SOLO, 0) == 12
+              && get_rank(GameType::JACKS_SOLO, 36) == 1 && get_rank(GameType::ACES_SOLO, 4) == 1,
+              "wrong ranks of the compile time tables");
+static_assert(get_suit_mask(GameType::ACES_SOLO, TRUMP) == 0 && get_suit(GameType::JACKS_SOLO, 46) == 1,
+              "wrong suits of the compile time tables");
+
+template<int... indices>
+struct IndexSequence {
+};
+
+template<int n, int... indices>
+struct MakeIndexSequence : MakeIndexSequence<n - 1, n - 1, indices...> {
+};
+
+template<int... indices>
+struct MakeIndexSequence<0, indices...> {
+    typedef IndexSequence<indices...> type;
+};
+
+template<int type, class Indices = MakeIndexSequence<48>::type>
+struct Tables;
+
+template<int type, int... indices>
+struct Tables<type, IndexSequence<indices...> > {
+    static constexpr unsigned char suits[48] = { get_suit(type, indices)... };
+    static constexpr unsigned char ranks[48] = { get_rank(type, indices)... };
+    static constexpr unsigned long long suit_masks[5] = {
+        get_suit_mask(type, 0), get_suit_mask(type, 1), get_suit_mask(type, 2), get_suit_mask(type, 3), get_suit_mask(type, TRUMP)
+    };
+};
+
+template<int type, int... indices>
+constexpr unsigned char Tables<type, IndexSequence<indices...> >::suits[48];
+template<int type, int... indices>
+constexpr unsigned char Tables<type, IndexSequence<indices...> >::ranks[48];
+template<int type, int... indices>
+constexpr unsigned long long Tables<type, IndexSequence<indices...> >::suit_masks[5];
+
+const unsigned char *const suit_tables[GameType::NUMBER_OF_GAME_TYPES] = {
+    Tables<0>::suits, Tables<1>::suits, Tables<2>::suits, Tables<3>::suits, Tables<4>::suits, Tables<5>::suits, Tables<6>::suits,
+    Tables<7>::suits, Tables<8>::suits
+};
+
+const unsigned char *const rank_tables[GameType::NUMBER_OF_GAME_TYPES] = {
+    Tables<0>::ranks, Tables<1>::ranks, Tables<2>::ranks, Tables<3>::ranks, Tables<4>::ranks, Tables<5>::ranks, Tables<6>::ranks,
+    Tables<7>::ranks, Tables<8>::ranks
+};
+
+const unsigned long long *const suit_mask_tables[GameType::NUMBER_OF_GAME_TYPES] = {
+    Tables<0>::suit_masks, Tables<1>::suit_masks, Tables<2>::suit_masks, Tables<3>::suit_masks, Tables<4>::suit_masks,
+    Tables<5>::suit_masks, Tables<6>::suit_masks, Tables<7>::suit_masks, Tables<8>::suit_masks
+};
+}
+
 GameType::GameType(int type_) {
     type = static_cast<game_t>(type_);
-    if (type <= CLUBS_SOLO) { // regular, marriage or color solo => hearts 10s, queens and jacks are trump and there are 3 non trump suits
-        trump_suit.add_cards(hearts10s);
-        card_to_trump_rank[H1.get_index()] = 1;
-        card_to_trump_rank[H1_.get_index()] = 1;
-        trump_suit.add_cards(queens);
-        card_to_trump_rank[CQ.get_index()] = 2;
-        card_to_trump_rank[CQ_.get_index()] = 2;
-        card_to_trump_rank[SQ.get_index()] = 3;
-        card_to_trump_rank[SQ_.get_index()] = 3;
-        card_to_trump_rank[HQ.get_index()] = 4;
-        card_to_trump_rank[HQ_.get_index()] = 4;
-        card_to_trump_rank[DQ.get_index()] = 5;
-        card_to_trump_rank[DQ_.get_index()] = 5;
-        trump_suit.add_cards(jacks);
-        card_to_trump_rank[CJ.get_index()] = 6;
-        card_to_trump_rank[CJ_.get_index()] = 6;
-        card_to_trump_rank[SJ.get_index()] = 7;
-        card_to_trump_rank[SJ_.get_index()] = 7;
-        card_to_trump_rank[HJ.get_index()] = 8;
-        card_to_trump_rank[HJ_.get_index()] = 8;
-        card_to_trump_rank[DJ.get_index()] = 9;
-        card_to_trump_rank[DJ_.get_index()] = 9;
-        non_trump_suits.resize(3);
-        if (type <= DIAMONDS_SOLO) { // regular, marriage or diamonds solo => all with the same trump/non trump suits
-            trump_suit.add_cards(diamonds);
-            card_to_trump_rank[DA.get_index()] = 10;
-            card_to_trump_rank[DA_.get_index()] = 10;
-            card_to_trump_rank[D1.get_index()] = 11;
-            card_to_trump_rank[D1_.get_index()] = 11;
-            card_to_trump_rank[DK.get_index()] = 12;
-            card_to_trump_rank[DK_.get_index()] = 12;
-            card_to_trump_rank[D9.get_index()] = 13;
-            card_to_trump_rank[D9_.get_index()] = 13;
-            non_trump_suits[0] = hearts;
-            non_trump_suits[1] = spades;
-            non_trump_suits[2] = clubs;
-        } else if (type == HEARTS_SOLO) {
-            trump_suit.add_cards(hearts);
-            card_to_trump_rank[HA.get_index()] = 10;
-            card_to_trump_rank[HA_.get_index()] = 10;
-            card_to_trump_rank[HK.get_index()] = 11;
-            card_to_trump_rank[HK_.get_index()] = 11;
-            card_to_trump_rank[H9.get_index()] = 12;
-            card_to_trump_rank[H9_.get_index()] = 12;
-            non_trump_suits[0] = diamonds;
-            non_trump_suits[1] = spades;
-            non_trump_suits[2] = clubs;
-        } else if (type == SPADES_SOLO) {
-            trump_suit.add_cards(spades);
-            card_to_trump_rank[SA.get_index()] = 10;
-            card_to_trump_rank[SA_.get_index()] = 10;
-            card_to_trump_rank[S1.get_index()] = 11;
-            card_to_trump_rank[S1_.get_index()] = 11;
-            card_to_trump_rank[SK.get_index()] = 12;
-            card_to_trump_rank[SK_.get_index()] = 12;
-            card_to_trump_rank[S9.get_index()] = 13;
-            card_to_trump_rank[S9_.get_index()] = 13;
-            non_trump_suits[0] = diamonds;
-            non_trump_suits[1] = hearts;
-            non_trump_suits[2] = clubs;
-        } else if (type == CLUBS_SOLO) {
-            trump_suit.add_cards(clubs);
-            card_to_trump_rank[CA.get_index()] = 10;
-            card_to_trump_rank[CA_.get_index()] = 10;
-            card_to_trump_rank[C1.get_index()] = 11;
-            card_to_trump_rank[C1_.get_index()] = 11;
-            card_to_trump_rank[CK.get_index()] = 12;
-            card_to_trump_rank[CK_.get_index()] = 12;
-            card_to_trump_rank[C9.get_index()] = 13;
-            card_to_trump_rank[C9_.get_index()] = 13;
-            non_trump_suits[0] = diamonds;
-            non_trump_suits[1] = hearts;
-            non_trump_suits[2] = spades;
-        }
-    } else { // jacks, queens or aces solo => all colors (except jacks/queens) are non trump suits
-        non_trump_suits.resize(4);
-        non_trump_suits[0] = diamonds;
-        non_trump_suits[1] = hearts;
-        non_trump_suits[1].add_cards(hearts10s); // include hearts 10s in the hearts suit
-        non_trump_suits[2] = spades;
-        non_trump_suits[3] = clubs;
-        if (type == JACKS_SOLO || type == ACES_SOLO) { // jacks or aces solo => add queens to non trump suits
-            // include all queens to their respective suit
-            non_trump_suits[0].add_card(DQ);
-            non_trump_suits[0].add_card(DQ_);
-            non_trump_suits[1].add_card(HQ);
-            non_trump_suits[1].add_card(HQ_);
-            non_trump_suits[2].add_card(SQ);
-            non_trump_suits[2].add_card(SQ_);
-            non_trump_suits[3].add_card(CQ);
-            non_trump_suits[3].add_card(CQ_);
-            if (type == JACKS_SOLO) {
-                trump_suit.add_cards(jacks);
-                card_to_trump_rank[CJ.get_index()] = 1;
-                card_to_trump_rank[CJ_.get_index()] = 1;
-                card_to_trump_rank[SJ.get_index()] = 2;
-                card_to_trump_rank[SJ_.get_index()] = 2;
-                card_to_trump_rank[HJ.get_index()] = 3;
-                card_to_trump_rank[HJ_.get_index()] = 3;
-                card_to_trump_rank[DJ.get_index()] = 4;
-                card_to_trump_rank[DJ_.get_index()] = 4;
-            }
-        }
-        if (type == QUEENS_SOLO || type == ACES_SOLO) { // queens or aces solo => add jacks to non trump suits
-            // include all jacks to their respective suit
-            non_trump_suits[0].add_card(DJ);
-            non_trump_suits[0].add_card(DJ_);
-            non_trump_suits[1].add_card(HJ);
-            non_trump_suits[1].add_card(HJ_);
-            non_trump_suits[2].add_card(SJ);
-            non_trump_suits[2].add_card(SJ_);
-            non_trump_suits[3].add_card(CJ);
-            non_trump_suits[3].add_card(CJ_);
-            if (type == QUEENS_SOLO) {
-                trump_suit.add_cards(queens);
-                card_to_trump_rank[CQ.get_index()] = 1;
-                card_to_trump_rank[CQ_.get_index()] = 1;
-                card_to_trump_rank[SQ.get_index()] = 2;
-                card_to_trump_rank[SQ_.get_index()] = 2;
-                card_to_trump_rank[HQ.get_index()] = 3;
-                card_to_trump_rank[HQ_.get_index()] = 3;
-                card_to_trump_rank[DQ.get_index()] = 4;
-                card_to_trump_rank[DQ_.get_index()] = 4;
-            }
-        }
-    }
+    suits = suit_tables[type];
+    ranks = rank_tables[type];
+    suit_masks = suit_mask_tables[type];
 
-    // initialize card_to_suit
-    for (int i = 0; i < 48; i++) {
+    // initialize card_to_higher_cards and card_to_not_lower_cards (lower ranks are better)
+    for (int i = 0; i < 48; ++i) {
         Card card(i);
-        if (trump_suit.contains_card(card)) {
-            card_to_suit[card.get_index()] = trump_suit;
-        }
-        else {
-            for (size_t j = 0; j < non_trump_suits.size(); ++j) {
-                if (non_trump_suits[j].contains_card(card)) {
-                    card_to_suit[card.get_index()] = non_trump_suits[j];
-                }
-            }
+        for (int j = 0; j < 48; ++j) {
+            Card other_card(j);
+            if (suits[i] != suits[j])
+                continue;
+            if (get_rank(other_card) < get_rank(card))
+                card_to_higher_cards[i].add_card(other_card);
+            if (get_rank(other_card) <= get_rank(card))
+                card_to_not_lower_cards[i].add_card(other_card);
         }
     }
 }
 
-/* maps a non trump card to its rank in its suit.
-this ranking is the same for all type of games: ace, 10, king, queen, jack, 9 for all colors, where ace has highest rank (i.e. rank 1). if queens or jacks or 10s are in fact non trump cards, then they are included in the trump suit and also in the card_to_trump_rank array.
-this array is being accessed with the help of get_index
-*/
-static const unsigned int card_to_non_trump_rank[48] = {
-    6, 6, 3, 3, 1, 1,
-    6, 6, 3, 3, 2, 2, 1, 1,
-    6, 6, 3, 3, 2, 2, 1, 1,
-    6, 6, 3, 3, 2, 2, 1, 1,
-    5, 5, 5, 5, 5, 5, 5, 5,
-    4, 4, 4, 4, 4, 4, 4, 4,
-    2, 2
-};
-
-unsigned int GameType::get_non_trump_rank(Card card) const {
-    return card_to_non_trump_rank[card.get_index()];
+bool GameType::are_equivalent(Card card1, Card card2, Cards known_cards) const {
+    if (card1.get_value() != card2.get_value() || get_suit_index(card1) != get_suit_index(card2))
+        return false;
+    if (get_rank(card1) > get_rank(card2))
+        swap(card1, card2);
+    // card1 ranks higher or equal than card2. all cards from the rank of card2 up to the rank of card1 need to be known
+    known_cards.add_cards(card_to_higher_cards[card1.get_index()]);
+    return known_cards.contains_cards(card_to_not_lower_cards[card2.get_index()]);
 }
 
 ostream &operator<<(ostream &out, const GameType &game_type) {
@@ -226,3 +208,11 @@ const GameType clubs_solo(5);
 const GameType jacks_solo(6);
 const GameType queens_solo(7);
 const GameType aces_solo(8);
+
+const GameType *GameType::from_index(int index) {
+    static const GameType *const game_types[NUMBER_OF_GAME_TYPES] = {
+        &regular, &marriage, &diamonds_solo, &hearts_solo, &spades_solo, &clubs_solo, &jacks_solo, &queens_solo, &aces_solo
+    };
+    assert(index >= 0 && index < NUMBER_OF_GAME_TYPES);
+    return game_types[index];
+}
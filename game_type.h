@@ -24,11 +24,10 @@
 
 #include <cassert>
 #include <iostream>
-#include <vector>
 
 class GameType {
-private:
-    enum game_t {
+public:
+    enum game_t { // public for the compile time tables of game_type.cpp
         REGULAR,
         MARRIAGE,
         DIAMONDS_SOLO,
@@ -39,26 +38,44 @@ private:
         QUEENS_SOLO,
         ACES_SOLO
     };
+    static const int TRUMP = 4; // the suit index of the trump cards, the non trump suits are 0 (diamonds), 1 (hearts), 2 (spades) and 3 (clubs)
+private:
     game_t type;
-    Cards trump_suit;
-    std::vector<Cards> non_trump_suits;
-    unsigned int card_to_trump_rank[48]; // maps a trump card to its rank (all other entries for non trump cards are invalid/not set!)
-    Cards card_to_suit[48]; // maps a card to its suit (either trump_suit or one of non_trump_suits)
+    // the compile time tables of the game type (see game_type.cpp), selected once by the constructor: the suit index and the rank (lower ranks are better) of every card index and the cards of every suit index
+    const unsigned char *suits;
+    const unsigned char *ranks;
+    const unsigned long long *suit_masks;
+    Cards card_to_higher_cards[48]; // maps a card to all cards of its suit which rank strictly higher
+    Cards card_to_not_lower_cards[48]; // maps a card to all cards of its suit which rank higher or equal (including the card itself)
+    static Cards to_cards(unsigned long long value) {
+        Cards cards;
+        cards.value = value;
+        return cards;
+    }
 public:
     explicit GameType(int type);
     Cards get_trump_suit() const {
-        return trump_suit;
-    }
-    const std::vector<Cards> &get_non_trump_suits() const {
-        return non_trump_suits;
+        return to_cards(suit_masks[TRUMP]);
     }
     unsigned int get_trump_rank(Card card) const {
-        return card_to_trump_rank[card.get_index()];
+        assert(is_trump(card));
+        return ranks[card.get_index()];
+    }
+    unsigned int get_non_trump_rank(Card card) const {
+        assert(!is_trump(card));
+        return ranks[card.get_index()];
+    }
+    int get_suit_index(Card card) const { // added for the CardComparator of cards.cpp
+        return suits[card.get_index()];
     }
-    unsigned int get_non_trump_rank(Card card) const;
     Cards get_suit(Card card) const {
-        return card_to_suit[card.get_index()];
+        return to_cards(suit_masks[suits[card.get_index()]]);
+    }
+    int get_index() const { // added for Move
+        return type;
     }
+    static const GameType *from_index(int index); // inverse of get_index()
+    static const int NUMBER_OF_GAME_TYPES = 9;
 
     bool operator==(const GameType &rhs) const {
         return type == rhs.type;
@@ -69,14 +86,37 @@ public:
     friend std::ostream &operator<<(std::ostream &out, const GameType &game_type);
 
     unsigned int get_rank(Card card) const { // added for BeliefGameState::get_best_move_index
-        if (trump_suit.contains_card(card))
-            return get_trump_rank(card);
-        else
-            return get_non_trump_rank(card);
+        return ranks[card.get_index()];
     }
     bool is_trump(Card card) const { // added for BeliefGameState::get_best_move_index
-        return trump_suit.contains_card(card);
+        return get_trump_suit().contains_card(card);
+    }
+    // the player winning a trick (so far), given the indices of the players' cards (-1 if a player did not play a card) and the player who started it. added for Trick
+    int get_trick_winner(const signed char cards[4], int first_player) const {
+        int winning_player = first_player;
+        int highest_card = cards[first_player];
+        for (int i = 1; i < 4; ++i) {
+            int player = (first_player + i) % 4;
+            int card = cards[player];
+            if (card == -1)
+                continue;
+            // a card of the suit of the highest card needs to rank higher, a card of another suit wins if it is trump
+            if (suits[card] == suits[highest_card] ? ranks[card] < ranks[highest_card] : suits[card] == TRUMP) {
+                highest_card = card;
+                winning_player = player;
+            }
+        }
+        return winning_player;
+    }
+    // the cards of players_cards which can be played into a trick whose first card has the given index (-1 for an empty trick). added for Trick
+    Cards get_legal_cards(int first_card, Cards players_cards) const {
+        if (first_card == -1)
+            return players_cards;
+        Cards cards_of_suit = to_cards(players_cards.value & suit_masks[suits[first_card]]);
+        return cards_of_suit.empty() ? players_cards : cards_of_suit;
     }
+    // true if card1 and card2 belong to the same suit, have the same value and all cards ranking between them (including the cards ranking equal to one of them) are contained in known_cards, i.e. no other player can play a card which beats exactly one of card1 and card2. added for BeliefGameState::merge_equivalent_cards
+    bool are_equivalent(Card card1, Card card2, Cards known_cards) const;
 };
 
 extern const GameType regular;
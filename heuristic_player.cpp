@@ -0,0 +1,148 @@
+/*
+  doko is a C++ doppelkopf program with an integrated UCT player.
+  Copyright (c) 2011-2016 Silvan Sievers
+  For questions, please write to: silvan.sievers@unibas.ch
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "heuristic_player.h"
+
+#include "belief_game_state.h"
+#include "card_assignment.h"
+#include "checkpoint.h"
+#include "game_type.h"
+#include "options.h"
+
+#include <cassert>
+#include <iostream>
+
+using namespace std;
+
+// the number of trumps and non trump aces of cards exceeding the number needed for the solo, negative if the solo is too weak
+static int get_solo_margin(const GameType &game_type, const vector<Card> &cards) {
+    int strength = 0;
+    for (size_t i = 0; i < cards.size(); ++i) {
+        if (game_type.is_trump(cards[i]) || cards[i].get_value() == 11)
+            ++strength;
+    }
+    if (game_type == jacks_solo || game_type == queens_solo)
+        return strength - 8;
+    if (game_type == aces_solo)
+        return strength - 7;
+    return strength - 11;
+}
+
+// the number of trumps of cards in the given game type
+static int count_trumps(const GameType &game_type, const vector<Card> &cards) {
+    int trumps = 0;
+    for (size_t i = 0; i < cards.size(); ++i) {
+        if (game_type.is_trump(cards[i]))
+            ++trumps;
+    }
+    return trumps;
+}
+
+HeuristicPlayer::HeuristicPlayer(int player_number, const Options &options_) : BeliefPlayer(player_number, options_), solo(0),
+    rng(options.create_random_number_generator(CARD_ASSIGNMENT_STREAM, id)) {
+}
+
+void HeuristicPlayer::set_cards(Cards cards_) {
+    BeliefPlayer::set_cards(cards_);
+    current_belief_state->set_uct_output(false);
+    solo = options.solo_disabled() ? 0 : get_best_solo(false);
+}
+
+const GameType *HeuristicPlayer::get_best_solo(bool compulsory) const {
+    const GameType *solos[7] = { &diamonds_solo, &hearts_solo, &spades_solo, &clubs_solo, &jacks_solo, &queens_solo, &aces_solo };
+    vector<Card> single_cards;
+    cards.get_single_cards(single_cards);
+    const GameType *best_solo = 0;
+    int best_margin = 0;
+    for (int i = 0; i < 7; ++i) {
+        int margin = get_solo_margin(*solos[i], single_cards);
+        if (best_solo == 0 || margin > best_margin) {
+            best_solo = solos[i];
+            best_margin = margin;
+        }
+    }
+    if (best_margin < 0 && !compulsory)
+        return 0;
+    return best_solo;
+}
+
+size_t HeuristicPlayer::get_card_move_index(const vector<Move> &legal_moves) {
+    // play the card of get_best_move_index for one assignment of the unknown cards to the other players
+    BeliefGameState state(*current_belief_state);
+    CardAssignment card_assignment(state, cards);
+    card_assignment.assign_cards_to_players(state, rng);
+    int best_move_index = state.get_best_move_index(legal_moves);
+    if (best_move_index != -1)
+        return best_move_index;
+    // no card wins the trick: play the least valuable card, a non trump card if possible
+    const GameType *game_type = state.get_game_type();
+    size_t least_valuable_index = 0;
+    for (size_t i = 1; i < legal_moves.size(); ++i) {
+        Card card = legal_moves[i].get_card();
+        Card least_valuable_card = legal_moves[least_valuable_index].get_card();
+        if (card.get_value() < least_valuable_card.get_value()
+            || (card.get_value() == least_valuable_card.get_value() && game_type->is_trump(least_valuable_card)
+                && !game_type->is_trump(card)))
+            least_valuable_index = i;
+    }
+    return least_valuable_index;
+}
+
+size_t HeuristicPlayer::ask_for_move(const vector<Move> &legal_moves) {
+    if (legal_moves.size() == 1) // also the marriage of a game without solos, which the belief state does not ask for
+        return 0;
+    assert(current_belief_state->get_player_to_move() == id);
+    if (legal_moves[0].is_question_move()) { // the options are "no" and "yes"
+        if (legal_moves[0].get_question_type() == HAS_RESERVATION)
+            return solo != 0 || (cards.contains_card(CQ) && cards.contains_card(CQ_)) ? 1 : 0; // a solo or a marriage
+        return solo != 0 ? 1 : 0;
+    } else if (legal_moves[0].is_game_type_move()) { // a solo (a marriage is the only option if it is played)
+        if (solo == 0) // vorfuehrung
+            solo = get_best_solo(true);
+        for (size_t i = 0; i < legal_moves.size(); ++i) {
+            if (legal_moves[i] == Move(solo))
+                return i;
+        }
+        assert(false);
+    } else if (legal_moves[0].is_announcement_move()) {
+        if (legal_moves[1].get_announcement() != REKON)
+            return 0;
+        const GameType *game_type = current_belief_state->get_game_type();
+        if (*game_type != regular && *game_type != marriage) // in a solo, re is the solo player
+            return solo != 0 && legal_moves[0].get_re_team() ? 1 : 0;
+        vector<Card> single_cards;
+        cards.get_single_cards(single_cards);
+        int trumps = count_trumps(*game_type, single_cards);
+        return trumps >= 8 && 3 * trumps >= 2 * cards.size() ? 1 : 0;
+    } else if (legal_moves[0].is_card_move()) {
+        return get_card_move_index(legal_moves);
+    }
+    assert(false);
+    return 0;
+}
+
+void HeuristicPlayer::write_checkpoint(CheckpointWriter &writer) const {
+    BeliefPlayer::write_checkpoint(writer);
+    writer.write_rng(rng);
+}
+
+void HeuristicPlayer::read_checkpoint(CheckpointReader &reader) {
+    BeliefPlayer::read_checkpoint(reader);
+    reader.read_rng(rng);
+}
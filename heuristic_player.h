@@ -0,0 +1,49 @@
+/*
+  doko is a C++ doppelkopf program with an integrated UCT player.
+  Copyright (c) 2011-2016 Silvan Sievers
+  For questions, please write to: silvan.sievers@unibas.ch
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef HEURISTIC_PLAYER_H
+#define HEURISTIC_PLAYER_H
+
+#include "belief_player.h"
+#include "rng.h"
+
+class GameType;
+
+/**
+A player without search which is meant as a fast but non trivial opponent for evaluating other players in many games. It keeps track of the game like UctPlayer (see BeliefPlayer) and decides with simple rules:
+- game type determination: it plays the solo for which it holds the most trumps and aces (if they reach a threshold depending on the kind of solo, see get_solo_margin()), otherwise a marriage if holding both queens of clubs, otherwise a regular game. In a compulsory solo forced by the end of the session (vorfuehrung), it plays the solo with the highest margin.
+- announcements: it announces re or kontra (but nothing further) if it is the solo player or if at least two thirds of its cards, and at least eight of them, are trumps of a regular game or a marriage.
+- card play: it assigns the cards it does not know to the other players once per card (see CardAssignment, continuing the sequence of one random number generator of the player) and plays the card chosen by BeliefGameState::get_best_move_index for this card assignment, i.e. a card winning the trick or a valuable card if its team wins the trick anyway. if there is no such card, it plays its least valuable card.
+*/
+
+class HeuristicPlayer : public BeliefPlayer {
+    const GameType *solo; // the solo the player decided to play in the current game, 0 if none
+    RandomNumberGenerator rng; // for the card assignments
+
+    const GameType *get_best_solo(bool compulsory) const; // 0 if no solo reaches its threshold and compulsory is false
+    size_t get_card_move_index(const std::vector<Move> &legal_moves);
+public:
+    HeuristicPlayer(int player_number, const Options &options);
+    void set_cards(Cards cards);
+    size_t ask_for_move(const std::vector<Move> &legal_moves);
+    void write_checkpoint(CheckpointWriter &writer) const;
+    void read_checkpoint(CheckpointReader &reader);
+};
+
+#endif
@@ -0,0 +1,172 @@
+/*
+  doko is a C++ doppelkopf program with an integrated UCT player.
+  Copyright (c) 2011-2016 Silvan Sievers
+  For questions, please write to: silvan.sievers@unibas.ch
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "logging.h"
+
+#include <cassert>
+#include <condition_variable>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <streambuf>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+log_level_t log_levels[NUMBER_OF_LOG_COMPONENTS] = { LOG_INFO, LOG_INFO, LOG_INFO, LOG_INFO };
+
+static const char *COMPONENT_NAMES[NUMBER_OF_LOG_COMPONENTS] = { "session", "game", "uct", "belief" };
+static const char *LEVEL_NAMES[] = { "off", "info", "verbose", "debug" };
+static const int NUMBER_OF_LEVELS = 4;
+static const size_t LOG_FILE_BUFFER_SIZE = 1 << 16;
+
+/*
+  A stream buffer for the log file using two buffers: the log is written into
+  one of them while a background thread writes the other one to the file.
+*/
+class LogFileBuffer : public streambuf {
+    ofstream file;
+    vector<char> buffer;
+    vector<char> pending; // written by the background thread
+    bool has_pending;
+    bool stopped;
+    mutex pending_mutex;
+    condition_variable pending_changed;
+    thread writer;
+
+    void write_pending() {
+        unique_lock<mutex> lock(pending_mutex);
+        while (true) {
+            while (!has_pending && !stopped)
+                pending_changed.wait(lock);
+            if (!has_pending)
+                return;
+            lock.unlock();
+            file.write(pending.data(), pending.size());
+            file.flush();
+            lock.lock();
+            has_pending = false;
+            pending_changed.notify_all();
+        }
+    }
+    void wait_for_writer(unique_lock<mutex> &lock) {
+        while (has_pending)
+            pending_changed.wait(lock);
+    }
+    void hand_over_buffer() { // waits until the previous buffer is written
+        unique_lock<mutex> lock(pending_mutex);
+        wait_for_writer(lock);
+        size_t size = pptr() - pbase();
+        buffer.swap(pending);
+        pending.resize(size);
+        buffer.resize(LOG_FILE_BUFFER_SIZE);
+        has_pending = size > 0;
+        pending_changed.notify_all();
+        setp(buffer.data(), buffer.data() + buffer.size());
+    }
+protected:
+    int overflow(int c) {
+        hand_over_buffer();
+        if (c != traits_type::eof()) {
+            *pptr() = c;
+            pbump(1);
+        }
+        return traits_type::not_eof(c);
+    }
+    int sync() {
+        hand_over_buffer();
+        unique_lock<mutex> lock(pending_mutex);
+        wait_for_writer(lock);
+        return file ? 0 : -1;
+    }
+public:
+    explicit LogFileBuffer(const string &filename)
+        : file(filename.c_str()), buffer(LOG_FILE_BUFFER_SIZE), has_pending(false), stopped(false) {
+        if (!file) {
+            cerr << "could not write log file " << filename << endl;
+            exit(2);
+        }
+        setp(buffer.data(), buffer.data() + buffer.size());
+        writer = thread(&LogFileBuffer::write_pending, this);
+    }
+    ~LogFileBuffer() {
+        sync();
+        {
+            lock_guard<mutex> lock(pending_mutex);
+            stopped = true;
+            pending_changed.notify_all();
+        }
+        writer.join();
+    }
+};
+
+// declared in this order such that the stream is destroyed before its buffer, which writes the rest of the log
+static unique_ptr<LogFileBuffer> log_file_buffer;
+static unique_ptr<ostream> log_file_stream;
+
+ostream &log_stream() {
+    if (log_file_stream)
+        return *log_file_stream;
+    return cout;
+}
+
+void set_log_level(log_component_t component, log_level_t level) {
+    log_levels[component] = level;
+}
+
+bool set_log_levels(const string &levels) {
+    istringstream stream(levels);
+    string entry;
+    while (getline(stream, entry, ',')) {
+        size_t separator = entry.find('=');
+        if (separator == string::npos)
+            return false;
+        string component = entry.substr(0, separator);
+        string level_name = entry.substr(separator + 1);
+        int level = 0;
+        while (level < NUMBER_OF_LEVELS && level_name != LEVEL_NAMES[level])
+            ++level;
+        if (level == NUMBER_OF_LEVELS)
+            return false;
+        bool found = false;
+        for (int i = 0; i < NUMBER_OF_LOG_COMPONENTS; ++i) {
+            if (component == "all" || component == COMPONENT_NAMES[i]) {
+                set_log_level(static_cast<log_component_t>(i), static_cast<log_level_t>(level));
+                found = true;
+            }
+        }
+        if (!found)
+            return false;
+    }
+    return true;
+}
+
+void open_log_file(const string &filename) {
+    assert(!log_file_buffer);
+    log_file_buffer.reset(new LogFileBuffer(filename));
+    log_file_stream.reset(new ostream(log_file_buffer.get()));
+}
+
+void flush_log() {
+    log_stream().flush();
+}
@@ -0,0 +1,62 @@
+/*
+  doko is a C++ doppelkopf program with an integrated UCT player.
+  Copyright (c) 2011-2016 Silvan Sievers
+  For questions, please write to: silvan.sievers@unibas.ch
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOGGING_H
+#define LOGGING_H
+
+#include <iosfwd>
+#include <string>
+
+/**
+All output of a session is written to the log (except for the interaction with human players and the output of the tools of main.cpp, such as help messages, the analysis server or replaying game logs). Every message belongs to a component and has a level, and it is only written if its level does not exceed the level set for its component. Callers test this with log_enabled() before formatting a message, so that disabled messages cost no formatting work at all:
+    if (log_enabled(LOG_UCT, LOG_VERBOSE))
+        log_stream() << "uct player " << player << " ..." << '\n';
+Messages end with '\n' rather than std::endl, i.e. the log is buffered and only written when the buffer is full, before the input of a human player is read (standard input is tied to standard output) and when flush_log() is called (e.g. when the program terminates). By default, the log is written to standard output; open_log_file() redirects it to a file which is written by a background thread, so writing the log does not block the search.
+
+All components log at level info by default, which is the output of a session without any of the options --verbose, --uct-verbose, --debug and --uct-debug. main.cpp raises the levels according to these options and to --log. The log is not thread-safe, i.e. only one thread may write to it (the analysis server turns it off).
+*/
+
+enum log_component_t {
+    LOG_SESSION, // Session and Options
+    LOG_GAME, // the course and the results of the actual games (ActualGameState, GameState, Trick)
+    LOG_UCT, // Uct and UctPlayer
+    LOG_BELIEF_STATE, // BeliefGameState
+    NUMBER_OF_LOG_COMPONENTS
+};
+
+enum log_level_t {
+    LOG_OFF,
+    LOG_INFO, // the results of the session and of its games
+    LOG_VERBOSE, // the moves of the games and the decisions of the uct players
+    LOG_DEBUG // everything else
+};
+
+extern log_level_t log_levels[NUMBER_OF_LOG_COMPONENTS];
+
+inline bool log_enabled(log_component_t component, log_level_t level) {
+    return level <= log_levels[component];
+}
+
+std::ostream &log_stream();
+void set_log_level(log_component_t component, log_level_t level);
+bool set_log_levels(const std::string &levels); // parses a comma separated list of component=level (e.g. "game=verbose,uct=off", with the component "all" for all components), returns false if the list is invalid
+void open_log_file(const std::string &filename); // terminates the program if the file cannot be written
+void flush_log(); // writes all buffered messages
+
+#endif
@@ -17,14 +17,23 @@
   along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include "doko.h"
+#include "game_log.h"
+#include "logging.h"
+#include "opening_book.h"
 #include "options.h"
+#include "server.h"
 #include "session.h"
+#include "sweep.h"
 
+#include <algorithm>
+#include <cassert>
 #include <csignal>
 #include <cstdlib>
 #include <fstream>
 #include <limits>
 #include <sstream>
+#include <thread>
 #include <unistd.h>
 
 using namespace std;
@@ -35,9 +44,9 @@ int get_peak_memory_in_kb() {
 
     ostringstream filename_stream;
     filename_stream << "/proc/" << getpid() << "/status";
-    const char *filename = filename_stream.str().c_str();
+    string filename = filename_stream.str();
 
-    ifstream procfile(filename);
+    ifstream procfile(filename.c_str());
     string word;
     while (procfile.good()) {
         procfile >> word;
@@ -66,6 +75,7 @@ void signal_handler(int signal_number) {
     if (handler_in_progress)
         raise(signal_number);
     handler_in_progress = 1;
+    flush_log();
     print_peak_memory();
     cout << "caught signal " << signal_number << " -- exiting" << endl;
     signal(signal_number, SIG_DFL);
@@ -73,6 +83,7 @@ void signal_handler(int signal_number) {
 }
 
 void exit_handler(int, void *) {
+    flush_log();
     print_peak_memory();
 }
 
@@ -93,9 +104,10 @@ void print_help() {
     cout << "--no-solo: disable solo playing. Players with two queens of clubs automatically play a marriage. (default: false)" << endl;
     cout << "--compulsory-solo: play with compulsory solo (default: false)" << endl;
     cout << "--random,--r: use random cards for the whole session (default: false). if option is not set, you will be asked to input a card distribution manually (or to deal random cards) after each game";
-    cout << "--seed,--s: random seed for random cards dealing" << endl;
+    cout << "--seed,--s: random seed for random cards dealing and for the random choices of all players (every dealing and every player uses its own stream of random numbers)" << endl;
+    cout << "--rng: random number generator, xoshiro (default) or mt. the Mersenne Twister (mt) reproduces the results of older versions, which seeded the players' random choices with a constant" << endl;
     cout << "--announcing-version: 0 for the version in which a player asked for an announcement can choose between all the legal announcements and 1 for the version in which a player asked for an announcement only can opt to not announce or to announce the 'next' announcement for his team and then gets asked again immediately if he wants to make another announcement or not" << endl;
-    cout << "--players,--p: specify four player types from { uct, human, random } (default: uct random random random)" << endl;
+    cout << "--players,--p: specify four player types from { uct, human, random, heuristic } (default: uct random random random). a heuristic player does not search but plays a winning card if there is one (like the heuristic rollouts of UCT players) and decides on solos and announcements by simple rules on its cards" << endl;
     cout << "--print-player-options: prints options that can be specified by using the --p*-options arguments of the program, then terminating" << endl;
     cout << "--p0-options: specify options for player 0 (only if UCT player; see --print-player-options for available options)" << endl;
     cout << "--p1-options: specify options for player 1 (only if UCT player; see --print-player-options for available options)" << endl;
@@ -106,10 +118,23 @@ void print_help() {
     cout << "--uct-verbose: display detailed output from UCT players and UCT algorithm (default: false). only relevant if there is at least one UCT player" << endl;
     cout << "--debug,--d: display debug output in BeliefGameState (default: false)" << endl;
     cout << "--uct-debug: display debug output in Uct (default: false)" << endl;
+    cout << "--log: comma separated list of component=level setting the output of the components session, game, uct and belief (or all of them) to one of the levels off, info, verbose and debug, e.g. all=off,game=info (default: info for all components, raised by --verbose, --uct-verbose, --debug and --uct-debug)" << endl;
+    cout << "--log-file: file name: write the output of the session to this file instead of standard output (written in the background)" << endl;
+    cout << "--opening-book: file name of an opening book that UCT players consult for game type determination decisions (only used by players whose options match the ones the book was built with)" << endl;
+    cout << "--build-opening-book: file name: instead of playing a session, play its games (see --number and --seed) with four UCT players with the options of player 0 and write their game type determination decisions to an opening book" << endl;
+    cout << "--game-log: file name: write a binary record of every game of the session (cards, players' types, moves and score points) to this file" << endl;
+    cout << "--checkpoint: file name: after every game, write the state of the session (standings, dealing and players' random number generators etc.) to this file, replacing the previous checkpoint atomically" << endl;
+    cout << "--resume: continue the session from the file given by --checkpoint (if it exists) with the remaining games, which are played exactly like in an uninterrupted session. all options influencing the games must be the same as when starting the session, and a game log (see --game-log) is continued after the last game of the checkpoint" << endl;
+    cout << "--replay-game-log: file name: instead of playing a session, replay all games recorded in this game log and print statistics about them" << endl;
+    cout << "--sweep: file name: instead of playing a session, play its games (see --number and --seed) with every configuration of the options of player 0 listed in this file while keeping the other players, and print a table of the mean score points and time per game of every configuration (see sweep.h for the format of the file). all configurations play the same deals with the same first players" << endl;
+    cout << "--sweep-threads: number of games the sweep plays in parallel (default: number of cores)" << endl;
+    cout << "--server: instead of playing a session, answer search requests for positions read from standard input until it is closed (see server.h for the protocol). searches use the options of player 0 unless a request specifies other options" << endl;
+    cout << "--server-socket: file name: like --server, but answer requests of all clients connecting to a local socket at this path" << endl;
+    cout << "--server-threads: number of searches the server runs in parallel (default: number of cores)" << endl;
 }
 
 void print_player_options() {
-    string player_options = "(currently only a UCT player accepts options)\n\nversion:\n0 for an UCT algorithm with a number of simulations, each with a fixed card assignment and a number of rollouts per simulation, 1 for an UCT algorithm with a number of rollouts, each using a different card assignment\n\nscore points factor:\ninteger which score points get multiplyed by in order to obtain UCT rewards\n\nplayer's or team's points:\n0 for using player's point as an additional bias to the score points, 1 for using the player's team points\n\nplaying points divisor:\ninterger which the player's or the team points of the player get divided by before being added to the (modified) score points\n\nexploration:\ninteger used as exploration constant in the UCT formula\n\nrollouts:\ninteger setting the number of rollouts performed in a UCT search (either in total, or per simulation)\n\nsimulations:\ninteger setting the number of simulations performed in a UCT search, specify anything if using version 1 (do not leave empty though!)\n\nannouncements:\n0 to forbid the UCT player to do announcements, 1 to allow, 2 to allow but to forbid if all possible moves yield a negative reward\n\nWrong UCT formula:\n0 to use the correct UCT formula and 1 to use the total number of visits in the tree (i.e. the current number of rollout) rather than the number of total visits of the specific node for which the formula is calculated\n\nMC simulation:\n0 if no MC simulation should be carried on but all states encountered during a rollout should be added to the tree, i.e. more than one per rollout. 1 if a MC simulation should be carried on as soon as a leaf node was added to the tree, i.e. only one node is added to the tree per rollout\n\nAction selection:\n0 to choose the first successor when expanding the first node and use random action selection after a new node was inserted, 1 to also use random action selection when expanding the first node (rest same as 0), 2 to choose the first successor when expanding the first node and use heurstic guided action selection after a new node was inserted, 3 to use random action selection when expanding the first node and heristic guided action selection after a new node was inserted, 4 to use heuristic guided action whenever a successor needs to be chosen\n\n(defaults: 1 500 1 1 20000 1000 10 2 0 0 0)";
+    string player_options = "(currently only a UCT player accepts options)\n\nversion:\n0 for an UCT algorithm with a number of simulations, each with a fixed card assignment and a number of rollouts per simulation, 1 for an UCT algorithm with a number of rollouts, each using a different card assignment\n\nscore points factor:\ninteger which score points get multiplyed by in order to obtain UCT rewards\n\nplayer's or team's points:\n0 for using player's point as an additional bias to the score points, 1 for using the player's team points\n\nplaying points divisor:\ninterger which the player's or the team points of the player get divided by before being added to the (modified) score points\n\nexploration:\ninteger used as exploration constant in the UCT formula\n\nrollouts:\ninteger setting the number of rollouts performed in a UCT search (either in total, or per simulation)\n\nsimulations:\ninteger setting the number of simulations performed in a UCT search, specify anything if using version 1 (do not leave empty though!)\n\nannouncements:\n0 to forbid the UCT player to do announcements, 1 to allow, 2 to allow but to forbid if all possible moves yield a negative reward\n\nWrong UCT formula:\n0 to use the correct UCT formula and 1 to use the total number of visits in the tree (i.e. the current number of rollout) rather than the number of total visits of the specific node for which the formula is calculated\n\nMC simulation:\n0 if no MC simulation should be carried on but all states encountered during a rollout should be added to the tree, i.e. more than one per rollout. 1 if a MC simulation should be carried on as soon as a leaf node was added to the tree, i.e. only one node is added to the tree per rollout\n\nAction selection:\n0 to choose the first successor when expanding the first node and use random action selection after a new node was inserted, 1 to also use random action selection when expanding the first node (rest same as 0), 2 to choose the first successor when expanding the first node and use heurstic guided action selection after a new node was inserted, 3 to use random action selection when expanding the first node and heristic guided action selection after a new node was inserted, 4 to use heuristic guided action whenever a successor needs to be chosen\n\nRollout truncation (optional):\n0 to simulate every rollout until the end of the game, n > 0 to stop the MC simulation after n tricks and to estimate the result of the game from the points made so far and the strength of the remaining hands\n\nNode budget (optional):\n0 for an unlimited tree, n > 0 to stop adding nodes to a tree once it has n nodes (except for successors of the root), i.e. the remaining rollouts only refine the statistics of the existing nodes. bounds the memory of a search, see --uct-verbose for the size of the trees\n\nRoot selection (optional):\n0 to choose the successors of the root by the uct formula like all other successors, 1 to use sequential halving at the root: the rollouts are split into rounds, each round spreads its rollouts evenly over the remaining moves and then discards the worse half of them, and the last remaining move is chosen. concentrates the rollouts on the promising moves of wide roots, such that fewer rollouts suffice\n\nAvailability counts (optional):\n0 to compute the exploration term of the UCT formula from the number of visits of the node, 1 to compute it for every successor from the number of times it was a legal move when the node was visited (information set UCT, version 1 only): with a new card assignment in every rollout, the successors of the nodes of the other players are not always available, and rarely available successors are otherwise explored too much\n\nCard assignments limit (optional):\n0 to always sample the card assignments, n > 0 to compute all card assignments consistent with the game so far if there are at most n of them (usually in the last tricks) and to use them according to their exact probabilities instead of sampling: version 0 searches each of them in its own tree (instead of the simulations) and weights the average rewards of the trees by the probabilities, version 1 cycles through them such that the rollouts use every card assignment in proportion to its probability\n\n(defaults: 1 500 1 1 20000 1000 10 2 0 0 0 0 0 0 0 0)";
     cout << player_options << endl;
 }
 
@@ -123,78 +148,55 @@ int get_int_option(int argc, char *argv[], int &index) {
     return result;
 }
 
+string get_string_option(int argc, char *argv[], int &index) {
+    if (index + 1 >= argc) {
+        cerr << "Missing argument after " << argv[index] << endl;
+        exit(2);
+    }
+    ++index;
+    return argv[index];
+}
+
 void parse_players_options(int argc, char *argv[], int &index, vector<int> &players_options) {
-    if (index + 11 >= argc) {
+    if (index + NUMBER_OF_REQUIRED_PLAYER_OPTIONS >= argc) {
         cerr << "Missing eleven (integer) arguments after " << argv[index] << endl;
         exit(2);
     }
-    players_options.reserve(11);
-    for (int j = 0; j < 11; ++j) {
+    players_options.reserve(NUMBER_OF_PLAYER_OPTIONS);
+    for (int j = 0; j < NUMBER_OF_REQUIRED_PLAYER_OPTIONS; ++j) {
         int option = atoi(argv[index + 1 + j]);
         players_options.push_back(option);
     }
-    index += 11;
+    index += NUMBER_OF_REQUIRED_PLAYER_OPTIONS;
+    // the remaining options are optional: read them as long as the next argument is not an option name
+    while (players_options.size() < static_cast<size_t>(NUMBER_OF_PLAYER_OPTIONS) && index + 1 < argc
+           && argv[index + 1][0] != '-') {
+        players_options.push_back(atoi(argv[index + 1]));
+        ++index;
+    }
+    for (int j = players_options.size(); j < NUMBER_OF_PLAYER_OPTIONS; ++j)
+        players_options.push_back(DEFAULT_PLAYER_OPTIONS[j]);
 }
 
 void check_uct_player_options(const vector<int> &player_options) {
-    if (player_options.size() != 11) {
-        cerr << "must specify 11 player options" << endl;
-        exit(2);
-    }
-    if (player_options[0] != 0 && player_options[0] != 1) {
-        cerr << "version must be set to 0 or 1" << endl;
-        exit(2);
-    }
-    if (player_options[1] < 1) {
-        cerr << "score points factor must be greater 0" << endl;
-        exit(2);
-    }
-    if (player_options[2] != 0 && player_options[2] != 1) {
-        cerr << "using player's or team's points must be set to 0 or 1" << endl;
-        exit(2);
-    }
-    if (player_options[3] < 1) {
-        cerr << "playing points divisor must be greater 0" << endl;
-        exit(2);
-    }
-    if (player_options[4] < 1) {
-        cerr << "exploration constant must be greater 0" << endl;
-        exit(2);
-    }
-    if (player_options[5] < 1) {
-        cerr << "number of rollouts must be greater 0" << endl;
-        exit(2);
-    }
-    if (player_options[6] < 1) {
-        cerr << "number of simulations must be greater 0" << endl;
-        exit(2);
-    }
-    if (player_options[7] != 0 && player_options[7] != 1 && player_options[7] != 2) {
-        cerr << "announcement option must be set to 0, 1 or 2" << endl;
-        exit(2);
-    }
-    if (player_options[8] != 0 && player_options[8] != 1) {
-        cerr << "using wrong UCT formula must be set to 0 or 1" << endl;
-        exit(2);
-    }
-    if (player_options[9] != 0 && player_options[9] != 1) {
-        cerr << "using MC simulation must be set to 0 or 1" << endl;
-        exit(2);
-    }
-    if (player_options[10] < 0 || player_options[10] > 4) {
-        cerr << "action selection must be in the interval [0,4]" << endl;
+    string error = get_uct_player_options_error(player_options);
+    if (!error.empty()) {
+        cerr << error << endl;
         exit(2);
     }
 }
 
 int main(int argc, char *argv[]) {
     register_event_handlers();
+    // the program only uses C++ streams, which are much faster without synchronizing them with C's standard output
+    ios_base::sync_with_stdio(false);
 
     int number = 1000;
     bool no_solo = false;
     bool compulsory_solo = false;
     bool random = false;
     int seed = 2012;
+    rng_t rng_type = XOSHIRO;
     int announcing_version = 1;
     vector<player_t> players_types;
     vector<vector<int> > players_options(4);
@@ -203,6 +205,18 @@ int main(int argc, char *argv[]) {
     bool uct_verbose = false;
     bool debug = false;
     bool uct_debug = false;
+    string opening_book_filename;
+    string opening_book_to_build;
+    string game_log_filename;
+    string checkpoint_filename;
+    bool resume = false;
+    string log_levels;
+    string log_filename;
+    string sweep_filename;
+    int sweep_threads = max(1u, thread::hardware_concurrency());
+    bool server = false;
+    string server_socket;
+    int server_threads = max(1u, thread::hardware_concurrency());
 
     // TODO: test if important command line arguments trigger errors as intended
     // TODO: move parsing to Options? Or have its own class
@@ -231,6 +245,16 @@ int main(int argc, char *argv[]) {
             random = true;
         } else if (arg == "--seed" || arg == "-s") {
             seed = get_int_option(argc, argv, i);
+        } else if (arg == "--rng") {
+            string rng_name = get_string_option(argc, argv, i);
+            if (rng_name == "xoshiro") {
+                rng_type = XOSHIRO;
+            } else if (rng_name == "mt") {
+                rng_type = MERSENNE_TWISTER;
+            } else {
+                cerr << "random number generator can be xoshiro or mt" << endl;
+                exit(2);
+            }
         } else if (arg == "--announcing-version") {
             announcing_version = get_int_option(argc, argv, i);
         } else if (arg == "--players" || arg == "-p") {
@@ -245,10 +269,12 @@ int main(int argc, char *argv[]) {
                     players_types.push_back(HUMAN);
                 } else if (player_type == "random") {
                     players_types.push_back(RANDOM);
+                } else if (player_type == "heuristic") {
+                    players_types.push_back(HEURISTIC);
                 } else if (player_type == "uct") {
                     players_types.push_back(UCT);
                 } else {
-                    cerr << "Players types can be human, random or uct" << endl;
+                    cerr << "Players types can be human, random, heuristic or uct" << endl;
                     exit(2);
                 }
             }
@@ -271,6 +297,43 @@ int main(int argc, char *argv[]) {
             debug = true;
         } else if (arg == "--uct-debug") {
             uct_debug = true;
+        } else if (arg == "--log") {
+            log_levels = get_string_option(argc, argv, i);
+        } else if (arg == "--log-file") {
+            log_filename = get_string_option(argc, argv, i);
+        } else if (arg == "--opening-book") {
+            opening_book_filename = get_string_option(argc, argv, i);
+        } else if (arg == "--build-opening-book") {
+            opening_book_to_build = get_string_option(argc, argv, i);
+        } else if (arg == "--game-log") {
+            game_log_filename = get_string_option(argc, argv, i);
+        } else if (arg == "--checkpoint") {
+            checkpoint_filename = get_string_option(argc, argv, i);
+        } else if (arg == "--resume") {
+            resume = true;
+        } else if (arg == "--sweep") {
+            sweep_filename = get_string_option(argc, argv, i);
+        } else if (arg == "--sweep-threads") {
+            sweep_threads = get_int_option(argc, argv, i);
+            if (sweep_threads < 1) {
+                cerr << "number of sweep threads must be greater 0" << endl;
+                exit(2);
+            }
+        } else if (arg == "--server") {
+            server = true;
+        } else if (arg == "--server-socket") {
+            server = true;
+            server_socket = get_string_option(argc, argv, i);
+        } else if (arg == "--server-threads") {
+            server_threads = get_int_option(argc, argv, i);
+            if (server_threads < 1) {
+                cerr << "number of server threads must be greater 0" << endl;
+                exit(2);
+            }
+        } else if (arg == "--replay-game-log") {
+            initialize_doko();
+            replay_game_log(get_string_option(argc, argv, i));
+            return 0;
         } else {
             cerr << "Unrecognized option " << arg << endl;
             exit(2);
@@ -279,6 +342,37 @@ int main(int argc, char *argv[]) {
 
     // TODO: use better player options (ideally named)
 
+    // the output options select the levels of the log, which --log can override
+    if (verbose)
+        set_log_level(LOG_GAME, LOG_VERBOSE);
+    if (uct_verbose)
+        set_log_level(LOG_UCT, LOG_VERBOSE);
+    if (uct_debug)
+        set_log_level(LOG_UCT, LOG_DEBUG);
+    if (debug)
+        set_log_level(LOG_BELIEF_STATE, LOG_DEBUG);
+    if (!set_log_levels(log_levels)) {
+        cerr << "invalid log levels " << log_levels << endl;
+        exit(2);
+    }
+    if (!log_filename.empty())
+        open_log_file(log_filename);
+    if (resume && checkpoint_filename.empty()) {
+        cerr << "--resume requires --checkpoint" << endl;
+        exit(2);
+    }
+
+    if (!opening_book_to_build.empty()) {
+        // all players are UCT players with the options of player 0
+        if (!players_types.empty() && players_types[0] != UCT) {
+            cerr << "player 0 must be a UCT player to build an opening book" << endl;
+            exit(2);
+        }
+        players_types.assign(4, UCT);
+        for (int i = 1; i < 4; ++i)
+            players_options[i] = players_options[0];
+    }
+
     if (players_types.empty()) {
         // use default values
         players_types.push_back(UCT);
@@ -295,17 +389,7 @@ int main(int argc, char *argv[]) {
         if (players_types[i] == UCT) {
             if (players_options[i].empty()) {
                 // use default values
-                players_options[i].push_back(1);
-                players_options[i].push_back(500);
-                players_options[i].push_back(1);
-                players_options[i].push_back(1);
-                players_options[i].push_back(20000);
-                players_options[i].push_back(1000);
-                players_options[i].push_back(10);
-                players_options[i].push_back(2);
-                players_options[i].push_back(0);
-                players_options[i].push_back(0);
-                players_options[i].push_back(0);
+                players_options[i].assign(DEFAULT_PLAYER_OPTIONS, DEFAULT_PLAYER_OPTIONS + NUMBER_OF_PLAYER_OPTIONS);
             } else {
                 check_uct_player_options(players_options[i]);
             }
@@ -313,8 +397,24 @@ int main(int argc, char *argv[]) {
     }
 
     Options options(number, no_solo, compulsory_solo, players_types, random,
-                    seed, verbose, uct_verbose, debug, uct_debug,
-                    players_options, create_graph, announcing_version);
-    Session session(options);
+                    seed, rng_type, verbose, uct_verbose, debug, uct_debug,
+                    players_options, create_graph, announcing_version, opening_book_filename,
+                    game_log_filename);
+    if (!opening_book_to_build.empty()) {
+        initialize_doko();
+        build_opening_book(options, opening_book_to_build);
+        return 0;
+    }
+    if (!sweep_filename.empty()) {
+        initialize_doko();
+        run_sweep(options, sweep_filename, sweep_threads);
+        return 0;
+    }
+    if (server) {
+        initialize_doko();
+        run_server(options, server_threads, server_socket);
+        return 0;
+    }
+    Session session(options, checkpoint_filename, resume);
     return 0;
 }
@@ -26,79 +26,77 @@
 
 using namespace std;
 
-Move::Move(question_t question_type_, bool answer) : type(QUESTION), question_type(question_type_), answer_re(answer) {
+Move::Move(question_t question_type, bool answer) : id(FIRST_QUESTION_ID + 2 * question_type + answer) {
 }
 
-Move::Move(const GameType *game_type_) : type(GAME_TYPE), game_type(game_type_) {
+Move::Move(const GameType *game_type) : id(FIRST_GAME_TYPE_ID + game_type->get_index()) {
+    assert(GameType::from_index(game_type->get_index()) == game_type);
 }
 
-Move::Move(announcement_t announcement_, bool re_team) : type(ANNOUNCEMENT), answer_re(re_team), announcement(announcement_)  {
+// the id distinguishes between the announcing teams: saying re or kontra is not the same information for the other players (see Move::is_same_ignoring_team() for comparing moves without the team)
+Move::Move(announcement_t announcement, bool re_team) : id(FIRST_ANNOUNCEMENT_ID + 2 * announcement + re_team) {
 }
 
-Move::Move(Card card_) : type(CARD), card(card_) {
+Move::Move(Card card) : id(card == no_card ? NO_CARD_ID : card.get_index()) {
+}
+
+const GameType *Move::get_game_type() const {
+    assert(is_game_type_move());
+    return GameType::from_index(id - FIRST_GAME_TYPE_ID);
 }
 
 void Move::print_type(ostream &out) const {
     out << "move type: ";
-    switch (type) {
-        case QUESTION:
-            switch (question_type) {
-                case IMMEDIATE_SOLO:
-                    out << "immediate solo: ";
-                    break;
-                case HAS_RESERVATION:
-                    out << "has reservation: ";
-                    break;
-                case IS_SOLO:
-                    out << "is solo: ";
-                    break;
-            }
-            break;
-        case GAME_TYPE:
-            out << "game type: ";
-            break;
-        case ANNOUNCEMENT:
-            out << "announcement: ";
-            break;
-        case CARD:
-            out << "card: ";
-            break;
+    if (is_question_move()) {
+        switch (get_question_type()) {
+            case IMMEDIATE_SOLO:
+                out << "immediate solo: ";
+                break;
+            case HAS_RESERVATION:
+                out << "has reservation: ";
+                break;
+            case IS_SOLO:
+                out << "is solo: ";
+                break;
+        }
+    } else if (is_game_type_move()) {
+        out << "game type: ";
+    } else if (is_announcement_move()) {
+        out << "announcement: ";
+    } else {
+        assert(is_card_move());
+        out << "card: ";
     }
 }
 
 void Move::print_option(ostream &out) const {
-    switch (type) {
-        case QUESTION:
-            out << (answer_re ? "yes" : "no");
-            break;
-        case GAME_TYPE:
-            out << *game_type;
-            break;
-        case ANNOUNCEMENT:
-            switch (announcement) {
-                case NONE:
-                    out << "no announcement";
-                    break;
-                case REKON:
-                    out << "re/kontra";
-                    break;
-                case N90:
-                    out << "no 90";
-                    break;
-                case N60:
-                    out << "no 60";
-                    break;
-                case N30:
-                    out << "no 30";
-                    break;
-                case SCHWARZ:
-                    out << "black";
-                    break;
-            }
-            break;
-        case CARD:
-            assert(false);
-            break;
+    if (is_question_move()) {
+        out << (get_answer() ? "yes" : "no");
+    } else if (is_game_type_move()) {
+        out << *get_game_type();
+    } else if (is_announcement_move()) {
+        switch (get_announcement()) {
+            case NONE:
+                out << "no announcement";
+                break;
+            case REKON:
+                out << "re/kontra";
+                break;
+            case N90:
+                out << "no 90";
+                break;
+            case N60:
+                out << "no 60";
+                break;
+            case N30:
+                out << "no 30";
+                break;
+            case SCHWARZ:
+                out << "black";
+                break;
+        }
+    } else {
+        assert(false);
     }
 }
 
@@ -125,3 +123,13 @@ ostream &operator<<(ostream &out, const vector<Move> &moves) {
     }
     return out;
 }
+
+void merge_duplicate_cards(vector<Move> &moves) {
+    size_t number_of_moves = 0;
+    for (size_t i = 0; i < moves.size(); ++i) {
+        // both copies of a card have consecutive ids, thus they are neighbours in moves
+        if (number_of_moves == 0 || moves[i].get_merged_id() != moves[number_of_moves - 1].get_merged_id())
+            moves[number_of_moves++] = moves[i];
+    }
+    moves.resize(number_of_moves);
+}
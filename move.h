@@ -35,20 +35,24 @@ enum question_t {
 
 class GameType;
 
+/*
+  Every move can be identified by a compact id in the range [0, NUM_MOVE_IDS):
+  the 48 cards (by their card index), followed by the 6 answers to questions,
+  the 9 game types and the 6 announcements for each of the two teams. Move
+  stores nothing but this id, which keeps the search tree and all vectors of
+  legal moves small and makes comparing moves a single integer comparison.
+*/
+const int NUM_MOVE_IDS = 48 + 6 + 9 + 12;
+
 class Move {
 private:
-    enum move_t {
-        QUESTION,
-        GAME_TYPE,
-        ANNOUNCEMENT,
-        CARD
+    enum {
+        FIRST_QUESTION_ID = 48,
+        FIRST_GAME_TYPE_ID = 54,
+        FIRST_ANNOUNCEMENT_ID = 63,
+        NO_CARD_ID = NUM_MOVE_IDS // the card move with no_card, which BeliefGameState uses to denote the type of the next move
     };
-    move_t type;
-    question_t question_type;
-    bool answer_re; // being used to store the answer for a question or if announcing player belongs to re team or not
-    const GameType *game_type;
-    announcement_t announcement;
-    Card card;
+    unsigned char id;
 
     void print_type(std::ostream &out) const;
 public:
@@ -57,58 +61,69 @@ public:
     explicit Move(const GameType *game_type);
     Move(announcement_t announcement, bool re_team);
     explicit Move(Card card);
+    static Move from_id(int id) { // inverse of get_id()
+        assert(id >= 0 && id < NUM_MOVE_IDS);
+        Move move;
+        move.id = id;
+        return move;
+    }
     bool is_question_move() const {
-        return type == QUESTION;
+        return id >= FIRST_QUESTION_ID && id < FIRST_GAME_TYPE_ID;
     }
     question_t get_question_type() const {
         assert(is_question_move());
-        return question_type;
+        return static_cast<question_t>((id - FIRST_QUESTION_ID) / 2);
     }
     bool get_answer() const {
-        return answer_re;
+        return is_question_move() && (id - FIRST_QUESTION_ID) % 2;
     }
     bool is_game_type_move() const {
-        return type == GAME_TYPE;
-    }
-    const GameType *get_game_type() const {
-        assert(is_game_type_move());
-        return game_type;
+        return id >= FIRST_GAME_TYPE_ID && id < FIRST_ANNOUNCEMENT_ID;
     }
+    const GameType *get_game_type() const;
     bool is_announcement_move() const {
-        return type == ANNOUNCEMENT;
+        return id >= FIRST_ANNOUNCEMENT_ID && id < NO_CARD_ID;
     }
     announcement_t get_announcement() const {
         assert(is_announcement_move());
-        return announcement;
+        return static_cast<announcement_t>((id - FIRST_ANNOUNCEMENT_ID) / 2);
     }
     bool get_re_team() const {
-        return answer_re;
+        return is_announcement_move() && (id - FIRST_ANNOUNCEMENT_ID) % 2;
     }
     bool is_card_move() const {
-        return type == CARD;
+        return id < FIRST_QUESTION_ID || id == NO_CARD_ID;
     }
     Card get_card() const {
         assert(is_card_move());
-        return card;
+        return id == NO_CARD_ID ? no_card : Card(id);
+    }
+    int get_id() const { // used by Uct to look up the successor of a node reached by this move
+        assert(id != NO_CARD_ID);
+        return id;
+    }
+    int get_merged_id() const { // like get_id(), but identical for both copies of a card, which are strategically equivalent, and for the announcements of both teams, as the team of an announcing player is hidden information for the other players (see Uct)
+        if (is_card_move())
+            return get_id() & ~1;
+        if (is_announcement_move())
+            return get_id() - get_re_team();
+        return get_id();
+    }
+    bool is_same_ignoring_team(const Move &rhs) const { // like operator==, but announcements of both teams are the same (like get_merged_id(), but the two copies of a card are still different). added for matching the successors of uct nodes
+        if (id == rhs.id)
+            return true;
+        return is_announcement_move() && rhs.is_announcement_move() && get_announcement() == rhs.get_announcement();
     }
 
     bool operator==(const Move &rhs) const { // TODO: this is only for debugging (assertion in uct_player.cpp)
-        if (type != rhs.type)
-            return false;
-        if (type == QUESTION)
-            return (question_type == rhs.question_type && answer_re == rhs.answer_re);
-        else if (type == GAME_TYPE)
-            return game_type == rhs.game_type; // NOTE: comparing the pointers actually is enough because they all point to the same global const objects defined in game_type.h
-        else if (type == ANNOUNCEMENT)
-            return announcement == rhs.announcement;
-        else if (type == CARD)
-            return card == rhs.card;
-        else
-            return false;
+        return id == rhs.id;
     }
     void print_option(std::ostream &out = std::cout) const; // public for human_player
     friend std::ostream &operator<<(std::ostream &out, const Move &move);
     friend std::ostream &operator<<(std::ostream &out, const std::vector<Move> &moves);
 };
 
+// keeps only the first of two moves playing the two copies of the same card; moves must be ordered by their ids, as returned by BeliefGameState::get_legal_moves()
+void merge_duplicate_cards(std::vector<Move> &moves);
+
 #endif
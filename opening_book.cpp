@@ -0,0 +1,263 @@
+/*
+  doko is a C++ doppelkopf program with an integrated UCT player.
+  Copyright (c) 2011-2016 Silvan Sievers
+  For questions, please write to: silvan.sievers@unibas.ch
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "opening_book.h"
+
+#include "actual_game_state.h"
+#include "game_type.h"
+#include "options.h"
+#include "rng.h"
+#include "session.h"
+#include "uct_player.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+static const char OPENING_BOOK_MAGIC[8] = { 'D', 'O', 'K', 'O', 'B', 'O', 'O', 'K' };
+static const int OPENING_BOOK_FORMAT_VERSION = 3; // version 2 stores the number of player options, version 3 keys hands by their profile
+static_assert(sizeof(OpeningBookHeader) % sizeof(uint64_t) == 0, "entries following the header must be aligned");
+
+static void exit_with_invalid_book(const string &filename, const string &reason) {
+    cerr << "could not use opening book " << filename << ": " << reason << endl;
+    exit(2);
+}
+
+OpeningBook::OpeningBook(const string &filename) : mapped_memory(0), mapped_size(0), header(0), entries(0) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd == -1)
+        exit_with_invalid_book(filename, "cannot open file");
+    struct stat file_status;
+    if (fstat(fd, &file_status) == -1 || static_cast<size_t>(file_status.st_size) < sizeof(OpeningBookHeader)) {
+        close(fd);
+        exit_with_invalid_book(filename, "file too small");
+    }
+    mapped_size = file_status.st_size;
+    mapped_memory = mmap(0, mapped_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); // the mapping stays valid
+    if (mapped_memory == MAP_FAILED)
+        exit_with_invalid_book(filename, "cannot map file into memory");
+    header = static_cast<const OpeningBookHeader *>(mapped_memory);
+    entries = reinterpret_cast<const uint64_t *>(header + 1);
+    if (memcmp(header->magic, OPENING_BOOK_MAGIC, sizeof(OPENING_BOOK_MAGIC)) != 0)
+        exit_with_invalid_book(filename, "not an opening book");
+    if (header->format_version != OPENING_BOOK_FORMAT_VERSION)
+        exit_with_invalid_book(filename, "unsupported format version");
+    if (mapped_size != sizeof(OpeningBookHeader) + header->number_of_entries * sizeof(uint64_t))
+        exit_with_invalid_book(filename, "file size does not match the number of entries");
+}
+
+OpeningBook::~OpeningBook() {
+    munmap(mapped_memory, mapped_size);
+}
+
+bool OpeningBook::is_compatible(const Options &options, int player) const {
+    if (header->no_solo != options.solo_disabled() || header->compulsory_solo != options.use_compulsory_solo())
+        return false;
+    const vector<int> &player_options = options.get_player_options(player);
+    if (header->number_of_player_options != static_cast<int>(player_options.size()))
+        return false;
+    for (size_t i = 0; i < player_options.size(); ++i) {
+        if (header->player_options[i] != player_options[i])
+            return false;
+    }
+    return true;
+}
+
+const OpeningBook *get_opening_book_for_player(const OpeningBook *book, const Options &options, int player) {
+    if (book == 0 || book->is_compatible(options, player))
+        return book;
+    cerr << "warning: opening book " << options.get_opening_book_filename() << " was built with different options"
+         << " than those of player " << player << ", not using it" << endl;
+    return 0;
+}
+
+int OpeningBook::lookup(uint64_t key) const {
+    const uint64_t *end = entries + header->number_of_entries;
+    const uint64_t *entry = lower_bound(entries, end, key << 8);
+    if (entry != end && (*entry >> 8) == key)
+        return *entry & 0xff;
+    return -1;
+}
+
+static uint64_t mix(uint64_t value) { // the finalizer of splitmix64
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9ULL;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111ebULL;
+    value ^= value >> 31;
+    return value;
+}
+
+uint64_t OpeningBook::get_hand_profile(Cards cards) {
+    vector<Card> single_cards;
+    cards.get_single_cards(single_cards);
+    int clubs_queens = 0;
+    int trumps = 0;
+    int high_trumps = 0;
+    int plain_aces = 0;
+    int solo_trumps[3] = { 0, 0, 0 }; // hearts, spades and clubs solo; a diamonds solo has the trumps of a regular game
+    int jacks = 0;
+    int queens = 0;
+    int aces = 0;
+    for (size_t i = 0; i < single_cards.size(); ++i) {
+        Card card = single_cards[i];
+        if (regular.is_trump(card)) {
+            ++trumps;
+            if (regular.get_trump_rank(card) <= 3) // ten of hearts and queens of clubs and spades
+                ++high_trumps;
+            if (regular.get_trump_rank(card) == 2)
+                ++clubs_queens;
+        } else if (regular.get_non_trump_rank(card) == 1) {
+            ++plain_aces;
+        }
+        if (hearts_solo.is_trump(card))
+            ++solo_trumps[0];
+        if (spades_solo.is_trump(card))
+            ++solo_trumps[1];
+        if (clubs_solo.is_trump(card))
+            ++solo_trumps[2];
+        if (jacks_solo.is_trump(card))
+            ++jacks;
+        if (queens_solo.is_trump(card))
+            ++queens;
+        if (aces_solo.get_non_trump_rank(card) == 1)
+            ++aces;
+    }
+    // every feature takes 4 bits. small numbers of trumps of a solo are merged because such a solo is not played anyway.
+    uint64_t profile = clubs_queens;
+    profile = (profile << 4) | trumps;
+    profile = (profile << 4) | high_trumps;
+    profile = (profile << 4) | min(plain_aces, 3);
+    for (int i = 0; i < 3; ++i)
+        profile = (profile << 4) | max(solo_trumps[i], 6);
+    profile = (profile << 4) | max(jacks, 4);
+    profile = (profile << 4) | max(queens, 4);
+    profile = (profile << 4) | max(aces, 4);
+    return profile;
+}
+
+uint64_t OpeningBook::compute_key(Cards cards, int position, const bool played_compulsory_solo[4], bool vorfuehrung,
+                                  const vector<int> &history) {
+    uint64_t situation = position;
+    for (int i = 0; i < 4; ++i)
+        situation |= static_cast<uint64_t>(played_compulsory_solo[i]) << (2 + i);
+    situation |= static_cast<uint64_t>(vorfuehrung) << 6;
+    uint64_t key = mix(mix(get_hand_profile(cards)) ^ situation);
+    for (size_t i = 0; i < history.size(); ++i)
+        key = mix(key ^ history[i]);
+    return key >> 8;
+}
+
+/*
+  A uct player which records all decisions it takes during game type
+  determination and which plays the rest of the game without searching, as
+  only the game type determination is relevant for the opening book.
+*/
+class OpeningBookBuildingPlayer : public UctPlayer {
+    map<pair<uint64_t, int>, int> &decisions; // (key, move id) -> number of times the move was chosen for the key
+public:
+    OpeningBookBuildingPlayer(int player_number, const Options &options, const OpeningBook *opening_book,
+                              map<pair<uint64_t, int>, int> &decisions_)
+        : UctPlayer(player_number, options, opening_book), decisions(decisions_) {
+    }
+    size_t ask_for_move(const vector<Move> &legal_moves) {
+        if (legal_moves[0].is_card_move() || legal_moves[0].is_announcement_move())
+            return 0;
+        size_t move_index = UctPlayer::ask_for_move(legal_moves);
+        if (legal_moves.size() > 1)
+            ++decisions[make_pair(get_opening_book_key(), legal_moves[move_index].get_id())];
+        return move_index;
+    }
+};
+
+void build_opening_book(const Options &options, const string &filename) {
+    // play the games like Session does, using the same random cards for the same seed
+    map<pair<uint64_t, int>, int> decisions;
+    OpeningBook *opening_book = 0; // the players may use an existing book
+    if (!options.get_opening_book_filename().empty())
+        opening_book = new OpeningBook(options.get_opening_book_filename());
+    Player *players[4];
+    for (int i = 0; i < 4; ++i)
+        players[i] = new OpeningBookBuildingPlayer(i, options, get_opening_book_for_player(opening_book, options, i), decisions);
+    RandomNumberGenerator rng(options.create_random_number_generator(DEALING_STREAM));
+    SessionProgress progress(options);
+    Cards cards[4];
+    while (progress.get_number_of_played_games() < options.get_number_of_games()) {
+        deal_cards(rng, cards);
+        for (int player = 0; player < 4; ++player)
+            players[player]->set_cards(cards[player]);
+        progress.start_game();
+        ActualGameState actual_game_state(options, players, progress.get_first_player(), cards,
+                                          progress.get_played_compulsory_solo(), progress.is_vorfuehrung(), 0);
+        int new_points[4] = { 0, 0, 0, 0 };
+        actual_game_state.get_score_points(new_points);
+        for (int i = 0; i < 4; ++i)
+            players[i]->inform_about_game_end(new_points);
+        progress.finish_game(actual_game_state);
+    }
+    for (int i = 0; i < 4; ++i)
+        delete players[i];
+    delete opening_book;
+
+    // store the move chosen most often for every key (the one with the smallest id among equally often chosen ones)
+    vector<uint64_t> entries;
+    int number_of_decisions = 0;
+    for (map<pair<uint64_t, int>, int>::const_iterator it = decisions.begin(); it != decisions.end(); ++it) {
+        number_of_decisions += it->second;
+        uint64_t key = it->first.first;
+        if (entries.empty() || (entries.back() >> 8) != key)
+            entries.push_back((key << 8) | it->first.second); // sorted because the map is sorted by keys
+        else if (it->second > decisions[make_pair(key, static_cast<int>(entries.back() & 0xff))])
+            entries.back() = (key << 8) | it->first.second;
+    }
+
+    OpeningBookHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, OPENING_BOOK_MAGIC, sizeof(OPENING_BOOK_MAGIC));
+    header.format_version = OPENING_BOOK_FORMAT_VERSION;
+    header.no_solo = options.solo_disabled();
+    header.compulsory_solo = options.use_compulsory_solo();
+    const vector<int> &player_options = options.get_player_options(0);
+    assert(player_options.size() <= sizeof(header.player_options) / sizeof(header.player_options[0]));
+    header.number_of_player_options = player_options.size();
+    for (size_t i = 0; i < player_options.size(); ++i)
+        header.player_options[i] = player_options[i];
+    header.number_of_entries = entries.size();
+
+    ofstream file(filename.c_str(), ios::binary);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(entries.data()), entries.size() * sizeof(uint64_t));
+    if (!file) {
+        cerr << "could not write opening book " << filename << endl;
+        exit(2);
+    }
+    cout << "opening book " << filename << " with " << entries.size() << " entries from " << number_of_decisions
+         << " decisions of " << options.get_number_of_games() << " games written" << endl;
+}
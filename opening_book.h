@@ -0,0 +1,83 @@
+/*
+  doko is a C++ doppelkopf program with an integrated UCT player.
+  Copyright (c) 2011-2016 Silvan Sievers
+  For questions, please write to: silvan.sievers@unibas.ch
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPENING_BOOK_H
+#define OPENING_BOOK_H
+
+#include "cards.h"
+#include "move.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+An opening book stores the decisions of uct players during game type determination (i.e. all question and game type moves) so that UctPlayer can look them up instead of running a Uct search at the start of every game.
+
+A decision is identified by a key computed from the profile of the player's hand (see below), the player's position relative to the first player of the game, which players (by position) already played their compulsory solo, whether the game is a vorfuehrung and the question and game type moves made so far in the game (together with the position of the player who made them). The key is a 56 bit hash of this information, which is stored together with the id of the chosen move (see Move::get_id()) in a single 64 bit entry.
+
+Apart from the two copies of a card, no two hands are strategically equivalent for all game types (e.g. exchanging clubs and spades changes a jacks solo, because the queen of clubs stays a club), thus a book keyed by exact hands would almost never contain the hand of a new deal. Instead, hands are abstracted to their profile, which consists of the number of queens of clubs, the number of trumps, high trumps (ten of hearts, queens of clubs and spades) and aces of the other suits in a regular game, the numbers of trumps of the hearts, spades and clubs solo (all numbers below 7 are merged), and the numbers of jacks, queens and aces (all numbers below 5 are merged). Hands with the same profile share their decisions, which makes the book an approximation of searching: it answers with the decision uct players took most often for hands of this profile in the same situation.
+
+The book file consists of a header (see below) followed by the entries sorted in increasing order. It is mapped into memory read-only and used as it is, i.e. opening a book of any size does not need any parsing. Because the decisions depend on the options of the session and of the uct player, these are stored in the header and a book is only used by players with the same options.
+
+Books are created by build_opening_book(), which plays the games of a session (with the same random cards) with four uct players using the options of player 0, counting for every key how often each move was chosen in game type determination decisions where a player has more than one option, and storing the move chosen most often. The rest of each game is played without searching.
+*/
+
+class Options;
+
+struct OpeningBookHeader {
+    char magic[8];
+    int32_t format_version;
+    int32_t no_solo;
+    int32_t compulsory_solo;
+    int32_t number_of_player_options;
+    int32_t player_options[31];
+    uint64_t number_of_entries;
+};
+
+class OpeningBook {
+private:
+    void *mapped_memory;
+    size_t mapped_size;
+    const OpeningBookHeader *header;
+    const uint64_t *entries;
+public:
+    explicit OpeningBook(const std::string &filename); // terminates the program if the file is not a valid opening book
+    ~OpeningBook();
+    bool is_compatible(const Options &options, int player) const; // true iff the book was built with the same options as used by player
+    int lookup(uint64_t key) const; // returns the move id stored for key or -1 if there is none
+    size_t size() const {
+        return header->number_of_entries;
+    }
+
+    static int get_history_entry(int position, const Move &move) { // position is relative to the first player of the game
+        return position * NUM_MOVE_IDS + move.get_id();
+    }
+    static uint64_t get_hand_profile(Cards cards); // the features of a hand the key is computed from, 4 bits each
+    static uint64_t compute_key(Cards cards, int position, const bool played_compulsory_solo[4], bool vorfuehrung,
+                                const std::vector<int> &history); // played_compulsory_solo is indexed by positions relative to the first player
+};
+
+/* the book to be used by uct player number player with options: book if it was built with the options of the player (see is_compatible()), otherwise 0 after a warning. book may be 0. added for sharing one book among all players of a session or a sweep */
+const OpeningBook *get_opening_book_for_player(const OpeningBook *book, const Options &options, int player);
+
+void build_opening_book(const Options &options, const std::string &filename); // plays as many games as a session would
+
+#endif
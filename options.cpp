@@ -19,20 +19,73 @@
 
 #include "options.h"
 
+#include "logging.h"
+
 #include <cassert>
 #include <iostream>
 #include <string>
 
 using namespace std;
 
+const int DEFAULT_PLAYER_OPTIONS[NUMBER_OF_PLAYER_OPTIONS] = { 1, 500, 1, 1, 20000, 1000, 10, 2, 0, 0, 0, 0, 0, 0, 0, 0 };
+
+string get_uct_player_options_error(const vector<int> &player_options) {
+    assert(player_options.size() == static_cast<size_t>(NUMBER_OF_PLAYER_OPTIONS));
+    if (player_options[0] != 0 && player_options[0] != 1)
+        return "version must be set to 0 or 1";
+    if (player_options[1] < 1)
+        return "score points factor must be greater 0";
+    if (player_options[2] != 0 && player_options[2] != 1)
+        return "using player's or team's points must be set to 0 or 1";
+    if (player_options[3] < 1)
+        return "playing points divisor must be greater 0";
+    if (player_options[4] < 1)
+        return "exploration constant must be greater 0";
+    if (player_options[5] < 1)
+        return "number of rollouts must be greater 0";
+    if (player_options[6] < 1)
+        return "number of simulations must be greater 0";
+    if (player_options[7] != 0 && player_options[7] != 1 && player_options[7] != 2)
+        return "announcement option must be set to 0, 1 or 2";
+    if (player_options[8] != 0 && player_options[8] != 1)
+        return "using wrong UCT formula must be set to 0 or 1";
+    if (player_options[9] != 0 && player_options[9] != 1)
+        return "using MC simulation must be set to 0 or 1";
+    if (player_options[10] < 0 || player_options[10] > 4)
+        return "action selection must be in the interval [0,4]";
+    if (player_options[11] < 0 || player_options[11] > 11)
+        return "rollout truncation must be in the interval [0,11]";
+    if (player_options[12] < 0)
+        return "node budget must not be negative";
+    if (player_options[13] != 0 && player_options[13] != 1)
+        return "root selection must be set to 0 or 1";
+    if (player_options[14] != 0 && player_options[14] != 1)
+        return "availability counts must be set to 0 or 1";
+    if (player_options[14] == 1 && player_options[0] != 1)
+        return "availability counts require version 1";
+    if (player_options[14] == 1 && player_options[8] == 1)
+        return "availability counts cannot be combined with the wrong UCT formula";
+    if (player_options[15] < 0)
+        return "card assignments limit must not be negative";
+    return "";
+}
+
 Options::Options(int number_of_games_, bool no_solo_, bool compulsory_solo_, const vector<player_t> &players_types_,
-                 bool random_cards_, int random_seed_, bool verbose_, bool uct_verbose_, bool debug_,
+                 bool random_cards_, int random_seed_, rng_t rng_type_, bool verbose_, bool uct_verbose_, bool debug_,
                  bool uct_debug_, const vector<vector<int> > &players_options_, bool create_graph_,
-                 int announcing_version_)
+                 int announcing_version_, const string &opening_book_filename_,
+                 const string &game_log_filename_)
                  : number_of_games(number_of_games_), no_solo(no_solo_), compulsory_solo(compulsory_solo_),
                    players_types(players_types_), random_cards(random_cards_), random_seed(random_seed_),
-                   verbose(verbose_), uct_verbose(uct_verbose_), debug(debug_), uct_debug(uct_debug_),
-                   players_options(players_options_), create_graph(create_graph_), announcing_version(announcing_version_) {
+                   rng_type(rng_type_), verbose(verbose_), uct_verbose(uct_verbose_), debug(debug_), uct_debug(uct_debug_),
+                   players_options(players_options_), create_graph(create_graph_), announcing_version(announcing_version_),
+                   opening_book_filename(opening_book_filename_), game_log_filename(game_log_filename_) {
+}
+
+RandomNumberGenerator Options::create_random_number_generator(rng_stream_t stream, int player) const {
+    if (rng_type == MERSENNE_TWISTER) // older versions seeded the generators of everything but dealing with 2011
+        return RandomNumberGenerator(stream == DEALING_STREAM ? random_seed : 2011, 0, MERSENNE_TWISTER);
+    return RandomNumberGenerator(random_seed, stream + player);
 }
 
 bool Options::specify_cards_manually(Cards cards[4]) const {
@@ -121,58 +174,81 @@ bool Options::specify_cards_manually(Cards cards[4]) const {
 }
 
 void print(const string &output, bool value) {
-    cout << output << (value ? "yes" : "no") << endl;
+    log_stream() << output << (value ? "yes" : "no") << '\n';
 }
 
 void Options::dump() const {
-    cout << "Chosen options for the session:" << endl;
-    cout << "Number of games: " << number_of_games << endl;
+    log_stream() << "Chosen options for the session:\n";
+    log_stream() << "Number of games: " << number_of_games << '\n';
     print("Solo playing disabled: ", no_solo);
     print("Play compulsory solos: ", compulsory_solo);
     print("Random cards: ", random_cards);
-    cout << "Random seed: " << random_seed << endl;
-    cout << "Announcing version: " << announcing_version << endl;
+    log_stream() << "Random seed: " << random_seed << '\n';
+    log_stream() << "Random number generator: " << (rng_type == XOSHIRO ? "xoshiro" : "mersenne twister") << '\n';
+    log_stream() << "Announcing version: " << announcing_version << '\n';
+    if (!opening_book_filename.empty())
+        log_stream() << "Opening book: " << opening_book_filename << '\n';
+    if (!game_log_filename.empty())
+        log_stream() << "Game log: " << game_log_filename << '\n';
     //print("Verbose: ", verbose);
     for (size_t i = 0; i < players_types.size(); ++i) {
-        cout << "\nPlayer " << i << "'s type: ";
+        log_stream() << "\nPlayer " << i << "'s type: ";
         switch (players_types[i]) {
             case UCT:
-                cout << "UCT" << endl;
+                log_stream() << "UCT\n";
                 //print("Uct verbose: ", uct_verbose);
                 //print("Debug: ", debug);
-                cout << "UCT version: " << players_options[i][0] << endl;
-                cout << "Score points constant: " << players_options[i][1] << endl;
+                log_stream() << "UCT version: " << players_options[i][0] << '\n';
+                log_stream() << "Score points constant: " << players_options[i][1] << '\n';
                 print("Use team's points instead of player's points: ", players_options[i][2]);
-                cout << "Playing points constant: " << players_options[i][3] << endl;
-                cout << "Exploration constant: " << players_options[i][4] << endl;
-                cout << "Number of rollouts: " << players_options[i][5] << endl;
+                log_stream() << "Playing points constant: " << players_options[i][3] << '\n';
+                log_stream() << "Exploration constant: " << players_options[i][4] << '\n';
+                log_stream() << "Number of rollouts: " << players_options[i][5] << '\n';
                 if (players_options[i][0] == 0)
-                    cout << "Number of simulations: " << players_options[i][6] << endl;
-                cout << "Announcement rule: ";
+                    log_stream() << "Number of simulations: " << players_options[i][6] << '\n';
+                log_stream() << "Announcement rule: ";
                 switch (players_options[i][7]) {
                     case 0:
-                        cout << "no" << endl;
+                        log_stream() << "no\n";
                         break;
                     case 1:
-                        cout << "yes" << endl;
+                        log_stream() << "yes\n";
                         break;
                     case 2:
-                        cout << "only +" << endl;
+                        log_stream() << "only +\n";
                         break;
                     default:
                         assert(false);
                 }
                 print("Use wrong UCT formula: ", players_options[i][8]);
                 print("Use MC simulation: ", players_options[i][9]);
-                cout << "Action selection: " << players_options[i][10] << endl;
+                log_stream() << "Action selection: " << players_options[i][10] << '\n';
+                if (players_options[i][11] == 0)
+                    log_stream() << "Rollout truncation: no\n";
+                else
+                    log_stream() << "Rollout truncation: after " << players_options[i][11] << " tricks\n";
+                if (players_options[i][12] == 0)
+                    log_stream() << "Node budget: no\n";
+                else
+                    log_stream() << "Node budget: " << players_options[i][12] << " nodes\n";
+                log_stream() << "Root selection: " << (players_options[i][13] == 1 ? "sequential halving" : "uct formula") << '\n';
+                if (players_options[i][0] == 1)
+                    print("Use availability counts: ", players_options[i][14]);
+                if (players_options[i][15] == 0)
+                    log_stream() << "Enumerate card assignments: no\n";
+                else
+                    log_stream() << "Enumerate card assignments: up to " << players_options[i][15] << '\n';
                 break;
             case HUMAN:
-                cout << "Human" << endl;
+                log_stream() << "Human\n";
                 break;
             case RANDOM:
-                cout << "Random" << endl;
+                log_stream() << "Random\n";
+                break;
+            case HEURISTIC:
+                log_stream() << "Heuristic\n";
                 break;
         }
     }
-    cout << endl;
+    log_stream() << '\n';
 }
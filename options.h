@@ -21,13 +21,30 @@
 #define OPTIONS_H
 
 #include "cards.h"
+#include "rng.h"
 
+#include <string>
 #include <vector>
 
 enum player_t {
     UCT,
     HUMAN,
-    RANDOM
+    RANDOM,
+    HEURISTIC
+};
+
+// the options of a uct player, see --print-player-options. moved from main.cpp for the analysis server
+const int NUMBER_OF_REQUIRED_PLAYER_OPTIONS = 11;
+const int NUMBER_OF_PLAYER_OPTIONS = 16;
+extern const int DEFAULT_PLAYER_OPTIONS[NUMBER_OF_PLAYER_OPTIONS];
+std::string get_uct_player_options_error(const std::vector<int> &player_options); // empty if the options are valid
+
+// the users of random numbers, each one with its own stream of the random seed (see RandomNumberGenerator) such that they do not influence each other
+enum rng_stream_t {
+    DEALING_STREAM = 0,
+    RANDOM_PLAYER_STREAM = 1, // one stream per player
+    UCT_STREAM = 5, // one stream per player
+    CARD_ASSIGNMENT_STREAM = 9 // one stream per player
 };
 
 class Options {
@@ -38,6 +55,7 @@ private:
     std::vector<player_t> players_types;
     bool random_cards;
     int random_seed;
+    rng_t rng_type;
     bool verbose;
     bool uct_verbose;
     bool debug;
@@ -45,10 +63,13 @@ private:
     std::vector<std::vector<int> > players_options;
     bool create_graph;
     int announcing_version;
+    std::string opening_book_filename;
+    std::string game_log_filename;
 public:
     Options(int number_of_games, bool no_solo, bool compulsory_solo, const std::vector<player_t> &players_types,
-            bool random, int random_seed, bool verbose, bool uct_verbose, bool debug, bool uct_debug,
-            const std::vector<std::vector<int> > &players_options, bool create_graph, int announcing_version);
+            bool random, int random_seed, rng_t rng_type, bool verbose, bool uct_verbose, bool debug, bool uct_debug,
+            const std::vector<std::vector<int> > &players_options, bool create_graph, int announcing_version,
+            const std::string &opening_book_filename, const std::string &game_log_filename);
     int get_number_of_games() const {
         return number_of_games;
     }
@@ -67,6 +88,10 @@ public:
     int get_random_seed() const {
         return random_seed;
     }
+    rng_t get_rng_type() const { // added for the analysis server
+        return rng_type;
+    }
+    RandomNumberGenerator create_random_number_generator(rng_stream_t stream, int player = 0) const;
     bool use_verbose() const {
         return verbose;
     }
@@ -79,6 +104,9 @@ public:
     bool use_uct_debug() const {
         return uct_debug;
     }
+    const std::vector<int> &get_player_options(int player) const { // added for OpeningBook
+        return players_options[player];
+    }
     int get_uct_version(int player) const {
         return players_options[player][0];
     }
@@ -112,12 +140,33 @@ public:
     int get_action_selection_version(int player) const {
         return players_options[player][10];
     }
+    int get_rollout_truncation(int player) const { // number of simulated tricks after which a rollout is evaluated statically, 0 if rollouts always simulate until the end of the game
+        return players_options[player][11];
+    }
+    int get_node_budget(int player) const { // maximum number of nodes of a uct tree, 0 if unlimited
+        return players_options[player][12];
+    }
+    bool use_sequential_halving(int player) const { // at the root instead of the uct formula
+        return players_options[player][13] == 1;
+    }
+    bool use_availability_counts(int player) const { // uct version 1 only: the uct formula counts how often a successor was legal rather than how often its parent was visited
+        return players_options[player][14] == 1;
+    }
+    int get_card_assignments_limit(int player) const { // if there are at most this many card assignments consistent with the game, uct searches all of them instead of sampling, 0 if never
+        return players_options[player][15];
+    }
     bool use_create_graph() const {
         return create_graph;
     }
     int get_announcing_version() const {
         return announcing_version;
     }
+    const std::string &get_opening_book_filename() const { // empty if no opening book is used
+        return opening_book_filename;
+    }
+    const std::string &get_game_log_filename() const { // empty if the session does not write a game log
+        return game_log_filename;
+    }
     bool specify_cards_manually(Cards cards[4]) const; // return true iff user specifies cards manually, false iff he decides to use a random distribution
     void dump() const;
 };
@@ -25,6 +25,9 @@
 
 #include <vector>
 
+class CheckpointReader;
+class CheckpointWriter;
+
 class Player {
 protected:
     const int id; // player's unique number, from 0 to 3
@@ -38,6 +41,9 @@ public:
     void invalid_move() const;
     virtual void inform_about_move(int player, const Move &move);
     virtual void inform_about_game_end(const int players_game_points[4]) {}
+    // added for checkpoints: the state the player keeps from game to game, read back by a player created with the same options
+    virtual void write_checkpoint(CheckpointWriter &writer) const {}
+    virtual void read_checkpoint(CheckpointReader &reader) {}
 };
 
 #endif
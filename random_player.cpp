@@ -19,12 +19,16 @@
 
 #include "random_player.h"
 
+#include "checkpoint.h"
+#include "options.h"
+
 #include <cassert>
 #include <iostream>
 
 using namespace std;
 
-RandomPlayer::RandomPlayer(int player_number) : Player(player_number), rng(2011) {
+RandomPlayer::RandomPlayer(int player_number, const Options &options)
+    : Player(player_number), rng(options.create_random_number_generator(RANDOM_PLAYER_STREAM, player_number)) {
 }
 
 size_t RandomPlayer::ask_for_move(const vector<Move> &legal_moves) {
@@ -42,3 +46,11 @@ size_t RandomPlayer::ask_for_move(const vector<Move> &legal_moves) {
     assert(false);
     return 0;
 }
+
+void RandomPlayer::write_checkpoint(CheckpointWriter &writer) const {
+    writer.write_rng(rng);
+}
+
+void RandomPlayer::read_checkpoint(CheckpointReader &reader) {
+    reader.read_rng(rng);
+}
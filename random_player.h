@@ -23,12 +23,16 @@
 #include "player.h"
 #include "rng.h"
 
+class Options;
+
 class RandomPlayer : public Player {
 private:
     mutable RandomNumberGenerator rng;
 public:
-    explicit RandomPlayer(int player_number);
+    RandomPlayer(int player_number, const Options &options);
     size_t ask_for_move(const std::vector<Move> &legal_moves);
+    void write_checkpoint(CheckpointWriter &writer) const;
+    void read_checkpoint(CheckpointReader &reader);
 };
 
 #endif
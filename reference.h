@@ -0,0 +1,457 @@
+/*
+  doko is a C++ doppelkopf program with an integrated UCT player.
+  Copyright (c) 2011-2016 Silvan Sievers
+  For questions, please write to: silvan.sievers@unibas.ch
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+  The original implementations of operations which have been replaced by
+  faster ones, kept as references: test.cpp checks that both give the same
+  results and benchmark.cpp compares their speed. They only use the public
+  interfaces of the classes and are not part of the engine.
+*/
+
+#ifndef REFERENCE_H
+#define REFERENCE_H
+
+#include "belief_game_state.h"
+#include "cards.h"
+#include "game_type.h"
+#include "move.h"
+#include "trick.h"
+
+#include <cassert>
+#include <set>
+#include <vector>
+
+// the original tables of GameType, built for every game type by hand, the reference for the compile time tables of game_type.cpp
+struct GameTypeReference {
+    Cards trump_suit;
+    std::vector<Cards> non_trump_suits;
+    unsigned int card_to_trump_rank[48]; // maps a trump card to its rank (all other entries for non trump cards are invalid/not set!)
+    Cards card_to_suit[48]; // maps a card to its suit (either trump_suit or one of non_trump_suits)
+
+    explicit GameTypeReference(int type) {
+        if (type <= GameType::CLUBS_SOLO) { // regular, marriage or color solo => hearts 10s, queens and jacks are trump and there are 3 non trump suits
+            trump_suit.add_cards(hearts10s);
+            card_to_trump_rank[H1.get_index()] = 1;
+            card_to_trump_rank[H1_.get_index()] = 1;
+            trump_suit.add_cards(queens);
+            card_to_trump_rank[CQ.get_index()] = 2;
+            card_to_trump_rank[CQ_.get_index()] = 2;
+            card_to_trump_rank[SQ.get_index()] = 3;
+            card_to_trump_rank[SQ_.get_index()] = 3;
+            card_to_trump_rank[HQ.get_index()] = 4;
+            card_to_trump_rank[HQ_.get_index()] = 4;
+            card_to_trump_rank[DQ.get_index()] = 5;
+            card_to_trump_rank[DQ_.get_index()] = 5;
+            trump_suit.add_cards(jacks);
+            card_to_trump_rank[CJ.get_index()] = 6;
+            card_to_trump_rank[CJ_.get_index()] = 6;
+            card_to_trump_rank[SJ.get_index()] = 7;
+            card_to_trump_rank[SJ_.get_index()] = 7;
+            card_to_trump_rank[HJ.get_index()] = 8;
+            card_to_trump_rank[HJ_.get_index()] = 8;
+            card_to_trump_rank[DJ.get_index()] = 9;
+            card_to_trump_rank[DJ_.get_index()] = 9;
+            non_trump_suits.resize(3);
+            if (type <= GameType::DIAMONDS_SOLO) { // regular, marriage or diamonds solo => all with the same trump/non trump suits
+                trump_suit.add_cards(diamonds);
+                card_to_trump_rank[DA.get_index()] = 10;
+                card_to_trump_rank[DA_.get_index()] = 10;
+                card_to_trump_rank[D1.get_index()] = 11;
+                card_to_trump_rank[D1_.get_index()] = 11;
+                card_to_trump_rank[DK.get_index()] = 12;
+                card_to_trump_rank[DK_.get_index()] = 12;
+                card_to_trump_rank[D9.get_index()] = 13;
+                card_to_trump_rank[D9_.get_index()] = 13;
+                non_trump_suits[0] = hearts;
+                non_trump_suits[1] = spades;
+                non_trump_suits[2] = clubs;
+            } else if (type == GameType::HEARTS_SOLO) {
+                trump_suit.add_cards(hearts);
+                card_to_trump_rank[HA.get_index()] = 10;
+                card_to_trump_rank[HA_.get_index()] = 10;
+                card_to_trump_rank[HK.get_index()] = 11;
+                card_to_trump_rank[HK_.get_index()] = 11;
+                card_to_trump_rank[H9.get_index()] = 12;
+                card_to_trump_rank[H9_.get_index()] = 12;
+                non_trump_suits[0] = diamonds;
+                non_trump_suits[1] = spades;
+                non_trump_suits[2] = clubs;
+            } else if (type == GameType::SPADES_SOLO) {
+                trump_suit.add_cards(spades);
+                card_to_trump_rank[SA.get_index()] = 10;
+                card_to_trump_rank[SA_.get_index()] = 10;
+                card_to_trump_rank[S1.get_index()] = 11;
+                card_to_trump_rank[S1_.get_index()] = 11;
+                card_to_trump_rank[SK.get_index()] = 12;
+                card_to_trump_rank[SK_.get_index()] = 12;
+                card_to_trump_rank[S9.get_index()] = 13;
+                card_to_trump_rank[S9_.get_index()] = 13;
+                non_trump_suits[0] = diamonds;
+                non_trump_suits[1] = hearts;
+                non_trump_suits[2] = clubs;
+            } else if (type == GameType::CLUBS_SOLO) {
+                trump_suit.add_cards(clubs);
+                card_to_trump_rank[CA.get_index()] = 10;
+                card_to_trump_rank[CA_.get_index()] = 10;
+                card_to_trump_rank[C1.get_index()] = 11;
+                card_to_trump_rank[C1_.get_index()] = 11;
+                card_to_trump_rank[CK.get_index()] = 12;
+                card_to_trump_rank[CK_.get_index()] = 12;
+                card_to_trump_rank[C9.get_index()] = 13;
+                card_to_trump_rank[C9_.get_index()] = 13;
+                non_trump_suits[0] = diamonds;
+                non_trump_suits[1] = hearts;
+                non_trump_suits[2] = spades;
+            }
+        } else { // jacks, queens or aces solo => all colors (except jacks/queens) are non trump suits
+            non_trump_suits.resize(4);
+            non_trump_suits[0] = diamonds;
+            non_trump_suits[1] = hearts;
+            non_trump_suits[1].add_cards(hearts10s); // include hearts 10s in the hearts suit
+            non_trump_suits[2] = spades;
+            non_trump_suits[3] = clubs;
+            if (type == GameType::JACKS_SOLO || type == GameType::ACES_SOLO) { // jacks or aces solo => add queens to non trump suits
+                // include all queens to their respective suit
+                non_trump_suits[0].add_card(DQ);
+                non_trump_suits[0].add_card(DQ_);
+                non_trump_suits[1].add_card(HQ);
+                non_trump_suits[1].add_card(HQ_);
+                non_trump_suits[2].add_card(SQ);
+                non_trump_suits[2].add_card(SQ_);
+                non_trump_suits[3].add_card(CQ);
+                non_trump_suits[3].add_card(CQ_);
+                if (type == GameType::JACKS_SOLO) {
+                    trump_suit.add_cards(jacks);
+                    card_to_trump_rank[CJ.get_index()] = 1;
+                    card_to_trump_rank[CJ_.get_index()] = 1;
+                    card_to_trump_rank[SJ.get_index()] = 2;
+                    card_to_trump_rank[SJ_.get_index()] = 2;
+                    card_to_trump_rank[HJ.get_index()] = 3;
+                    card_to_trump_rank[HJ_.get_index()] = 3;
+                    card_to_trump_rank[DJ.get_index()] = 4;
+                    card_to_trump_rank[DJ_.get_index()] = 4;
+                }
+            }
+            if (type == GameType::QUEENS_SOLO || type == GameType::ACES_SOLO) { // queens or aces solo => add jacks to non trump suits
+                // include all jacks to their respective suit
+                non_trump_suits[0].add_card(DJ);
+                non_trump_suits[0].add_card(DJ_);
+                non_trump_suits[1].add_card(HJ);
+                non_trump_suits[1].add_card(HJ_);
+                non_trump_suits[2].add_card(SJ);
+                non_trump_suits[2].add_card(SJ_);
+                non_trump_suits[3].add_card(CJ);
+                non_trump_suits[3].add_card(CJ_);
+                if (type == GameType::QUEENS_SOLO) {
+                    trump_suit.add_cards(queens);
+                    card_to_trump_rank[CQ.get_index()] = 1;
+                    card_to_trump_rank[CQ_.get_index()] = 1;
+                    card_to_trump_rank[SQ.get_index()] = 2;
+                    card_to_trump_rank[SQ_.get_index()] = 2;
+                    card_to_trump_rank[HQ.get_index()] = 3;
+                    card_to_trump_rank[HQ_.get_index()] = 3;
+                    card_to_trump_rank[DQ.get_index()] = 4;
+                    card_to_trump_rank[DQ_.get_index()] = 4;
+                }
+            }
+        }
+
+        // initialize card_to_suit
+        for (int i = 0; i < 48; i++) {
+            Card card(i);
+            if (trump_suit.contains_card(card)) {
+                card_to_suit[card.get_index()] = trump_suit;
+            }
+            else {
+                for (size_t j = 0; j < non_trump_suits.size(); ++j) {
+                    if (non_trump_suits[j].contains_card(card)) {
+                        card_to_suit[card.get_index()] = non_trump_suits[j];
+                    }
+                }
+            }
+        }
+    }
+
+    unsigned int get_rank(Card card) const {
+        // the rank of a non trump card in its suit is the same for all game types: ace, 10, king, queen, jack, 9 for all colors, where ace has the highest rank (i.e. rank 1)
+        static const unsigned int card_to_non_trump_rank[48] = {
+            6, 6, 3, 3, 1, 1,
+            6, 6, 3, 3, 2, 2, 1, 1,
+            6, 6, 3, 3, 2, 2, 1, 1,
+            6, 6, 3, 3, 2, 2, 1, 1,
+            5, 5, 5, 5, 5, 5, 5, 5,
+            4, 4, 4, 4, 4, 4, 4, 4,
+            2, 2
+        };
+        if (trump_suit.contains_card(card))
+            return card_to_trump_rank[card.get_index()];
+        return card_to_non_trump_rank[card.get_index()];
+    }
+};
+
+inline const GameTypeReference &get_game_type_reference(const GameType *game_type) {
+    static const GameTypeReference references[GameType::NUMBER_OF_GAME_TYPES] = {
+        GameTypeReference(0), GameTypeReference(1), GameTypeReference(2), GameTypeReference(3), GameTypeReference(4),
+        GameTypeReference(5), GameTypeReference(6), GameTypeReference(7), GameTypeReference(8)
+    };
+    return references[game_type->get_index()];
+}
+
+// the original implementation of Trick::get_legal_cards, which looks up the suits in the original tables of GameType
+inline Cards get_legal_cards_reference(const GameType *game_type, const Trick &trick, Cards players_cards) {
+    const GameTypeReference &reference = get_game_type_reference(game_type);
+    if (trick.empty()) // new trick => player can play any of his cards
+        return players_cards;
+    assert(trick.get_card(trick.get_first_player()) != no_card);
+    Cards trick_suit = reference.card_to_suit[trick.get_card(trick.get_first_player()).get_index()];
+    Cards players_cards_for_current_suit = players_cards.get_intersection(trick_suit);
+    if (!players_cards_for_current_suit.empty()) // if player has one or more cards of the trick's suit, he has to play one of it
+        return players_cards_for_current_suit;
+    return players_cards; // otherwise he can play any of his cards (this includes trump or non-trump)
+}
+
+// the original implementation of Trick::taken_by on the original tables of GameType
+inline int taken_by_reference(const GameType *game_type, const Trick &trick) {
+    const GameTypeReference &reference = get_game_type_reference(game_type);
+    int first_player = trick.get_first_player();
+    //assert(get_size() == 4); // allow BeliefGameState to compute who wins the trick even if has not been completed (for heuristic move computation) or if some card slots are filled by dummy no_card cards
+    assert(!trick.empty());
+    Card highest_card_so_far = trick.get_card(first_player); // first card is the highest so far
+    int player_it = first_player;
+    int winning_player = first_player;
+    Cards trump_suit = reference.trump_suit;
+    for (int i = 0; i < 3; ++i) { // iterate over the three other cards
+        player_it = next_player(player_it);
+        Card card = trick.get_card(player_it);
+        if (card == no_card) // skip a dummy card
+            continue;
+        if (trump_suit.contains_card(highest_card_so_far)) { // current highest card is a trump card
+            if (!trump_suit.contains_card(card)) // player didn't play trump, he can't win the trick
+                continue;
+            if (reference.get_rank(card) >= reference.get_rank(highest_card_so_far)) {
+                // card's rank is lower or equal (higher number) than highest card's rank
+                continue;
+            }
+            // else
+            highest_card_so_far = card;
+            winning_player = player_it;
+            continue;
+        }
+
+        // else: no trump in the trick so far
+        assert(reference.card_to_suit[trick.get_card(first_player).get_index()].contains_card(highest_card_so_far)); // the highest card so far must be the highest card of the trick's suit (which is determined by first player's card)
+        if (trump_suit.contains_card(card)) { // card is trump, i.e. it wins
+            highest_card_so_far = card;
+            winning_player = player_it;
+            continue;
+        }
+        if (!reference.card_to_suit[trick.get_card(first_player).get_index()].contains_card(card)) // player didn't play the same suit (but no trump)
+            continue;
+        // player played the same suit, compare ranks
+        if (reference.get_rank(card) >= reference.get_rank(highest_card_so_far)) {
+            // card's rank is lower or equal (higher number) than highest card's rank
+            continue;
+        }
+        // else
+        highest_card_so_far = card;
+        winning_player = player_it;
+        continue;
+    }
+    return winning_player;
+}
+
+// the index of the first of possible_cards with the highest value
+inline int play_valuable_card_reference(const std::vector<Card> &possible_cards) {
+    int value_to_check = 11;
+    while (true) {
+        // iterate over all cards searching for a card worth value_to_check points. if not successful, decrease value_to_check and repeat.
+        for (size_t i = 0; i < possible_cards.size(); ++i) {
+            if (possible_cards[i].get_value() == value_to_check)
+                return i;
+        }
+        if (value_to_check == 11 || value_to_check == 4 || value_to_check == 3)
+            --value_to_check;
+        else if (value_to_check == 10)
+            value_to_check = 4;
+        else if (value_to_check == 2)
+            value_to_check = 0;
+        else
+            assert(false);
+    }
+}
+
+// the original implementation of BeliefGameState::get_best_move_index which simulates the trick using vectors of moves
+inline int get_best_move_index_reference(const BeliefGameState &state, const std::vector<Move> &legal_moves) {
+    const GameType *game_type = state.get_game_type();
+    int player_to_move = state.get_player_to_move();
+    assert(legal_moves[0].is_card_move());
+    int trick_size = state.get_current_trick().get_size();
+    if (!state.get_current_trick().empty()) {
+        assert(trick_size < 4);
+        int trick_taken_by = state.get_current_trick().taken_by();
+        //cout << "trick taken by so far: " << trick_taken_by << endl;
+        if (state.get_players_team(trick_taken_by) == state.get_players_team(player_to_move)) {
+            // trick is owned by a teammate so far, check if a player of the other team can play a higher card
+            Trick current_trick(state.get_current_trick());
+            current_trick.set_card(player_to_move, no_card);
+            int player_it = next_player(player_to_move);
+            for (int i = 0; i < 4 - trick_size - 1; ++i) {
+                if (state.get_players_team(player_it) == state.get_players_team(player_to_move)) {
+                    // play dummy card if player is in the same team
+                    current_trick.set_card(player_it, no_card);
+                } else {
+                    std::vector<Move> legal_cards;
+                    current_trick.get_legal_cards_for_player(player_it, legal_cards, state.get_remaining_cards(player_it));
+                    // search for the highest ranked card the player can play
+                    unsigned int highest_card_rank = game_type->get_rank(legal_cards[0].get_card());
+                    size_t highest_card_rank_index = 0;
+                    for (size_t k = 1; k < legal_cards.size(); ++k) {
+                        Card legal_card = legal_cards[k].get_card();
+                        if (game_type->get_rank(legal_card) < highest_card_rank ||
+                            (game_type->is_trump(legal_card) && !game_type->is_trump(legal_cards[highest_card_rank_index].get_card()))) {
+                            // the second check allows a lower rank of a trump card to be of global higher rank if the highest ranked card so far is a non trump) {
+                            highest_card_rank = game_type->get_rank(legal_card);
+                            highest_card_rank_index = k;
+                        }
+                    }
+                    current_trick.set_card(player_it, legal_cards[highest_card_rank_index].get_card());
+                }
+                player_it = next_player(player_it);
+            }
+            int trick_now_taken_by = current_trick.taken_by();
+            if (trick_taken_by == trick_now_taken_by) {
+                // trick is safe, player is free to play any valuable card
+                std::vector<Card> possible_cards;
+                for (size_t i = 0; i < legal_moves.size(); ++i) {
+                    possible_cards.push_back(legal_moves[i].get_card());
+                }
+                int chosen_index = play_valuable_card_reference(possible_cards);
+                //cout << "returning index of a valuable card for a safe trick: " << chosen_index << endl;
+                return chosen_index;
+            }
+            //cout << "but not safe" << endl;
+        }
+    }
+
+    // ending up here means that either the current trick is empty (i.e. player to move starts a new trick) or the trick contains one or more cards already, but it is not owned by a teammate of player to move so far or it is not safe because another player can still play a higher card.
+    std::vector<int> safe_card_indices; // set of indices of safe cards that win the trick
+    std::set<Cards> safe_suits; // set of safe suits to play because a teammate can win the trick
+    for (size_t i = 0; i < legal_moves.size(); ++i) {
+        Card current_card = legal_moves[i].get_card();
+        Trick current_trick1(state.get_current_trick());
+        current_trick1.set_card(player_to_move, current_card); // every player plays his highest card into this trick
+        Trick current_trick2(state.get_current_trick());
+        current_trick2.set_card(player_to_move, current_card); // only opponent players play their highest card into this trick, i.e. in the end, if the trick is owned by player to move, the card is a safe card.
+        // iterate over the next players, let them play their highest ranked legal card. if player_to_move wins the trick, the card played is a safe card; if a teammate wins the trick, the played card's suit is safe and otherwise, no good card can be played.
+        int player_it = next_player(player_to_move);
+        for (int j = 0; j < 4 - trick_size - 1; ++j) {
+            std::vector<Move> legal_cards;
+            current_trick1.get_legal_cards_for_player(player_it, legal_cards, state.get_remaining_cards(player_it));
+            // search for the highest ranked card the player can play
+            unsigned int highest_card_rank = game_type->get_rank(legal_cards[0].get_card());
+            size_t highest_card_rank_index = 0;
+            for (size_t k = 1; k < legal_cards.size(); ++k) {
+                Card legal_card = legal_cards[k].get_card();
+                if (game_type->get_rank(legal_card) < highest_card_rank ||
+                    (game_type->is_trump(legal_card) && !game_type->is_trump(legal_cards[highest_card_rank_index].get_card()))) {
+                    // the second check allows a lower rank of a trump card to be of global higher rank if the highest ranked card so far is a non trump
+                    highest_card_rank = game_type->get_rank(legal_card);
+                    highest_card_rank_index = k;
+                }
+            }
+            if (state.get_players_team(player_it) != state.get_players_team(player_to_move)) {
+                current_trick2.set_card(player_it, legal_cards[highest_card_rank_index].get_card());
+            } else {
+                current_trick2.set_card(player_it, no_card);
+            }
+            current_trick1.set_card(player_it, legal_cards[highest_card_rank_index].get_card());
+            player_it = next_player(player_it);
+        }
+        int trick1_taken_by = current_trick1.taken_by();
+        int trick2_taken_by = current_trick2.taken_by();
+        if (trick2_taken_by == player_to_move) {
+            // player to move can play a safe card that wins the trick
+            safe_card_indices.push_back(i);
+        } else {
+            assert(trick1_taken_by != player_to_move); // if player to move did not win trick 2, he cannot have won trick 1 where more players have played their cards.
+            if (state.get_players_team(trick1_taken_by) == state.get_players_team(player_to_move)) {
+                // a teammate of player to move won the trick, i.e. the played card's suit is safe to play
+                safe_suits.insert(game_type->get_suit(current_card));
+            }
+        }
+    }
+
+    // iterate over all safe cards
+    for (size_t i = 0; i < safe_card_indices.size(); ++i) {
+        Card current_card = legal_moves[safe_card_indices[i]].get_card();
+        if (game_type->is_trump(current_card)) // prefer to play a safe non trump card over playing a safe trump card
+            continue;
+        int chosen_index = safe_card_indices[i];
+        //cout << "returning index of a safe non trump card:  " << chosen_index << endl;
+        return chosen_index;
+    }
+    // if we are here, then because all safe cards are only trump cards or because there are no safe cards at all. we even prefer playing a safe suit where a teammate can win the trick over playing a safe trump card because playing a high trump card is many times a waste.
+    for (std::set<Cards>::const_iterator it = safe_suits.begin(); it != safe_suits.end(); ++it) {
+        if (*it == game_type->get_trump_suit()) // prefer playing a safe non trump suit over playing trump
+            continue;
+        std::vector<Card> possible_cards;
+        std::vector<size_t> index_to_index(legal_moves.size());
+        for (size_t i = 0; i < legal_moves.size(); ++i) {
+            Card current_card = legal_moves[i].get_card();
+            if (it->contains_card(current_card)) {
+                possible_cards.push_back(current_card);
+                index_to_index[possible_cards.size() - 1] = i;
+            }
+        }
+        int chosen_index = play_valuable_card_reference(possible_cards);
+        chosen_index = index_to_index[chosen_index];
+        //cout << "returning index of a valuable card for safe non trump suit: " << chosen_index << endl;
+        return chosen_index;
+    }
+    // if we are here, then because all safe cards are only trump cards or because there are no safe cards at all and because the only safe suit to play is the trump suit or because there is no safe suit at all. prefer playing a safe trump card if exists over playing a low trump card.
+    if (!safe_card_indices.empty()) {
+        int chosen_index = safe_card_indices.front(); // legal moves are ordered in ascending rank order and thus the first element in safe_card_indices is the lowest safe trump card
+        // TODO: better play valuable safe low trump card
+        assert(game_type->is_trump(legal_moves[chosen_index].get_card()));
+        //cout << "returning index of a safe trump card: " << chosen_index << endl;
+        return chosen_index;
+    }
+    // if we are here, then because there is no safe card at all and no safe non trump suit.
+    if (!safe_suits.empty()) {
+        assert(safe_suits.size() == 1); // only the trump suit can be a safe suit
+        assert(*safe_suits.begin() == game_type->get_trump_suit());
+        std::vector<Card> possible_cards;
+        std::vector<size_t> index_to_index(legal_moves.size());
+        for (size_t i = 0; i < legal_moves.size(); ++i) {
+            Card current_card = legal_moves[i].get_card();
+            if (safe_suits.begin()->contains_card(current_card)) {
+                possible_cards.push_back(current_card);
+                index_to_index[possible_cards.size() - 1] = i;
+            }
+        }
+        int chosen_index = play_valuable_card_reference(possible_cards);
+        chosen_index = index_to_index[chosen_index];
+        //cout << "returning index of a valuable card for safe trump suit: " << chosen_index << endl;
+        return chosen_index;
+    }
+    // if we are here, then because there is neither a safe card nor a safe suit to play.
+    return -1;
+}
+
+#endif
@@ -6,6 +6,9 @@
   Mersenne Twister Random Number Generator.
   Based on the C Code by Takuji Nishimura and Makoto Matsumoto.
   http://www.math.keio.ac.jp/~matumoto/emt.html
+
+  xoshiro256** and its jump function are based on the C code by David
+  Blackman and Sebastiano Vigna, http://prng.di.unimi.it
 */
 
 #include "rng.h"
@@ -19,33 +22,33 @@ static const unsigned int MATRIX_A = 0x9908b0dfU;
 static const unsigned int UPPER_MASK = 0x80000000U;
 static const unsigned int LOWER_MASK = 0x7fffffffU;
 
-RandomNumberGenerator::RandomNumberGenerator() {
+MersenneTwister::MersenneTwister() {
     seed(static_cast<int>(time(0)));
 }
 
-RandomNumberGenerator::RandomNumberGenerator(int s) {
+MersenneTwister::MersenneTwister(int s) {
     seed(s);
 }
 
-RandomNumberGenerator::RandomNumberGenerator(
+MersenneTwister::MersenneTwister(
     unsigned int *init_key, int key_length) {
     seed(init_key, key_length);
 }
 
-RandomNumberGenerator::RandomNumberGenerator(
-    const RandomNumberGenerator &copy) {
+MersenneTwister::MersenneTwister(
+    const MersenneTwister &copy) {
     *this = copy;
 }
 
-RandomNumberGenerator & RandomNumberGenerator::operator=(
-    const RandomNumberGenerator &copy) {
+MersenneTwister & MersenneTwister::operator=(
+    const MersenneTwister &copy) {
     for (int i = 0; i < N; ++i)
         mt[i] = copy.mt[i];
     mti = copy.mti;
     return *this;
 }
 
-void RandomNumberGenerator::seed(int se) {
+void MersenneTwister::seed(int se) {
     unsigned int s = (static_cast<unsigned int>(se) << 1) + 1;
     // Seeds should not be zero. Other possible solutions (such as s |= 1)
     // lead to more confusion, because often-used low seeds like 2 and 3 would
@@ -58,7 +61,7 @@ void RandomNumberGenerator::seed(int se) {
     }
 }
 
-void RandomNumberGenerator::seed(unsigned int *init_key, int key_length) {
+void MersenneTwister::seed(unsigned int *init_key, int key_length) {
     int i = 1, j = 0, k = (N > key_length ? N : key_length);
     seed(19650218UL);
     for (; k; k--) {
@@ -86,7 +89,7 @@ void RandomNumberGenerator::seed(unsigned int *init_key, int key_length) {
     mt[0] = 0x80000000UL;
 }
 
-unsigned int RandomNumberGenerator::next32() {
+unsigned int MersenneTwister::next32() {
     unsigned int y;
     static unsigned int mag01[2] = {
         0x0UL, MATRIX_A
@@ -113,26 +116,26 @@ unsigned int RandomNumberGenerator::next32() {
     return y;
 }
 
-int RandomNumberGenerator::next31() {
+int MersenneTwister::next31() {
     return static_cast<int>(next32() >> 1);
 }
 
-double RandomNumberGenerator::next_closed() {
+double MersenneTwister::next_closed() {
     unsigned int a = next32() >> 5, b = next32() >> 6;
     return (a * 67108864.0 + b) * (1.0 / 9007199254740991.0);
 }
 
-double RandomNumberGenerator::next_half_open() {
+double MersenneTwister::next_half_open() {
     unsigned int a = next32() >> 5, b = next32() >> 6;
     return (a * 67108864.0 + b) * (1.0 / 9007199254740992.0);
 }
 
-double RandomNumberGenerator::next_open() {
+double MersenneTwister::next_open() {
     unsigned int a = next32() >> 5, b = next32() >> 6;
     return (0.5 + a * 67108864.0 + b) * (1.0 / 9007199254740991.0);
 }
 
-int RandomNumberGenerator::next(int bound) {
+int MersenneTwister::next(int bound) {
     unsigned int value;
     do {
         value = next31();
@@ -140,3 +143,117 @@ int RandomNumberGenerator::next(int bound) {
     // Just using modulo doesn't lead to uniform distribution. This does.
     return static_cast<int>(value % bound);
 }
+
+RandomNumberGenerator::RandomNumberGenerator() : mersenne_twister(0) {
+    seed(static_cast<int>(time(0)));
+}
+
+RandomNumberGenerator::RandomNumberGenerator(int s, int stream, rng_t type) : mersenne_twister(0) {
+    if (type == MERSENNE_TWISTER)
+        mersenne_twister = new MersenneTwister();
+    seed(s, stream);
+}
+
+RandomNumberGenerator::RandomNumberGenerator(const RandomNumberGenerator &copy) : mersenne_twister(0) {
+    *this = copy;
+}
+
+RandomNumberGenerator::~RandomNumberGenerator() {
+    delete mersenne_twister;
+}
+
+RandomNumberGenerator &RandomNumberGenerator::operator=(const RandomNumberGenerator &copy) {
+    if (this == &copy)
+        return *this;
+    for (int i = 0; i < 4; ++i)
+        state[i] = copy.state[i];
+    delete mersenne_twister;
+    mersenne_twister = 0;
+    if (copy.mersenne_twister)
+        mersenne_twister = new MersenneTwister(*copy.mersenne_twister);
+    return *this;
+}
+
+void RandomNumberGenerator::seed(int s, int stream) {
+    if (mersenne_twister) {
+        mersenne_twister->seed(s);
+        return;
+    }
+    // fill the state with splitmix64, as recommended by the authors of xoshiro
+    uint64_t value = static_cast<unsigned int>(s);
+    for (int i = 0; i < 4; ++i) {
+        value += 0x9e3779b97f4a7c15ULL;
+        uint64_t z = value;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        state[i] = z ^ (z >> 31);
+    }
+    for (int i = 0; i < stream; ++i)
+        jump();
+}
+
+void RandomNumberGenerator::get_state(vector<uint64_t> &values) const {
+    values.clear();
+    if (mersenne_twister) {
+        // two 32 bit words per value, followed by the position
+        for (int i = 0; i < MersenneTwister::N; i += 2)
+            values.push_back(mersenne_twister->mt[i] | (static_cast<uint64_t>(mersenne_twister->mt[i + 1]) << 32));
+        values.push_back(mersenne_twister->mti);
+    } else {
+        values.assign(state, state + 4);
+    }
+}
+
+bool RandomNumberGenerator::set_state(const vector<uint64_t> &values) {
+    if (mersenne_twister) {
+        if (values.size() != static_cast<size_t>(MersenneTwister::N / 2 + 1) || values.back() > static_cast<uint64_t>(MersenneTwister::N))
+            return false;
+        for (int i = 0; i < MersenneTwister::N; i += 2) {
+            mersenne_twister->mt[i] = static_cast<unsigned int>(values[i / 2]);
+            mersenne_twister->mt[i + 1] = static_cast<unsigned int>(values[i / 2] >> 32);
+        }
+        mersenne_twister->mti = static_cast<int>(values.back());
+        return true;
+    }
+    if (values.size() != 4 || (values[0] == 0 && values[1] == 0 && values[2] == 0 && values[3] == 0))
+        return false;
+    for (int i = 0; i < 4; ++i)
+        state[i] = values[i];
+    return true;
+}
+
+void RandomNumberGenerator::jump() {
+    static const uint64_t JUMP[4] = {
+        0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL
+    };
+    uint64_t jumped[4] = { 0, 0, 0, 0 };
+    for (int i = 0; i < 4; ++i) {
+        for (int bit = 0; bit < 64; ++bit) {
+            if (JUMP[i] & (1ULL << bit)) {
+                for (int j = 0; j < 4; ++j)
+                    jumped[j] ^= state[j];
+            }
+            next64();
+        }
+    }
+    for (int i = 0; i < 4; ++i)
+        state[i] = jumped[i];
+}
+
+double RandomNumberGenerator::next_closed() {
+    if (mersenne_twister)
+        return mersenne_twister->next_closed();
+    return (next64() >> 11) * (1.0 / 9007199254740991.0);
+}
+
+double RandomNumberGenerator::next_half_open() {
+    if (mersenne_twister)
+        return mersenne_twister->next_half_open();
+    return (next64() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+double RandomNumberGenerator::next_open() {
+    if (mersenne_twister)
+        return mersenne_twister->next_open();
+    return (0.5 + (next64() >> 12)) * (1.0 / 4503599627370496.0);
+}
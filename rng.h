@@ -5,16 +5,25 @@
 #ifndef RNG_H
 #define RNG_H
 
-class RandomNumberGenerator {
+#include <cstdint>
+#include <vector>
+
+enum rng_t {
+    XOSHIRO,
+    MERSENNE_TWISTER // the generator of older versions, only used to reproduce their results
+};
+
+class MersenneTwister {
     static const int N = 624;
     unsigned int mt[N];
     int mti;
+    friend class RandomNumberGenerator; // added for storing the state in checkpoints
 public:
-    RandomNumberGenerator();         // seed with time-dependent value
-    RandomNumberGenerator(int seed); // seed with int; see comments for seed()
-    RandomNumberGenerator(unsigned int *array, int count); // seed with array
-    RandomNumberGenerator(const RandomNumberGenerator &copy);
-    RandomNumberGenerator &operator=(const RandomNumberGenerator &copy);
+    MersenneTwister();         // seed with time-dependent value
+    MersenneTwister(int seed); // seed with int; see comments for seed()
+    MersenneTwister(unsigned int *array, int count); // seed with array
+    MersenneTwister(const MersenneTwister &copy);
+    MersenneTwister &operator=(const MersenneTwister &copy);
 
     void seed(int s);
     void seed(unsigned int *array, int len);
@@ -34,6 +43,89 @@ public:
     }
 };
 
+/*
+  The random number generator used everywhere: xoshiro256** (see
+  http://prng.di.unimi.it), which only has 32 bytes of state and is much
+  faster than the Mersenne Twister, or the Mersenne Twister to reproduce the
+  results of older versions.
+
+  A seed determines 2^128 independent streams of 2^128 numbers each, i.e.
+  parallel users of the same seed get reproducible, non-overlapping random
+  numbers by using different streams. Creating a generator for stream n
+  jumps over n streams, which costs as much as drawing 256 * n numbers. The
+  Mersenne Twister ignores the stream.
+*/
+class RandomNumberGenerator {
+    uint64_t state[4];
+    MersenneTwister *mersenne_twister; // 0 unless using the Mersenne Twister
+
+    void jump(); // advances the state by 2^128 numbers, i.e. to the next stream
+    uint64_t next64() { // not for the Mersenne Twister
+        const uint64_t result = rotate_left(state[1] * 5, 7) * 9;
+        const uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotate_left(state[3], 45);
+        return result;
+    }
+    static uint64_t rotate_left(uint64_t value, int k) {
+        return (value << k) | (value >> (64 - k));
+    }
+public:
+    RandomNumberGenerator();         // seed with time-dependent value
+    RandomNumberGenerator(int seed, int stream = 0, rng_t type = XOSHIRO);
+    RandomNumberGenerator(const RandomNumberGenerator &copy);
+    ~RandomNumberGenerator();
+    RandomNumberGenerator &operator=(const RandomNumberGenerator &copy);
+
+    void seed(int seed, int stream = 0); // keeps the type of the generator
+
+    // added for checkpoints: the state as 64 bit values (4 for xoshiro, 313 for the Mersenne Twister); set_state() keeps the type of the generator and returns false if the values do not fit it
+    void get_state(std::vector<uint64_t> &values) const;
+    bool set_state(const std::vector<uint64_t> &values);
+
+    unsigned int next32() {     // random integer in [0..2^32-1]
+        if (mersenne_twister)
+            return mersenne_twister->next32();
+        return next64() >> 32;
+    }
+    int next31() {              // random integer in [0..2^31-1]
+        if (mersenne_twister)
+            return mersenne_twister->next31();
+        return next64() >> 33;
+    }
+    double next_half_open();    // random float in [0..1), 2^53 possible values
+    double next_closed();       // random float in [0..1], 2^53 possible values
+    double next_open();         // random float in (0..1), 2^53 possible values
+    int next(int bound) {       // random integer in [0..bound), bound < 2^31
+        if (mersenne_twister)
+            return mersenne_twister->next(bound);
+        // Lemire's method: the upper half of a random 32 bit number times bound, rejecting the few numbers that would make it biased
+        uint64_t product = (next64() >> 32) * static_cast<uint32_t>(bound);
+        uint32_t low = static_cast<uint32_t>(product);
+        if (low < static_cast<uint32_t>(bound)) {
+            uint32_t threshold = -static_cast<uint32_t>(bound) % static_cast<uint32_t>(bound);
+            while (low < threshold) {
+                product = (next64() >> 32) * static_cast<uint32_t>(bound);
+                low = static_cast<uint32_t>(product);
+            }
+        }
+        return static_cast<int>(product >> 32);
+    }
+    int operator()(int bound) { // same as next()
+        return next(bound);
+    }
+    double next() {             // same as next_half_open()
+        return next_half_open();
+    }
+    double operator()() {       // same as next_half_open()
+        return next_half_open();
+    }
+};
+
 /*
   TODO: Add a static assertion that guarantees that ints are 32 bit.
         In cases where they are not, need to adapt the code.
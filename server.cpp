@@ -0,0 +1,341 @@
+/*
+  doko is a C++ doppelkopf program with an integrated UCT player.
+  Copyright (c) 2011-2016 Silvan Sievers
+  For questions, please write to: silvan.sievers@unibas.ch
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server.h"
+
+#include "belief_game_state.h"
+#include "logging.h"
+#include "options.h"
+#include "uct.h"
+
+#include <cassert>
+#include <cerrno>
+#include <condition_variable>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <streambuf>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+static const int MAX_BINARY_POSITION_SIZE = 4096; // a serialized BeliefGameState needs less than 200 bytes
+
+/*
+  A stream buffer reading from and writing to a file descriptor (i.e. a
+  socket). Reading and writing use separate buffers, so one thread may read
+  while another one writes.
+*/
+class FileDescriptorBuffer : public streambuf {
+    int fd;
+    char input_buffer[4096];
+    char output_buffer[4096];
+protected:
+    int underflow() {
+        ssize_t size;
+        do {
+            size = read(fd, input_buffer, sizeof(input_buffer));
+        } while (size == -1 && errno == EINTR);
+        if (size <= 0)
+            return traits_type::eof();
+        setg(input_buffer, input_buffer, input_buffer + size);
+        return traits_type::to_int_type(*gptr());
+    }
+    int overflow(int c) {
+        if (sync() == -1)
+            return traits_type::eof();
+        if (c != traits_type::eof()) {
+            *pptr() = c;
+            pbump(1);
+        }
+        return traits_type::not_eof(c);
+    }
+    int sync() {
+        const char *data = pbase();
+        while (data < pptr()) {
+            ssize_t size = write(fd, data, pptr() - data);
+            if (size == -1 && errno == EINTR)
+                continue;
+            if (size <= 0)
+                return -1; // the client disconnected, answers are dropped
+            data += size;
+        }
+        setp(output_buffer, output_buffer + sizeof(output_buffer));
+        return 0;
+    }
+public:
+    explicit FileDescriptorBuffer(int fd_) : fd(fd_) {
+        setg(input_buffer, input_buffer, input_buffer);
+        setp(output_buffer, output_buffer + sizeof(output_buffer));
+    }
+};
+
+/*
+  The answering side of a client: answers are written by the worker threads
+  as soon as their search is finished, and the client is served until all
+  of its requests are answered.
+*/
+class Connection {
+    ostream &out;
+    mutex output_mutex;
+    condition_variable all_answered;
+    int pending_requests;
+public:
+    explicit Connection(ostream &out_) : out(out_), pending_requests(0) {
+    }
+    void add_request() {
+        lock_guard<mutex> lock(output_mutex);
+        ++pending_requests;
+    }
+    void answer(const string &answer) {
+        lock_guard<mutex> lock(output_mutex);
+        out << answer << endl;
+        assert(pending_requests > 0);
+        if (--pending_requests == 0)
+            all_answered.notify_all();
+    }
+    void wait_for_answers() {
+        unique_lock<mutex> lock(output_mutex);
+        while (pending_requests > 0)
+            all_answered.wait(lock);
+    }
+};
+
+struct Request {
+    Connection &connection;
+    const string id;
+    const Options options; // the options of the server with the player options of the request for all players
+    string error; // not empty if the request cannot be answered
+    BeliefGameState *state; // refers to options, 0 if the position is invalid
+    Request(Connection &connection_, const string &id_, const Options &options_)
+        : connection(connection_), id(id_), options(options_), state(0) {
+    }
+    ~Request() {
+        delete state;
+    }
+};
+
+class RequestQueue {
+    mutex queue_mutex;
+    condition_variable not_empty;
+    deque<Request *> requests;
+    bool closed;
+public:
+    RequestQueue() : closed(false) {
+    }
+    void push(Request *request) {
+        lock_guard<mutex> lock(queue_mutex);
+        requests.push_back(request);
+        not_empty.notify_one();
+    }
+    Request *pop() { // returns 0 if the queue is closed and empty
+        unique_lock<mutex> lock(queue_mutex);
+        while (requests.empty() && !closed)
+            not_empty.wait(lock);
+        if (requests.empty())
+            return 0;
+        Request *request = requests.front();
+        requests.pop_front();
+        return request;
+    }
+    void close() {
+        lock_guard<mutex> lock(queue_mutex);
+        closed = true;
+        not_empty.notify_all();
+    }
+};
+
+static string search(const Request &request) {
+    ostringstream answer;
+    if (!request.error.empty()) {
+        answer << "error " << request.id << " " << request.error;
+        return answer.str();
+    }
+    const BeliefGameState &state = *request.state;
+    int player = state.get_player_number();
+    if (state.game_finished() || state.get_player_to_move() != player) {
+        answer << "error " << request.id << " player " << player << " is not to move";
+        return answer.str();
+    }
+    vector<Move> legal_moves;
+    state.get_owners_legal_moves(legal_moves);
+    unsigned int best_move = 0;
+    vector<Move> moves;
+    vector<int> visits;
+    vector<double> rewards;
+    // like UctPlayer::ask_for_move, do not search if there is only one option
+    if (legal_moves.size() > 1
+        && (request.options.get_announcement_option(player) != 0 || !legal_moves[0].is_announcement_move())) {
+        Uct uct(request.options, state, state.get_players_cards(), 0);
+        best_move = uct.get_best_move();
+        uct.get_root_statistics(moves, visits, rewards);
+    }
+    answer << "result " << request.id << " " << legal_moves[best_move].get_id() << " " << moves.size();
+    for (size_t i = 0; i < moves.size(); ++i)
+        answer << " " << moves[i].get_id() << " " << visits[i] << " " << rewards[i];
+    return answer.str();
+}
+
+static void work(RequestQueue *queue) {
+    while (Request *request = queue->pop()) {
+        request->connection.answer(search(*request));
+        delete request;
+    }
+}
+
+/*
+  Returns the options to search the request with, which are the options of
+  the server (without any output) with the given player options for all
+  players. Sets error if the player options are invalid.
+*/
+static Options get_request_options(const Options &options, vector<int> player_options, string &error) {
+    if (player_options.empty())
+        player_options = options.get_player_options(0);
+    if (player_options.size() >= static_cast<size_t>(NUMBER_OF_REQUIRED_PLAYER_OPTIONS)) {
+        for (int i = player_options.size(); i < NUMBER_OF_PLAYER_OPTIONS; ++i)
+            player_options.push_back(DEFAULT_PLAYER_OPTIONS[i]);
+    }
+    if (player_options.size() != static_cast<size_t>(NUMBER_OF_PLAYER_OPTIONS))
+        error = "wrong number of player options";
+    else
+        error = get_uct_player_options_error(player_options);
+    if (!error.empty()) // the position still needs to be read with some valid options
+        player_options = options.get_player_options(0);
+    return Options(1, options.solo_disabled(), options.use_compulsory_solo(), vector<player_t>(4, UCT), true,
+                   options.get_random_seed(), options.get_rng_type(), false, false, false, false, vector<vector<int> >(4, player_options), false,
+                   options.get_announcing_version(), "", "");
+}
+
+/* reads the requests of a client, passes them to the workers and returns once all of them are answered */
+static void serve(const Options &options, RequestQueue &queue, istream &in, ostream &out) {
+    Connection connection(out);
+    string line;
+    bool skipping = false; // after a malformed request line, the lines of its position are skipped up to the next request
+    while (getline(in, line)) {
+        istringstream tokens(line);
+        string command;
+        if (!(tokens >> command) || (skipping && command != "search"))
+            continue; // an empty line, e.g. after a binary position
+        skipping = false;
+        string id;
+        string format;
+        int number_of_bytes = 0;
+        bool valid = command == "search" && (tokens >> id >> format) && (format == "text" || format == "binary");
+        if (valid && format == "binary")
+            valid = (tokens >> number_of_bytes) && number_of_bytes >= 1 && number_of_bytes <= MAX_BINARY_POSITION_SIZE;
+        vector<int> player_options;
+        int option;
+        while (valid && tokens >> option)
+            player_options.push_back(option);
+        if (!valid || !tokens.eof()) {
+            connection.add_request();
+            connection.answer("error " + (command == "search" && !id.empty() ? id : "-") + " invalid request");
+            skipping = true;
+            continue;
+        }
+
+        string error;
+        Request *request = new Request(connection, id, get_request_options(options, player_options, error));
+        string position_error;
+        if (format == "text") {
+            request->state = new BeliefGameState(request->options, in, position_error);
+        } else {
+            vector<unsigned char> binary(number_of_bytes);
+            in.read(reinterpret_cast<char *>(binary.data()), number_of_bytes);
+            if (in.gcount() != number_of_bytes)
+                position_error = "truncated position";
+            else
+                request->state = new BeliefGameState(request->options, binary, position_error);
+        }
+        if (!position_error.empty()) {
+            delete request->state;
+            request->state = 0;
+            error = "invalid position: " + position_error;
+        }
+        request->error = error;
+        if (request->state)
+            request->state->set_uct_output(false);
+        connection.add_request();
+        queue.push(request);
+    }
+    connection.wait_for_answers();
+}
+
+static void serve_socket_client(const Options *options, RequestQueue *queue, int fd) {
+    FileDescriptorBuffer buffer(fd);
+    istream in(&buffer);
+    ostream out(&buffer);
+    serve(*options, *queue, in, out);
+    close(fd);
+}
+
+static void listen_on_socket(const Options &options, RequestQueue &queue, const string &socket_path) {
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(address.sun_path)) {
+        cerr << "socket path " << socket_path << " is too long" << endl;
+        exit(2);
+    }
+    strcpy(address.sun_path, socket_path.c_str());
+    int server_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(socket_path.c_str()); // a socket left behind by a previous server
+    if (server_fd == -1 || bind(server_fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == -1
+        || listen(server_fd, 16) == -1) {
+        cerr << "could not listen on socket " << socket_path << ": " << strerror(errno) << endl;
+        exit(2);
+    }
+    signal(SIGPIPE, SIG_IGN); // a client disconnecting before all answers are written must not terminate the server
+    cout << "listening on socket " << socket_path << endl;
+    while (true) {
+        int client_fd = accept(server_fd, 0, 0);
+        if (client_fd == -1) {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+            cerr << "could not accept client: " << strerror(errno) << endl;
+            exit(2);
+        }
+        thread(serve_socket_client, &options, &queue, client_fd).detach();
+    }
+}
+
+void run_server(const Options &options, int number_of_threads, const string &socket_path) {
+    // the searches run in parallel and the log is not thread-safe, answers are the only output
+    for (int i = 0; i < NUMBER_OF_LOG_COMPONENTS; ++i)
+        set_log_level(static_cast<log_component_t>(i), LOG_OFF);
+    RequestQueue queue;
+    vector<thread> workers;
+    for (int i = 0; i < number_of_threads; ++i)
+        workers.push_back(thread(work, &queue));
+    if (socket_path.empty())
+        serve(options, queue, cin, cout);
+    else
+        listen_on_socket(options, queue, socket_path);
+    queue.close();
+    for (size_t i = 0; i < workers.size(); ++i)
+        workers[i].join();
+}
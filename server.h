@@ -0,0 +1,48 @@
+/*
+  doko is a C++ doppelkopf program with an integrated UCT player.
+  Copyright (c) 2011-2016 Silvan Sievers
+  For questions, please write to: silvan.sievers@unibas.ch
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <string>
+
+class Options;
+
+/**
+The analysis server keeps the program running and answers search requests for positions, so that tools analysing many positions do not pay for starting the program and parsing options for every single one. Requests are read from standard input (answers are written to standard output) or, if a socket path is given, from every client connecting to a local (unix domain) socket at that path.
+
+A request consists of one line followed by the position (a BeliefGameState from the point of view of the player to move, see BeliefGameState::write_text() and BeliefGameState::write_binary()):
+search <request id> text [<player options>]
+<the lines written by write_text()>
+search <request id> binary <number of bytes> [<player options>]
+<the bytes written by write_binary()>
+The request id is an arbitrary word chosen by the client. The player options are the options of a uct player (see --print-player-options, the optional ones may be omitted); without them, the options of player 0 are used. The no solo, compulsory solo and announcing version options of the server must match the ones stored with the position.
+
+Requests are pipelined: they are read as soon as they arrive and searched by a pool of worker threads, so a client can send many requests without waiting for answers. Every answer is one line, and as answers are written as soon as a search is finished, they may arrive in a different order than the requests:
+result <request id> <best move> <number of root moves> {<root move> <visits> <average reward>}
+error <request id> <reason>
+Moves are given by their ids (see Move::get_id()). The root moves are the successors of the root of the search (one per class of equivalent moves, see Uct) with their number of visits and their average reward for the player to move; there are none if the player only has one sensible option and no search is needed. Clients should ignore lines starting with other words (e.g. the peak memory printed when the program terminates).
+
+An error is answered if the player options are invalid, if the position is malformed or cannot be reached in a game (see BeliefGameState::get_inconsistency()), or if it cannot be searched (the game is finished or the player is not to move); the server keeps serving further requests in all of these cases. A request line which cannot be parsed is answered by an error with the request id - (or the id, if the line starts with search and an id) and the lines following it are skipped up to the next line starting with search. The position of a text request always extends to its last field (player_to_play_card), and the one of a binary request to the given number of bytes.
+*/
+
+/* answers requests until standard input is closed or, if socket_path is not empty, forever */
+void run_server(const Options &options, int number_of_threads, const std::string &socket_path);
+
+#endif
@@ -20,8 +20,13 @@
 #include "session.h"
 
 #include "actual_game_state.h"
+#include "checkpoint.h"
+#include "game_log.h"
 #include "game_type.h"
+#include "heuristic_player.h"
 #include "human_player.h"
+#include "logging.h"
+#include "opening_book.h"
 #include "options.h"
 #include "random_player.h"
 #include "rng.h"
@@ -30,105 +35,241 @@
 
 #include <algorithm>
 #include <cassert>
+#include <fstream>
 #include <iostream>
 
 using namespace std;
 
-Session::Session(Options &options_)
+void deal_cards(RandomNumberGenerator &rng, Cards cards[4]) {
+    Card deck[48];
+    for (int i = 0; i < 48; ++i) {
+        deck[i] = Card(i);
+    }
+
+    random_shuffle(deck, deck + 48, rng);
+
+    for (int player = 0; player < 4; ++player) {
+        cards[player] = Cards();
+        for (int i = 0; i < 12; ++i)
+            cards[player].add_card(deck[i + 12 * player]);
+        assert(cards[player].size() == 12);
+    }
+}
+
+Player *create_player(player_t type, int player_number, const Options &options, const OpeningBook *opening_book) {
+    switch (type) {
+        case UCT:
+            return new UctPlayer(player_number, options, opening_book);
+        case HUMAN:
+            return new HumanPlayer(player_number);
+        case RANDOM:
+            return new RandomPlayer(player_number, options);
+        case HEURISTIC:
+            return new HeuristicPlayer(player_number, options);
+    }
+    assert(false);
+    return 0;
+}
+
+SessionProgress::SessionProgress(const Options &options)
+    : number_of_games(options.get_number_of_games()), number_of_played_games(0), first_player(0), vorfuehrung(false) {
+    for (int i = 0; i < 4; ++i) {
+        // no compulsory solo to play is the same as saying players already played their compulsory solo
+        played_compulsory_solo[i] = !options.use_compulsory_solo();
+    }
+}
+
+void SessionProgress::start_game() {
+    if (vorfuehrung)
+        return;
+    int remaining_compulsory_solos = 0;
+    for (int i = 0; i < 4; ++i) {
+        if (!played_compulsory_solo[i])
+            ++remaining_compulsory_solos;
+    }
+    assert(remaining_compulsory_solos <= number_of_games - number_of_played_games);
+    if (remaining_compulsory_solos == number_of_games - number_of_played_games) {
+        vorfuehrung = true;
+    }
+}
+
+void SessionProgress::finish_game(const GameState &game_state) {
+    ++number_of_played_games;
+    if (game_state.is_compulsory_solo()) {
+        int solo_player = game_state.get_compulsory_solo_player();
+        played_compulsory_solo[solo_player] = true;
+    }
+    // update next player for all normal games and vorfuehrung compulsory solos. all "regular" compulsory solos are going to be repeated with the same dealer and player positions (although for vorfuehrung it does not really matter, because anyway the solo player starts playing)
+    if (!game_state.is_compulsory_solo() || vorfuehrung)
+        first_player = next_player(first_player);
+}
+
+void SessionProgress::write_checkpoint(CheckpointWriter &writer) const {
+    writer.write_int(number_of_played_games);
+    writer.write_int(first_player);
+    writer.write_bool(vorfuehrung);
+    for (int i = 0; i < 4; ++i)
+        writer.write_bool(played_compulsory_solo[i]);
+}
+
+void SessionProgress::read_checkpoint(CheckpointReader &reader) {
+    number_of_played_games = reader.read_int();
+    first_player = reader.read_int();
+    vorfuehrung = reader.read_bool();
+    for (int i = 0; i < 4; ++i)
+        played_compulsory_solo[i] = reader.read_bool();
+    if (number_of_played_games < 0 || number_of_played_games > number_of_games || first_player < 0 || first_player > 3)
+        reader.exit_with_invalid_checkpoint("invalid session state");
+}
+
+Session::Session(Options &options_, const string &checkpoint_filename_, bool resume_)
     : options(options_),
-      rng(options.get_random_seed()),
-      first_player(0),
-      vorfuehrung(false) {
+      game_log_writer(0),
+      opening_book(0),
+      progress(options),
+      rng(options.create_random_number_generator(DEALING_STREAM)),
+      checkpoint_filename(checkpoint_filename_),
+      resume(resume_) {
     timer = new Timer();
     Cards::setup_bit_count();
     play();
-    cout << "time: " << *timer << endl;
+    if (log_enabled(LOG_SESSION, LOG_INFO))
+        log_stream() << "time: " << *timer << '\n';
 }
 
 Session::~Session() {
     for (int i = 0; i < 4; ++i)
         delete players[i];
+    delete opening_book;
+    delete game_log_writer;
     delete timer;
 }
 
 void Session::play() {
-    cout << "starting doppelkopf session" << endl << endl;
-    options.dump();
+    if (log_enabled(LOG_SESSION, LOG_INFO)) {
+        log_stream() << "starting doppelkopf session\n\n";
+        options.dump();
+    }
     const vector<player_t> &players_types = options.get_players_types();
+    if (!options.get_opening_book_filename().empty())
+        opening_book = new OpeningBook(options.get_opening_book_filename());
     for (size_t i = 0; i < 4; ++i) {
-        switch (players_types[i]) {
-            case UCT:
-                players[i] = new UctPlayer(i, options);
-                break;
-            case HUMAN:
-                players[i] = new HumanPlayer(i);
-                break;
-            case RANDOM:
-                players[i] = new RandomPlayer(i);
-                break;
-        }
+        const OpeningBook *players_opening_book = 0;
+        if (players_types[i] == UCT)
+            players_opening_book = get_opening_book_for_player(opening_book, options, i);
+        players[i] = create_player(players_types[i], i, options, players_opening_book);
         players_points[i] = 0;
-        if (options.use_compulsory_solo())
-            played_compulsory_solo[i] = false;
-        else // no compulsory solo to play is the same as saying players already played their compulsory solo
-            played_compulsory_solo[i] = true;
     }
-    for (int i = 0; i < options.get_number_of_games(); ++i) {
-        cout << "starting game number " << i << " [" << *timer << "]" << endl;
+    if (resume && ifstream(checkpoint_filename.c_str()).good()) {
+        read_checkpoint();
+        if (log_enabled(LOG_SESSION, LOG_INFO)) {
+            log_stream() << "resuming after game number " << progress.get_number_of_played_games() - 1 << " from checkpoint " << checkpoint_filename << '\n';
+            statistics();
+        }
+    } else {
+        if (resume && log_enabled(LOG_SESSION, LOG_INFO))
+            log_stream() << "checkpoint " << checkpoint_filename << " does not exist, starting a new session\n";
+        if (!options.get_game_log_filename().empty())
+            game_log_writer = new GameLogWriter(options, options.get_game_log_filename());
+    }
+    while (progress.get_number_of_played_games() < options.get_number_of_games()) {
+        if (log_enabled(LOG_SESSION, LOG_INFO))
+            log_stream() << "starting game number " << progress.get_number_of_played_games() << " [" << *timer << "]\n";
         if (options.use_random_cards())
-            shuffle_cards();
+            deal_cards(rng, cards);
         else {
             if (!options.specify_cards_manually(cards)) {
                 cout << "using random cards" << endl;
-                shuffle_cards();
+                deal_cards(rng, cards);
             }
         }
         set_cards();
-        if (!vorfuehrung)
-            check_vorfuehrung(options.get_number_of_games() - i);
-        ActualGameState actual_game_state(options, players, first_player, cards, played_compulsory_solo, vorfuehrung);
+        progress.start_game();
+        int first_player = progress.get_first_player();
+        bool vorfuehrung = progress.is_vorfuehrung();
+        const bool *played_compulsory_solo = progress.get_played_compulsory_solo();
+        if (game_log_writer != 0)
+            game_log_writer->start_game(first_player, vorfuehrung, played_compulsory_solo, cards);
+        ActualGameState actual_game_state(options, players, first_player, cards, played_compulsory_solo, vorfuehrung,
+                                          game_log_writer);
         int new_points[4] = { 0, 0, 0, 0 };
         actual_game_state.get_score_points(new_points);
+        if (game_log_writer != 0)
+            game_log_writer->finish_game(new_points);
         for (int i = 0; i < 4; ++i) {
             players[i]->inform_about_game_end(new_points);
             players_points[i] += new_points[i];
         }
-        if (actual_game_state.is_compulsory_solo()) {
-            int solo_player = actual_game_state.get_compulsory_solo_player();
-            played_compulsory_solo[solo_player] = true;
-        }
+        progress.finish_game(actual_game_state);
         statistics();
-        // update next player for all normal games and vorfuehrung compulsory solos. all "regular" compulsory solos are going to be repeated with the same dealer and player positions (although for vorfuehrung it does not really matter, because anyway the solo player starts playing)
-        if (!actual_game_state.is_compulsory_solo() || vorfuehrung)
-            first_player = next_player(first_player);
+        if (!checkpoint_filename.empty())
+            write_checkpoint();
     }
-    cout << "doppelkopf session finished" << endl;
+    if (log_enabled(LOG_SESSION, LOG_INFO))
+        log_stream() << "doppelkopf session finished\n";
 }
 
-void Session::shuffle_cards() {
-    cards[0] = Cards();
-    cards[1] = Cards();
-    cards[2] = Cards();
-    cards[3] = Cards();
-
-    Card deck[48];
-    for (int i = 0; i < 48; ++i) {
-        deck[i] = Card(i);
+void Session::get_checkpoint_options(vector<int> &values) const {
+    values.clear();
+    values.push_back(options.get_number_of_games());
+    values.push_back(options.solo_disabled());
+    values.push_back(options.use_compulsory_solo());
+    values.push_back(options.use_random_cards());
+    values.push_back(options.get_random_seed());
+    values.push_back(options.get_rng_type());
+    values.push_back(options.get_announcing_version());
+    for (int i = 0; i < 4; ++i) {
+        values.push_back(options.get_players_types()[i]);
+        const vector<int> &player_options = options.get_player_options(i);
+        values.push_back(player_options.size());
+        values.insert(values.end(), player_options.begin(), player_options.end());
     }
+    // the uct players use the opening book for their decisions, thus a session cannot be resumed with another one
+    const string &opening_book_filename = options.get_opening_book_filename();
+    values.push_back(opening_book_filename.size());
+    values.insert(values.end(), opening_book_filename.begin(), opening_book_filename.end());
+}
 
-    random_shuffle(deck, deck + 48, rng);
+void Session::write_checkpoint() {
+    // writing the whole checkpoint anew takes a few hundred bytes and one rename, which is negligible compared to playing a game
+    CheckpointWriter writer;
+    vector<int> checkpoint_options;
+    get_checkpoint_options(checkpoint_options);
+    writer.write_int(checkpoint_options.size());
+    for (size_t i = 0; i < checkpoint_options.size(); ++i)
+        writer.write_int(checkpoint_options[i]);
+    progress.write_checkpoint(writer);
+    for (int i = 0; i < 4; ++i)
+        writer.write_int(players_points[i]);
+    writer.write_rng(rng);
+    writer.write_uint64(game_log_writer != 0 ? game_log_writer->get_size() : 0);
+    for (int i = 0; i < 4; ++i)
+        players[i]->write_checkpoint(writer);
+    writer.save(checkpoint_filename);
+}
 
-    for (int i = 0; i < 12; ++i) {
-        cards[0].add_card(deck[i]);
-        cards[1].add_card(deck[i + 12]);
-        cards[2].add_card(deck[i + 24]);
-        cards[3].add_card(deck[i + 36]);
+void Session::read_checkpoint() {
+    CheckpointReader reader(checkpoint_filename);
+    vector<int> checkpoint_options;
+    get_checkpoint_options(checkpoint_options);
+    bool same_options = reader.read_int() == static_cast<int>(checkpoint_options.size());
+    for (size_t i = 0; same_options && i < checkpoint_options.size(); ++i)
+        same_options = reader.read_int() == checkpoint_options[i];
+    if (!same_options)
+        reader.exit_with_invalid_checkpoint("the session was started with different options");
+    progress.read_checkpoint(reader);
+    for (int i = 0; i < 4; ++i)
+        players_points[i] = reader.read_int();
+    reader.read_rng(rng);
+    uint64_t game_log_size = reader.read_uint64();
+    for (int i = 0; i < 4; ++i)
+        players[i]->read_checkpoint(reader);
+    reader.check_end();
+    if (!options.get_game_log_filename().empty()) {
+        if (game_log_size == 0)
+            reader.exit_with_invalid_checkpoint("the session did not write a game log");
+        game_log_writer = new GameLogWriter(options, options.get_game_log_filename(), game_log_size);
     }
-
-    assert(cards[0].size() == 12);
-    assert(cards[1].size() == 12);
-    assert(cards[2].size() == 12);
-    assert(cards[3].size() == 12);
 }
 
 void Session::set_cards() const {
@@ -141,25 +282,15 @@ void Session::set_cards() const {
     }
 }
 
-void Session::check_vorfuehrung(int number_of_remaining_games) {
-    int remaining_compulsory_solos = 0;
-    for (int i = 0; i < 4; ++i) {
-        if (!played_compulsory_solo[i])
-            ++remaining_compulsory_solos;
-    }
-    assert(remaining_compulsory_solos <= number_of_remaining_games);
-    if (remaining_compulsory_solos == number_of_remaining_games) {
-        vorfuehrung = true;
-    }
-}
-
 void Session::statistics() const {
-    cout << "standings:" << endl;
     int sum = 0;
-    for (int i = 0; i < 4; ++i) {
-        cout << "player " << i << ": " << players_points[i] << endl;
+    for (int i = 0; i < 4; ++i)
         sum += players_points[i];
-    }
-    cout << endl;
     assert(sum == 0);
+    if (!log_enabled(LOG_SESSION, LOG_INFO))
+        return;
+    log_stream() << "standings:\n";
+    for (int i = 0; i < 4; ++i)
+        log_stream() << "player " << i << ": " << players_points[i] << '\n';
+    log_stream() << '\n';
 }
@@ -21,34 +21,75 @@
 #define SESSION_H
 
 #include "cards.h"
-
+#include "options.h"
 #include "rng.h"
 
+#include <string>
+#include <vector>
+
+class CheckpointReader;
+class CheckpointWriter;
+class GameLogWriter;
 class GameType;
 class GameState;
-class Options;
+class OpeningBook;
 class Player;
 class Timer;
 
+void deal_cards(RandomNumberGenerator &rng, Cards cards[4]); // shuffles all cards and deals 12 cards to every player
+Player *create_player(player_t type, int player_number, const Options &options, const OpeningBook *opening_book); // opening_book is only used by uct players, see UctPlayer
+
+/* SessionProgress keeps the course of a session from one game to the next one, i.e. which player moves first, which players already played their compulsory solo and whether the remaining games all need to be compulsory solos (vorfuehrung). It is used by Session and by build_opening_book, which play the same sequence of games. */
+class SessionProgress {
+private:
+    const int number_of_games;
+    int number_of_played_games;
+    int first_player; // player to move first in the next game; starts with player 0 and changes after all games except repeated compulsory solos
+    bool played_compulsory_solo[4];
+    bool vorfuehrung; // true if a player is forced to play his compulsory solo (due to the number of remaining games being small)
+public:
+    explicit SessionProgress(const Options &options);
+    void start_game(); // test if the remaining games need all to be compulsory solos (i.e. vorfuehrung)
+    void finish_game(const GameState &game_state); // update the compulsory solos and the first player after the game game_state
+    int get_number_of_played_games() const {
+        return number_of_played_games;
+    }
+    int get_first_player() const {
+        return first_player;
+    }
+    const bool *get_played_compulsory_solo() const {
+        return played_compulsory_solo;
+    }
+    bool is_vorfuehrung() const {
+        return vorfuehrung;
+    }
+    void write_checkpoint(CheckpointWriter &writer) const;
+    void read_checkpoint(CheckpointReader &reader);
+};
+
 class Session {
 private:
     const Options &options;
     Timer *timer;
+    GameLogWriter *game_log_writer; // 0 if no game log is written
+    OpeningBook *opening_book; // shared by all uct players, 0 if no opening book is used
     Player *players[4];
     int players_points[4]; // accumulated points over all games
-    bool played_compulsory_solo[4];
+    SessionProgress progress;
     RandomNumberGenerator rng;
-    int first_player; // player to move first in the next game; when creating, this is set to be player 0 and will eventually change when playing more than 1 game.
     Cards cards[4]; // players' starting hands for the current game
-    bool vorfuehrung; // true if a player is forced to play his compulsory solo (due to the number of remaining games being small)
+    std::string checkpoint_filename; // empty if no checkpoints are written
+    bool resume;
 
     void play();
-    void shuffle_cards();
+    void get_checkpoint_options(std::vector<int> &values) const; // the options which need to be the same when resuming (including the characters of the opening book file name)
+    void write_checkpoint();
+    void read_checkpoint();
     void set_cards() const; // distribute cards to players
-    void check_vorfuehrung(int number_of_remaining_games); // test if the remaining games need all to be compulsory solos (i.e. vorfuehrung)
     void statistics() const; // print accumulated points
 public:
-    explicit Session(Options &options);
+    /* if checkpoint_filename is not empty, the session writes a checkpoint after every game (see CheckpointWriter). if resume is true and the checkpoint exists, the session continues after the last game recorded in it, playing the remaining games exactly like an uninterrupted session */
+    Session(Options &options, const std::string &checkpoint_filename, bool resume);
     ~Session();
 };
 
@@ -0,0 +1,265 @@
+/*
+  doko is a C++ doppelkopf program with an integrated UCT player.
+  Copyright (c) 2011-2016 Silvan Sievers
+  For questions, please write to: silvan.sievers@unibas.ch
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "sweep.h"
+
+#include "actual_game_state.h"
+#include "logging.h"
+#include "opening_book.h"
+#include "options.h"
+#include "player.h"
+#include "rng.h"
+#include "session.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+static void exit_with_invalid_sweep(const string &filename, const string &reason) {
+    cerr << "invalid sweep " << filename << ": " << reason << endl;
+    exit(2);
+}
+
+/* appends all combinations of the values of the line to configurations */
+static void expand_configurations(const vector<vector<int> > &values, vector<int> &configuration,
+                                  vector<vector<int> > &configurations) {
+    size_t index = configuration.size();
+    if (index == values.size()) {
+        configurations.push_back(configuration);
+        return;
+    }
+    for (size_t i = 0; i < values[index].size(); ++i) {
+        configuration.push_back(values[index][i]);
+        expand_configurations(values, configuration, configurations);
+        configuration.pop_back();
+    }
+}
+
+static void read_configurations(const string &filename, vector<vector<int> > &configurations) {
+    ifstream file(filename.c_str());
+    if (!file)
+        exit_with_invalid_sweep(filename, "cannot open file");
+    string line;
+    while (getline(file, line)) {
+        istringstream tokens(line);
+        string token;
+        vector<vector<int> > values;
+        while (tokens >> token) {
+            if (values.empty() && token[0] == '#')
+                break;
+            values.push_back(vector<int>());
+            istringstream alternatives(token);
+            string alternative;
+            while (getline(alternatives, alternative, ',')) {
+                char *end = 0;
+                values.back().push_back(strtol(alternative.c_str(), &end, 10));
+                if (alternative.empty() || *end != '\0')
+                    exit_with_invalid_sweep(filename, "invalid value " + alternative + " in line: " + line);
+            }
+            if (values.back().empty())
+                exit_with_invalid_sweep(filename, "invalid value " + token + " in line: " + line);
+        }
+        if (values.empty())
+            continue;
+        if (values.size() < static_cast<size_t>(NUMBER_OF_REQUIRED_PLAYER_OPTIONS)
+            || values.size() > static_cast<size_t>(NUMBER_OF_PLAYER_OPTIONS))
+            exit_with_invalid_sweep(filename, "wrong number of player options in line: " + line);
+        for (int i = values.size(); i < NUMBER_OF_PLAYER_OPTIONS; ++i)
+            values.push_back(vector<int>(1, DEFAULT_PLAYER_OPTIONS[i]));
+        size_t first_configuration = configurations.size();
+        vector<int> configuration;
+        expand_configurations(values, configuration, configurations);
+        for (size_t i = first_configuration; i < configurations.size(); ++i) {
+            string error = get_uct_player_options_error(configurations[i]);
+            if (!error.empty())
+                exit_with_invalid_sweep(filename, error + " in line: " + line);
+        }
+    }
+    if (configurations.empty())
+        exit_with_invalid_sweep(filename, "no configurations");
+}
+
+static double get_thread_time() {
+    timespec time;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+    return time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+struct SweepGame {
+    int score_points; // of player 0
+    double time;
+};
+
+class Sweep {
+    const Options &options;
+    const vector<vector<int> > &configurations;
+    vector<const OpeningBook *> opening_books; // of player 0 for every configuration, followed by the ones of players 1 to 3 (0 if the player does not use one)
+    vector<Cards> deals; // four hands per game
+    vector<SweepGame> games; // all games of the first configuration, followed by the ones of the second one etc.
+    atomic<size_t> next_round;
+
+    Options *create_round_options(int configuration, int round) const; // the options of the players of a round
+    void play_round(int configuration, int round);
+public:
+    Sweep(const Options &options, const vector<vector<int> > &configurations, const OpeningBook *opening_book); // opening_book may be 0
+    void work();
+    void print_results() const;
+};
+
+Sweep::Sweep(const Options &options_, const vector<vector<int> > &configurations_, const OpeningBook *opening_book)
+    : options(options_), configurations(configurations_),
+      games(configurations.size() * options.get_number_of_games()), next_round(0) {
+    // check the compatibility of the opening book once instead of for every round
+    const vector<player_t> &players_types = options.get_players_types();
+    for (size_t configuration = 0; configuration < configurations.size(); ++configuration) {
+        Options *round_options = create_round_options(configuration, 0);
+        opening_books.push_back(get_opening_book_for_player(opening_book, *round_options, 0));
+        delete round_options;
+    }
+    for (int i = 1; i < 4; ++i)
+        opening_books.push_back(players_types[i] == UCT ? get_opening_book_for_player(opening_book, options, i) : 0);
+
+    // deal like Session does with random cards
+    RandomNumberGenerator rng(options.create_random_number_generator(DEALING_STREAM));
+    for (int game = 0; game < options.get_number_of_games(); ++game) {
+        Cards cards[4];
+        deal_cards(rng, cards);
+        deals.insert(deals.end(), cards, cards + 4);
+    }
+}
+
+Options *Sweep::create_round_options(int configuration, int round) const {
+    vector<vector<int> > players_options(4);
+    for (int i = 1; i < 4; ++i)
+        players_options[i] = options.get_player_options(i);
+    players_options[0] = configurations[configuration];
+    return new Options(options.get_number_of_games(), options.solo_disabled(), false, options.get_players_types(), true,
+                       options.get_random_seed() + round, options.get_rng_type(), false, false, false, false,
+                       players_options, false, options.get_announcing_version(),
+                       options.get_opening_book_filename(), "");
+}
+
+void Sweep::play_round(int configuration, int round) {
+    Options *round_options = create_round_options(configuration, round);
+    Player *players[4];
+    for (int i = 0; i < 4; ++i) {
+        const OpeningBook *opening_book = opening_books[i == 0 ? configuration : configurations.size() + i - 1];
+        players[i] = create_player(options.get_players_types()[i], i, *round_options, opening_book);
+    }
+    // the players start every round with player 0 as the first player, which moves on after every game as there are no compulsory solos
+    bool played_compulsory_solo[4] = { true, true, true, true };
+    for (int game = 4 * round; game < min(4 * round + 4, options.get_number_of_games()); ++game) {
+        double start_time = get_thread_time();
+        for (int i = 0; i < 4; ++i)
+            players[i]->set_cards(deals[4 * game + i]);
+        ActualGameState actual_game_state(*round_options, players, game % 4, &deals[4 * game], played_compulsory_solo, false, 0);
+        int new_points[4] = { 0, 0, 0, 0 };
+        actual_game_state.get_score_points(new_points);
+        for (int i = 0; i < 4; ++i)
+            players[i]->inform_about_game_end(new_points);
+        SweepGame &result = games[configuration * options.get_number_of_games() + game];
+        result.score_points = new_points[0];
+        result.time = get_thread_time() - start_time;
+    }
+    for (int i = 0; i < 4; ++i)
+        delete players[i];
+    delete round_options;
+}
+
+void Sweep::work() {
+    // the rounds are played deal by deal such that all configurations progress evenly
+    int number_of_rounds = (options.get_number_of_games() + 3) / 4;
+    while (true) {
+        size_t index = next_round++;
+        if (index >= configurations.size() * number_of_rounds)
+            return;
+        play_round(index % configurations.size(), index / configurations.size());
+    }
+}
+
+void Sweep::print_results() const {
+    int number_of_games = options.get_number_of_games();
+    cout << "sweep of " << configurations.size() << " configurations of player 0 with " << number_of_games
+         << " games each" << endl;
+    cout << left << setw(50) << "configuration" << right << setw(12) << "mean points" << setw(12) << "std error"
+         << setw(16) << "seconds / game" << endl;
+    for (size_t configuration = 0; configuration < configurations.size(); ++configuration) {
+        double sum = 0;
+        double sum_of_squares = 0;
+        double time = 0;
+        for (int game = 0; game < number_of_games; ++game) {
+            const SweepGame &result = games[configuration * number_of_games + game];
+            sum += result.score_points;
+            sum_of_squares += result.score_points * result.score_points;
+            time += result.time;
+        }
+        double mean = sum / number_of_games;
+        double standard_error = 0;
+        if (number_of_games > 1)
+            standard_error = sqrt(max(0.0, sum_of_squares - number_of_games * mean * mean) / (number_of_games - 1) / number_of_games);
+        ostringstream player_options;
+        for (size_t i = 0; i < configurations[configuration].size(); ++i)
+            player_options << (i ? " " : "") << configurations[configuration][i];
+        cout << left << setw(50) << player_options.str() << right << fixed << setprecision(3) << setw(12) << mean
+             << setw(12) << standard_error << setw(16) << time / number_of_games << endl;
+    }
+}
+
+void run_sweep(const Options &options, const string &filename, int number_of_threads) {
+    vector<vector<int> > configurations;
+    read_configurations(filename, configurations);
+    if (options.get_players_types()[0] != UCT) {
+        cerr << "player 0 must be a UCT player to sweep its options" << endl;
+        exit(2);
+    }
+    for (int i = 0; i < 4; ++i) {
+        if (options.get_players_types()[i] == HUMAN) {
+            cerr << "a sweep cannot be played with human players" << endl;
+            exit(2);
+        }
+    }
+    if (options.use_compulsory_solo()) {
+        cerr << "a sweep is played without compulsory solos" << endl;
+        exit(2);
+    }
+    // the games are played in parallel and the log is not thread-safe, the table is the only output
+    for (int i = 0; i < NUMBER_OF_LOG_COMPONENTS; ++i)
+        set_log_level(static_cast<log_component_t>(i), LOG_OFF);
+    OpeningBook *opening_book = 0; // shared by all rounds and threads
+    if (!options.get_opening_book_filename().empty())
+        opening_book = new OpeningBook(options.get_opening_book_filename());
+    Sweep sweep(options, configurations, opening_book);
+    vector<thread> workers;
+    for (int i = 0; i < number_of_threads; ++i)
+        workers.push_back(thread(&Sweep::work, &sweep));
+    for (size_t i = 0; i < workers.size(); ++i)
+        workers[i].join();
+    sweep.print_results();
+    delete opening_book;
+}
@@ -0,0 +1,40 @@
+/*
+  doko is a C++ doppelkopf program with an integrated UCT player.
+  Copyright (c) 2011-2016 Silvan Sievers
+  For questions, please write to: silvan.sievers@unibas.ch
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <string>
+
+class Options;
+
+/**
+A sweep compares many configurations of the options of a uct player in a single run instead of one session per configuration. The configurations are read from a file with one line per configuration (empty lines and lines starting with # are ignored), which lists the player options like --p0-options (see --print-player-options, the optional ones may be omitted). Instead of a single value, a line may give several values separated by commas (without spaces), in which case it stands for all combinations of these values, e.g.
+1 500 1 1 10000,20000,40000 1000,4000 10 2 0 0 0
+stands for six configurations, the last listed value varying fastest.
+
+Every configuration plays the same games: the cards of all games are dealt once (like the random cards of a session with the same seed), game i is started by player i mod 4 and player 0 uses the configuration while the other players are the ones of the session (see --players and --p*-options). There are no compulsory solos, thus the games only depend on each other within a round of four games, which is played by the same players like in a session. The random choices of the players of round r are made with the seed of the session plus r, so the configurations differ by nothing but the options of player 0. All rounds of all configurations are played in parallel by a pool of threads. The opening book (see --opening-book) is loaded once and shared by all of them, and its compatibility with the options of every player is checked once.
+
+The result is a table with the mean score points of player 0 (with their standard error) and the mean time (cpu time of the thread playing the game) needed to play a game for every configuration.
+*/
+
+/* plays the games of options with every configuration read from filename, terminates the program if the file is invalid */
+void run_sweep(const Options &options, const std::string &filename, int number_of_threads);
+
+#endif
@@ -17,10 +17,31 @@
   along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include "actual_game_state.h"
+#include "belief_game_state.h"
+#include "card_assignment.h"
+#include "game_log.h"
 #include "game_state.h"
+#include "game_type.h"
+#include "heuristic_player.h"
+#include "logging.h"
+#include "opening_book.h"
+#include "options.h"
+#include "reference.h"
+#include "rng.h"
+#include "session.h"
+#include "trick.h"
+#include "uct.h"
+#include "uct_formula.h"
 
 #include <cassert>
+#include <cmath>
+#include <cstdlib>
 #include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
 
 using namespace std;
 
@@ -47,7 +68,859 @@ void test(int who_wins, const announcement_t announcements[2], int points_re, co
     }
 }
 
+// the deal of a game played by play_random_game and the game from the point of view of every player plus the game with complete information (states[4])
+struct RandomGame {
+    Cards cards[4];
+    bool played_compulsory_solo[4];
+    int first_player;
+    vector<BeliefGameState> states;
+};
+
+/*
+  Plays a game of random cards with a random first player and random
+  compulsory solos already played. Before every move, callback(game,
+  legal_moves) is called with the legal moves of the player to move and
+  returns the index of the move to play, or -1 for a random move (including
+  random game type and announcement moves). It is called once more with no
+  legal moves when the game is finished.
+*/
+template<class Callback>
+void play_random_game(const Options &options, RandomNumberGenerator &rng, Callback callback) {
+    RandomGame game;
+    deal_cards(rng, game.cards);
+    for (int i = 0; i < 4; ++i)
+        game.played_compulsory_solo[i] = rng.next(2);
+    game.first_player = rng.next(4);
+    for (int player = 0; player < 5; ++player) {
+        game.states.push_back(BeliefGameState(options, player % 4, game.played_compulsory_solo, false, game.first_player,
+                                              game.cards[player % 4]));
+        game.states.back().set_uct_output(false);
+    }
+    Cards other_players_cards[4] = { Cards(), game.cards[1], game.cards[2], game.cards[3] };
+    game.states[4].set_other_players_cards(other_players_cards);
+    vector<Move> legal_moves;
+    while (!game.states[4].game_finished()) {
+        legal_moves.clear();
+        game.states[4].get_legal_moves(legal_moves);
+        int move_index = callback(game, legal_moves);
+        if (move_index == -1)
+            move_index = rng.next(legal_moves.size());
+        int player = game.states[4].get_player_to_move();
+        for (size_t i = 0; i < game.states.size(); ++i)
+            game.states[i].set_move(player, legal_moves[move_index]);
+    }
+    legal_moves.clear();
+    callback(game, legal_moves);
+}
+
+/*
+  Plays random games with complete information and checks at every card move
+  that BeliefGameState::get_best_move_index chooses the same card as
+  get_best_move_index_reference, both for all legal cards and for a random
+  subset of them (as used by Uct when selecting among unvisited successors).
+*/
+void test_best_move_index(int number_of_games) {
+    vector<player_t> players_types(4, RANDOM);
+    vector<vector<int> > players_options(4);
+    Options options(4, false, false, players_types, true, 2012, XOSHIRO, false, false, false, false, players_options, false, 1, "", "");
+    RandomNumberGenerator rng(2012);
+    int number_of_positions = 0;
+    for (int game = 0; game < number_of_games; ++game) {
+        play_random_game(options, rng, [&](const RandomGame &random_game, const vector<Move> &legal_moves) {
+            const BeliefGameState &state = random_game.states[4];
+            if (!legal_moves.empty() && legal_moves[0].is_card_move()) {
+                assert(state.get_best_move_index(legal_moves) == get_best_move_index_reference(state, legal_moves));
+                vector<Move> subset;
+                for (size_t i = 0; i < legal_moves.size(); ++i) {
+                    if (rng.next(2) == 0)
+                        subset.push_back(legal_moves[i]);
+                }
+                if (!subset.empty())
+                    assert(state.get_best_move_index(subset) == get_best_move_index_reference(state, subset));
+                ++number_of_positions;
+            }
+            return -1;
+        });
+    }
+    cout << "get_best_move_index: identical choices at " << number_of_positions << " positions" << endl;
+}
+
+// plays random moves from state (starting with card) until the end of the game and records the moves, the player to move after every move and the points
+static void play_random_continuation(BeliefGameState state, Card card, RandomNumberGenerator &rng, vector<Move> &moves,
+                                     vector<int> &players_to_move, int score_points[4], int points[4]) {
+    vector<Move> legal_moves;
+    Move move(card);
+    while (true) {
+        moves.push_back(move);
+        state.set_move(state.get_player_to_move(), move);
+        if (state.game_finished())
+            break;
+        players_to_move.push_back(state.get_player_to_move());
+        legal_moves.clear();
+        state.get_legal_moves(legal_moves);
+        move = legal_moves[rng.next(legal_moves.size())];
+    }
+    state.get_score_points(score_points, points);
+}
+
+// true if the moves recorded by play_random_continuation, with card1 and card2 exchanged, are legal from state and lead to the same players to move (and thus the same trick winners) and the same points
+static bool is_same_continuation(BeliefGameState state, Card card1, Card card2, const vector<Move> &moves,
+                                 const vector<int> &players_to_move, const int score_points[4], const int points[4]) {
+    vector<Move> legal_moves;
+    for (size_t i = 0; i < moves.size(); ++i) {
+        Move move = moves[i];
+        if (move.is_card_move() && move.get_card() == card1)
+            move = Move(card2);
+        else if (move.is_card_move() && move.get_card() == card2)
+            move = Move(card1);
+        legal_moves.clear();
+        state.get_legal_moves(legal_moves);
+        bool legal = false;
+        for (size_t j = 0; j < legal_moves.size(); ++j)
+            legal = legal || legal_moves[j] == move;
+        if (!legal)
+            return false;
+        state.set_move(state.get_player_to_move(), move);
+        if (!state.game_finished() && (i + 1 == moves.size() || state.get_player_to_move() != players_to_move[i]))
+            return false;
+    }
+    if (!state.game_finished())
+        return false;
+    int other_score_points[4] = { 0, 0, 0, 0 };
+    int other_points[4] = { 0, 0, 0, 0 };
+    state.get_score_points(other_score_points, other_points);
+    for (int i = 0; i < 4; ++i) {
+        if (other_score_points[i] != score_points[i] || other_points[i] != points[i])
+            return false;
+    }
+    return true;
+}
+
+/*
+  Plays random games and checks at every card move with complete information
+  that BeliefGameState::merge_equivalent_cards only merges interchangeable
+  cards: after playing a merged card instead of the card representing its
+  class (and the other way round later in the game), a random continuation of
+  the game stays legal and yields the same trick winners and points. The
+  player's own state must merge the same cards. Club jacks and, while the
+  teams of a regular game are unknown, club queens must never be merged with
+  other cards, and playing them instead of a card of their class according
+  to GameType::are_equivalent must make a difference in some games: a
+  different score (charlie) or a different known team of the player. Every
+  second game is forced to be a regular game by answering all questions with
+  no.
+*/
+void test_card_equivalence(int number_of_games) {
+    vector<player_t> players_types(4, RANDOM);
+    vector<vector<int> > players_options(4);
+    Options options(4, false, false, players_types, true, 2012, XOSHIRO, false, false, false, false, players_options, false, 1, "", "");
+    RandomNumberGenerator rng(2013);
+    int number_of_merged_cards = 0;
+    int special_cards_differences[2] = { 0, 0 }; // club jacks, club queens
+    for (int game = 0; game < number_of_games; ++game) {
+        play_random_game(options, rng, [&](const RandomGame &random_game, const vector<Move> &legal_moves) {
+            const BeliefGameState &state = random_game.states[4];
+            if (game % 2 == 0 && !legal_moves.empty() && legal_moves[0].is_question_move()) {
+                // every second game is a regular game, in which charlie and the club queens matter
+                for (size_t i = 0; i < legal_moves.size(); ++i) {
+                    if (!legal_moves[i].get_answer())
+                        return static_cast<int>(i);
+                }
+            }
+            if (legal_moves.size() < 2 || !legal_moves[0].is_card_move())
+                return -1;
+            int player = state.get_player_to_move();
+            vector<Move> merged_moves(legal_moves);
+            state.merge_equivalent_cards(merged_moves);
+            vector<Move> players_merged_moves;
+            random_game.states[player].get_legal_moves(players_merged_moves);
+            random_game.states[player].merge_equivalent_cards(players_merged_moves);
+            assert(players_merged_moves == merged_moves);
+
+            const GameType *game_type = state.get_game_type();
+            Cards special_cards;
+            special_cards.add_card(CJ);
+            special_cards.add_card(CJ_);
+            if (*game_type == regular && !state.are_teams_known()) {
+                special_cards.add_card(CQ);
+                special_cards.add_card(CQ_);
+            }
+            Cards known_cards = state.get_played_cards();
+            known_cards.remove_cards(state.get_current_trick().get_cards());
+            known_cards.add_cards(state.get_remaining_cards(player));
+            for (size_t i = 0; i < legal_moves.size(); ++i) {
+                Card card = legal_moves[i].get_card();
+                bool kept = false;
+                for (size_t j = 0; j < merged_moves.size(); ++j)
+                    kept = kept || merged_moves[j] == legal_moves[i];
+                if (special_cards.contains_card(card)) {
+                    assert(kept);
+                    // the cards the special card would be merged with without the exception
+                    for (size_t j = 0; j < legal_moves.size(); ++j) {
+                        Card other_card = legal_moves[j].get_card();
+                        if (special_cards.contains_card(other_card) || !game_type->are_equivalent(card, other_card, known_cards))
+                            continue;
+                        if (card == CJ || card == CJ_) {
+                            vector<Move> moves;
+                            vector<int> players_to_move;
+                            int score_points[4] = { 0, 0, 0, 0 };
+                            int points[4] = { 0, 0, 0, 0 };
+                            play_random_continuation(state, other_card, rng, moves, players_to_move, score_points, points);
+                            if (!is_same_continuation(state, other_card, card, moves, players_to_move, score_points, points))
+                                ++special_cards_differences[0];
+                        } else {
+                            // the score does not depend on who knows the teams, but the other players' beliefs do
+                            BeliefGameState with_card(state);
+                            with_card.set_move(player, Move(card));
+                            BeliefGameState with_other_card(state);
+                            with_other_card.set_move(player, Move(other_card));
+                            if (with_card.get_players_known_team(player) != with_other_card.get_players_known_team(player))
+                                ++special_cards_differences[1];
+                        }
+                    }
+                } else if (!kept) {
+                    // the representative of the class is the first kept card which the merged card is interchangeable with
+                    bool interchangeable = false;
+                    for (size_t j = 0; j < merged_moves.size() && !interchangeable; ++j) {
+                        Card representative = merged_moves[j].get_card();
+                        if (!game_type->are_equivalent(card, representative, known_cards))
+                            continue;
+                        vector<Move> moves;
+                        vector<int> players_to_move;
+                        int score_points[4] = { 0, 0, 0, 0 };
+                        int points[4] = { 0, 0, 0, 0 };
+                        play_random_continuation(state, representative, rng, moves, players_to_move, score_points, points);
+                        interchangeable = is_same_continuation(state, representative, card, moves, players_to_move,
+                                                               score_points, points);
+                    }
+                    assert(interchangeable);
+                    ++number_of_merged_cards;
+                }
+            }
+            return -1;
+        });
+    }
+    // the exceptions for club jacks and club queens are needed
+    assert(special_cards_differences[0] > 0);
+    assert(special_cards_differences[1] > 0);
+    cout << "merge_equivalent_cards: " << number_of_merged_cards << " interchangeable merged cards, "
+         << special_cards_differences[0] << " charlies and " << special_cards_differences[1]
+         << " revealed teams when exchanging club jacks and club queens" << endl;
+}
+
+// checks that state can be reconstructed from its binary and its text serialization and that the reconstructed states serialize identically
+void test_serialization_round_trip(const Options &options, const BeliefGameState &state) {
+    vector<unsigned char> binary;
+    state.write_binary(binary);
+    string error;
+    BeliefGameState from_binary(options, binary, error);
+    assert(error.empty());
+    assert(from_binary == state);
+    vector<unsigned char> binary2;
+    from_binary.write_binary(binary2);
+    assert(binary2 == binary);
+
+    ostringstream text;
+    state.write_text(text);
+    istringstream text_stream(text.str());
+    BeliefGameState from_text(options, text_stream, error);
+    assert(error.empty());
+    assert(from_text == state);
+    ostringstream text2;
+    from_text.write_text(text2);
+    assert(text2.str() == text.str());
+}
+
+/*
+  Plays random games and checks the serialization of the states of all four
+  players and of a state with complete information (as used by Uct) after
+  every move.
+*/
+void test_serialization(int number_of_games, bool no_solo, int announcing_version) {
+    vector<player_t> players_types(4, RANDOM);
+    vector<vector<int> > players_options(4);
+    Options options(4, no_solo, !no_solo, players_types, true, 2012, XOSHIRO, false, false, false, false, players_options, false,
+                    announcing_version, "", "");
+    RandomNumberGenerator rng(2012);
+    int number_of_states = 0;
+    for (int game = 0; game < number_of_games; ++game) {
+        play_random_game(options, rng, [&](const RandomGame &random_game, const vector<Move> &) {
+            for (size_t i = 0; i < random_game.states.size(); ++i) {
+                test_serialization_round_trip(options, random_game.states[i]);
+                ++number_of_states;
+            }
+            return -1;
+        });
+    }
+    cout << "serialization: identical states after round trips of " << number_of_states << " states" << endl;
+}
+
+/*
+  Plays random games like test_serialization and reads the states of the
+  four players, unchanged and with one random byte changed (a small number
+  or a flipped bit). Every state which is accepted is searched by Uct like
+  the analysis server does, which must not fail any assertion. Also checks
+  that a text state following a malformed one is read correctly.
+*/
+void test_invalid_positions(int number_of_games, int number_of_changes, bool no_solo, int announcing_version) {
+    vector<player_t> players_types(4, UCT);
+    vector<int> player_options(DEFAULT_PLAYER_OPTIONS, DEFAULT_PLAYER_OPTIONS + NUMBER_OF_PLAYER_OPTIONS);
+    player_options[5] = 20; // rollouts
+    Options options(1, no_solo, !no_solo, players_types, true, 2012, XOSHIRO, false, false, false, false,
+                    vector<vector<int> >(4, player_options), false, announcing_version, "", "");
+    RandomNumberGenerator rng(2012);
+    int number_of_rejected_states = 0;
+    int number_of_searches = 0;
+    for (int game = 0; game < number_of_games; ++game) {
+        play_random_game(options, rng, [&](const RandomGame &random_game, const vector<Move> &legal_moves) {
+            if (legal_moves.empty())
+                return -1;
+            const vector<BeliefGameState> &states = random_game.states;
+            for (int i = 0; i < number_of_changes; ++i) {
+                vector<unsigned char> binary;
+                states[rng.next(4)].write_binary(binary);
+                if (i > 0) { // the first state is searched unchanged
+                    int position = rng.next(binary.size());
+                    if (rng.next(2) == 0)
+                        binary[position] = static_cast<unsigned char>(rng.next(16) - 2);
+                    else
+                        binary[position] ^= 1 << rng.next(8);
+                }
+                string error;
+                BeliefGameState state(options, binary, error);
+                if (!error.empty()) {
+                    ++number_of_rejected_states;
+                    continue;
+                }
+                if (state.game_finished() || state.get_player_to_move() != state.get_player_number())
+                    continue;
+                vector<Move> state_legal_moves;
+                state.get_owners_legal_moves(state_legal_moves);
+                if (state_legal_moves.size() < 2)
+                    continue;
+                state.set_uct_output(false);
+                Uct uct(options, state, state.get_players_cards(), 0);
+                uct.get_best_move();
+                ++number_of_searches;
+            }
+            // a malformed text state (a missing field other than the last one or an invalid value) followed by the state itself, which is read after the error
+            const BeliefGameState &state = states[rng.next(4)];
+            ostringstream text;
+            state.write_text(text);
+            vector<string> lines;
+            istringstream text_lines(text.str());
+            string line;
+            while (getline(text_lines, line))
+                lines.push_back(line);
+            int changed_line = rng.next(lines.size());
+            ostringstream stream;
+            for (size_t i = 0; i < lines.size(); ++i) {
+                if (static_cast<int>(i) != changed_line)
+                    stream << lines[i] << "\n";
+                else if (i + 1 == lines.size() || rng.next(2) == 0)
+                    stream << lines[i].substr(0, lines[i].find(' ')) << " x\n";
+            }
+            stream << text.str();
+            istringstream states_text(stream.str());
+            string error;
+            BeliefGameState malformed_state(options, states_text, error);
+            assert(!error.empty());
+            BeliefGameState read_state(options, states_text, error);
+            assert(error.empty());
+            assert(read_state == state);
+            return -1;
+        });
+    }
+    cout << "invalid positions: " << number_of_rejected_states << " changed states rejected, " << number_of_searches
+         << " searches of accepted states" << endl;
+}
+
+/*
+  Plays random games with complete information, records them like
+  GameLogWriter and checks that replay_game accepts the records, and that it
+  rejects them (without tripping any assertion) after replacing a random move
+  by a move which is not legal at that point.
+*/
+void test_game_log_replay(int number_of_games) {
+    vector<player_t> players_types(4, RANDOM);
+    vector<vector<int> > players_options(4);
+    Options options(4, false, true, players_types, true, 2012, XOSHIRO, false, false, false, false, players_options, false, 1, "", "");
+    RandomNumberGenerator rng(2012);
+    for (int game = 0; game < number_of_games; ++game) {
+        GameRecord record;
+        vector<vector<Move> > legal_moves;
+        int game_type = -1;
+        play_random_game(options, rng, [&](const RandomGame &random_game, const vector<Move> &moves) {
+            const BeliefGameState &state = random_game.states[4];
+            if (legal_moves.empty()) {
+                record.first_player = random_game.first_player;
+                record.vorfuehrung = false;
+                for (int i = 0; i < 4; ++i) {
+                    record.played_compulsory_solo[i] = random_game.played_compulsory_solo[i];
+                    record.players_types[i] = RANDOM;
+                    record.cards[i] = random_game.cards[i];
+                    record.score_points[i] = 0; // get_score_points adds to them
+                }
+            }
+            if (moves.empty()) {
+                state.get_score_points(record.score_points);
+                game_type = state.get_game_type()->get_index();
+                return -1;
+            }
+            legal_moves.push_back(moves);
+            int move_index = rng.next(moves.size());
+            record.players.push_back(state.get_player_to_move());
+            record.moves.push_back(moves[move_index]);
+            return move_index;
+        });
+        int replayed_game_type = -1;
+        assert(replay_game(options, record, replayed_game_type).empty());
+        assert(replayed_game_type == game_type);
+
+        size_t corrupted = rng.next(record.moves.size());
+        while (true) {
+            Move move = Move::from_id(rng.next(NUM_MOVE_IDS));
+            bool legal = false;
+            for (size_t i = 0; i < legal_moves[corrupted].size(); ++i)
+                legal = legal || legal_moves[corrupted][i].get_id() == move.get_id();
+            if (!legal) {
+                record.moves[corrupted] = move;
+                break;
+            }
+        }
+        assert(replay_game(options, record, replayed_game_type) == "move " + to_string(corrupted) + " cannot be replayed");
+    }
+    cout << "game log replay: " << number_of_games << " games replayed, corrupted moves rejected" << endl;
+}
+
+// forwards everything to a player and checks that it always chooses one of the legal moves
+class LegalMoveCheckingPlayer : public Player {
+    Player *player;
+public:
+    LegalMoveCheckingPlayer(int player_number, Player *player_) : Player(player_number), player(player_) {
+    }
+    void set_cards(Cards cards) {
+        player->set_cards(cards);
+    }
+    size_t ask_for_move(const vector<Move> &legal_moves) {
+        size_t move_index = player->ask_for_move(legal_moves);
+        assert(move_index < legal_moves.size());
+        return move_index;
+    }
+    void inform_about_move(int player_number, const Move &move) {
+        player->inform_about_move(player_number, move);
+    }
+    void inform_about_game_end(const int players_game_points[4]) {
+        player->inform_about_game_end(players_game_points);
+    }
+};
+
+/*
+  Plays sessions of random deals with four heuristic players, which must
+  choose a legal move whenever asked (also in the compulsory solos at the
+  end of a session) and must keep track of the games like ActualGameState.
+*/
+void test_heuristic_player(int number_of_games, bool no_solo, bool compulsory_solo, int announcing_version) {
+    vector<player_t> players_types(4, HEURISTIC);
+    vector<vector<int> > players_options(4);
+    Options options(number_of_games, no_solo, compulsory_solo, players_types, true, 2012, XOSHIRO, false, false, false, false,
+                    players_options, false, announcing_version, "", "");
+    log_level_t game_log_level = log_levels[LOG_GAME];
+    set_log_level(LOG_GAME, LOG_OFF);
+    HeuristicPlayer *heuristic_players[4];
+    Player *players[4];
+    for (int i = 0; i < 4; ++i) {
+        heuristic_players[i] = new HeuristicPlayer(i, options);
+        players[i] = new LegalMoveCheckingPlayer(i, heuristic_players[i]);
+    }
+    SessionProgress progress(options);
+    RandomNumberGenerator rng(2012);
+    int number_of_solos = 0;
+    while (progress.get_number_of_played_games() < number_of_games) {
+        Cards cards[4];
+        deal_cards(rng, cards);
+        for (int i = 0; i < 4; ++i)
+            players[i]->set_cards(cards[i]);
+        progress.start_game();
+        ActualGameState game_state(options, players, progress.get_first_player(), cards, progress.get_played_compulsory_solo(),
+                                   progress.is_vorfuehrung(), 0);
+        int points[4] = { 0, 0, 0, 0 };
+        game_state.get_score_points(points);
+        for (int i = 0; i < 4; ++i)
+            players[i]->inform_about_game_end(points);
+        if (*game_state.get_game_type() != regular && *game_state.get_game_type() != marriage)
+            ++number_of_solos;
+        progress.finish_game(game_state);
+    }
+    for (int i = 0; i < 4; ++i) {
+        delete players[i];
+        delete heuristic_players[i];
+    }
+    set_log_level(LOG_GAME, game_log_level);
+    cout << "heuristic player: legal moves in " << number_of_games << " games (" << number_of_solos << " solos)" << endl;
+}
+
+/*
+  Checks that generators are reproducible (also when copied), that different
+  streams differ, that the Mersenne Twister still produces the numbers of
+  older versions and that bounded numbers are uniformly distributed.
+*/
+void test_random_number_generator() {
+    for (int type = XOSHIRO; type <= MERSENNE_TWISTER; ++type) {
+        RandomNumberGenerator rng(2011, 3, static_cast<rng_t>(type));
+        for (int i = 0; i < 100; ++i)
+            rng.next32();
+        RandomNumberGenerator copy(rng);
+        RandomNumberGenerator assigned(17);
+        assigned = rng;
+        vector<uint64_t> state;
+        rng.get_state(state);
+        RandomNumberGenerator restored(17, 0, static_cast<rng_t>(type));
+        bool valid_state = restored.set_state(state);
+        assert(valid_state);
+        for (int i = 0; i < 1000; ++i) {
+            unsigned int value = rng.next32();
+            assert(copy.next32() == value);
+            assert(assigned.next32() == value);
+            assert(restored.next32() == value);
+        }
+        valid_state = RandomNumberGenerator(17, 0, static_cast<rng_t>(1 - type)).set_state(state);
+        assert(!valid_state);
+    }
+    RandomNumberGenerator streams[3] = { RandomNumberGenerator(2011, 0), RandomNumberGenerator(2011, 1),
+                                         RandomNumberGenerator(2011, 1) };
+    int equal_streams = 0;
+    for (int i = 0; i < 1000; ++i) {
+        unsigned int value = streams[0].next32();
+        unsigned int other_stream_value = streams[1].next32();
+        assert(streams[2].next32() == other_stream_value);
+        equal_streams += value == other_stream_value;
+    }
+    assert(equal_streams < 5);
+    RandomNumberGenerator rng(2011, 5, MERSENNE_TWISTER);
+    MersenneTwister mersenne_twister(2011);
+    for (int i = 0; i < 1000; ++i) {
+        assert(rng.next(i + 1) == mersenne_twister.next(i + 1));
+        assert(rng.next_half_open() == mersenne_twister.next_half_open());
+    }
+
+    const int bound = 6;
+    const int draws = 600000;
+    for (int type = XOSHIRO; type <= MERSENNE_TWISTER; ++type) {
+        RandomNumberGenerator generator(2012, 0, static_cast<rng_t>(type));
+        vector<int> counts(bound, 0);
+        for (int i = 0; i < draws; ++i) {
+            int value = generator.next(bound);
+            assert(value >= 0 && value < bound);
+            ++counts[value];
+        }
+        for (int i = 0; i < bound; ++i)
+            assert(abs(counts[i] - draws / bound) < draws / bound / 50);
+    }
+    cout << "random number generator: reproducible streams and uniform bounded numbers" << endl;
+}
+
+/*
+  Checks that the key of an opening book does not change when a king is
+  exchanged for the nine of the same suit (which keeps the profile of the hand)
+  and that the profiles of random hands repeat, i.e. that a book finds the hands
+  of new deals.
+*/
+void test_opening_book_keys(int number_of_deals) {
+    RandomNumberGenerator rng(2011, 0);
+    bool played_compulsory_solo[4] = { false, false, false, false };
+    vector<int> history;
+    set<uint64_t> profiles;
+    int exchanges = 0;
+    for (int deal = 0; deal < number_of_deals; ++deal) {
+        Cards cards[4];
+        deal_cards(rng, cards);
+        uint64_t key = OpeningBook::compute_key(cards[0], 1, played_compulsory_solo, false, history);
+        profiles.insert(OpeningBook::get_hand_profile(cards[0]));
+        vector<Card> single_cards;
+        cards[0].get_single_cards(single_cards);
+        for (size_t i = 0; i < single_cards.size(); ++i) {
+            int index = single_cards[i].get_index();
+            bool king = index < 30 && (index < 6 ? index / 2 == 1 : (index - 6) % 8 / 2 == 1);
+            if (!king || cards[0].contains_card(Card(index - 2)))
+                continue;
+            Cards exchanged = cards[0];
+            exchanged.remove_card(single_cards[i]);
+            exchanged.add_card(Card(index - 2));
+            assert(OpeningBook::compute_key(exchanged, 1, played_compulsory_solo, false, history) == key);
+            ++exchanges;
+        }
+    }
+    assert(exchanges > number_of_deals);
+    assert(static_cast<int>(profiles.size()) < number_of_deals / 2);
+    cout << "opening book keys: " << exchanges << " exchanges of kings and nines keep the key, " << profiles.size()
+         << " profiles in " << number_of_deals << " hands" << endl;
+}
+
+/*
+  Checks that select_uct_successor computes exactly the values of the scalar
+  uct formula and chooses the first selectable successor with the highest
+  value (up to epsilon), for any number of successors and also with ties.
+*/
+void test_uct_formula(int iterations) {
+    const double epsilon = 0.0000001;
+    RandomNumberGenerator rng(2012);
+    UctSuccessors successors;
+    for (int iteration = 0; iteration < iterations; ++iteration) {
+        int number_of_successors = rng.next(MAX_NUMBER_OF_SUCCESSORS + 1);
+        successors.number_of_successors = number_of_successors;
+        double log_node_trials = log(1 + rng.next(100000));
+        for (int i = 0; i < number_of_successors; ++i) {
+            successors.visits[i] = 1 + rng.next(1000);
+            if (rng.next(4) == 0 && i > 0) // the same statistics as another successor
+                successors.accumulated_rewards[i] = successors.accumulated_rewards[rng.next(i)];
+            else
+                successors.accumulated_rewards[i] = (rng.next_half_open() - 0.5) * 1000 * successors.visits[i];
+            successors.log_trials[i] = rng.next(2) == 0 ? log_node_trials : log(successors.visits[i] + rng.next(1000));
+            successors.selectable[i] = rng.next(5) != 0;
+        }
+        double exploration_constant = rng.next(3) == 0 ? 0 : rng.next(30000);
+        int best_index = select_uct_successor(successors, exploration_constant, epsilon);
+        int expected_best_index = -1;
+        double best_value = 0;
+        for (int i = 0; i < number_of_successors; ++i) {
+            double value = compute_uct_value_reference(successors.visits[i], successors.accumulated_rewards[i],
+                                                       successors.log_trials[i], exploration_constant);
+            assert(successors.values[i] == value);
+            if (successors.selectable[i] && (expected_best_index == -1 || value - best_value > epsilon)) {
+                best_value = value;
+                expected_best_index = i;
+            }
+        }
+        assert(best_index == expected_best_index);
+    }
+    cout << "uct formula: the same values and choices as the scalar formula" << endl;
+}
+
+/*
+  Checks that the compile time tables of game_type.cpp agree with the
+  original tables of GameType (see GameTypeReference) for every card of all
+  game types, and that GameType determines the same winners of tricks and
+  the same legal cards as the original implementations of Trick on the
+  original tables, for all pairs of cards and for the tricks of random games:
+  the legal cards of the player to move at every card move and the winner of
+  every trick.
+*/
+void test_game_type_tables(int number_of_games) {
+    for (int type = 0; type < GameType::NUMBER_OF_GAME_TYPES; ++type) {
+        const GameType *game_type = GameType::from_index(type);
+        const GameTypeReference &reference = get_game_type_reference(game_type);
+        assert(game_type->get_trump_suit() == reference.trump_suit);
+        for (int i = 0; i < 48; ++i) {
+            Card card(i);
+            assert(game_type->is_trump(card) == reference.trump_suit.contains_card(card));
+            assert(game_type->get_suit(card) == reference.card_to_suit[i]);
+            assert(game_type->get_rank(card) == reference.get_rank(card));
+        }
+        for (int first_card = 0; first_card < 48; ++first_card) {
+            for (int second_card = 0; second_card < 48; ++second_card) {
+                Trick trick(game_type, first_card % 4);
+                trick.set_card(first_card % 4, Card(first_card));
+                trick.set_card((first_card + 1) % 4, Card(second_card));
+                assert(trick.taken_by() == taken_by_reference(game_type, trick));
+            }
+        }
+    }
+    vector<player_t> players_types(4, RANDOM);
+    vector<vector<int> > players_options(4);
+    Options options(4, false, true, players_types, true, 2012, XOSHIRO, false, false, false, false, players_options, false, 1, "", "");
+    RandomNumberGenerator rng(2012);
+    int number_of_tricks[GameType::NUMBER_OF_GAME_TYPES] = { 0 };
+    for (int game = 0; game < number_of_games; ++game) {
+        play_random_game(options, rng, [&](const RandomGame &random_game, const vector<Move> &legal_moves) {
+            if (legal_moves.empty() || !legal_moves[0].is_card_move())
+                return -1;
+            const BeliefGameState &state = random_game.states[4];
+            const GameType *game_type = state.get_game_type();
+            Trick trick = state.get_current_trick();
+            int player = state.get_player_to_move();
+            Cards hand = random_game.states[player].get_players_cards();
+            assert(trick.get_legal_cards(hand) == get_legal_cards_reference(game_type, trick, hand));
+            int move_index = rng.next(legal_moves.size());
+            trick.set_card(player, legal_moves[move_index].get_card());
+            if (trick.completed()) {
+                assert(trick.taken_by() == taken_by_reference(game_type, trick));
+                ++number_of_tricks[game_type->get_index()];
+            }
+            return move_index;
+        });
+    }
+    int total_number_of_tricks = 0;
+    for (int type = 0; type < GameType::NUMBER_OF_GAME_TYPES; ++type) {
+        assert(number_of_tricks[type] > 0);
+        total_number_of_tricks += number_of_tricks[type];
+    }
+    cout << "game type tables: the same suits, ranks, winners of tricks and legal cards as the original implementation in "
+         << total_number_of_tricks << " tricks of all game types" << endl;
+}
+
+// the number of ways to deal the remaining cards (with distinguishable copies) to the other players than the player to move, consistent with the information of the state
+int count_card_assignments_reference(const BeliefGameState &state, const vector<Card> &remaining_cards, size_t index,
+                                     Cards players_cards[4]) {
+    if (index == remaining_cards.size()) {
+        for (int i = 0; i < 4; ++i) {
+            if (state.get_players_must_have_queen_of_clubs()[i] && !players_cards[i].contains_card(CQ)
+                && !players_cards[i].contains_card(CQ_))
+                return 0;
+        }
+        return 1;
+    }
+    int count = 0;
+    for (int i = 0; i < 4; ++i) {
+        if (i == state.get_player_to_move() || state.get_cards_that_players_cannot_have()[i].contains_card(remaining_cards[index])
+            || players_cards[i].size() == state.get_players_cards_count()[i])
+            continue;
+        players_cards[i].add_card(remaining_cards[index]);
+        count += count_card_assignments_reference(state, remaining_cards, index + 1, players_cards);
+        players_cards[i].remove_card(remaining_cards[index]);
+    }
+    return count;
+}
+
+// how many copies of every card every player has, i.e. the same for card assignments which only differ in which copy of a card a player has
+string get_number_of_copies(const Cards players_cards[4]) {
+    string number_of_copies;
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 48; j += 2)
+            number_of_copies += static_cast<char>('0' + players_cards[i].contains_card(Card(j)) + players_cards[i].contains_card(Card(j + 1)));
+    }
+    return number_of_copies;
+}
+
+/*
+  Plays random games (including random game type and announcement moves) and
+  checks for the player to move in the last four tricks that
+  CardAssignment::enumerate_card_assignments computes distinct card
+  assignments consistent with the information of the player, that their
+  weights sum up to the number of deals found by a naive enumeration and
+  that the enumeration stops if there are too many card assignments.
+*/
+void test_card_assignment_enumeration(int number_of_games) {
+    vector<player_t> players_types(4, RANDOM);
+    vector<vector<int> > players_options(4);
+    Options options(4, false, true, players_types, true, 2012, XOSHIRO, false, false, false, false, players_options, false, 1, "", "");
+    RandomNumberGenerator rng(2012);
+    int number_of_positions = 0;
+    int number_of_card_assignments = 0;
+    for (int game = 0; game < number_of_games; ++game) {
+        play_random_game(options, rng, [&](const RandomGame &random_game, const vector<Move> &legal_moves) {
+            if (legal_moves.empty())
+                return -1;
+            int player = random_game.states[4].get_player_to_move();
+            const BeliefGameState &state = random_game.states[player];
+            if (legal_moves[0].is_card_move() && state.get_number_of_completed_tricks() >= 8
+                && state.get_number_of_completed_tricks() < 11) {
+                Cards players_cards = state.get_players_cards();
+                vector<Card> remaining_cards;
+                for (int i = 0; i < 48; ++i) {
+                    if (!state.get_played_cards().contains_card(Card(i)) && !players_cards.contains_card(Card(i)))
+                        remaining_cards.push_back(Card(i));
+                }
+                Cards assigned_cards[4];
+                int number_of_deals = count_card_assignments_reference(state, remaining_cards, 0, assigned_cards);
+
+                CardAssignment card_assignment(state, players_cards);
+                vector<WeightedCardAssignment> card_assignments;
+                bool complete = card_assignment.enumerate_card_assignments(state, 1000000, card_assignments);
+                assert(complete);
+                int sum_of_weights = 0;
+                set<string> distinct_card_assignments;
+                for (size_t i = 0; i < card_assignments.size(); ++i) {
+                    const WeightedCardAssignment &assignment = card_assignments[i];
+                    sum_of_weights += assignment.weight;
+                    Cards all_cards = players_cards;
+                    all_cards.add_cards(state.get_played_cards());
+                    for (int j = 0; j < 4; ++j) {
+                        if (j == player) {
+                            assert(assignment.players_cards[j].empty());
+                            continue;
+                        }
+                        assert(assignment.players_cards[j].size() == state.get_players_cards_count()[j]);
+                        Cards allowed_cards = assignment.players_cards[j];
+                        allowed_cards.remove_cards(state.get_cards_that_players_cannot_have()[j]);
+                        assert(allowed_cards == assignment.players_cards[j]);
+                        all_cards.add_cards(assignment.players_cards[j]);
+                    }
+                    assert(all_cards.size() == 48);
+                    bool is_new = distinct_card_assignments.insert(get_number_of_copies(assignment.players_cards)).second;
+                    assert(is_new);
+                }
+                assert(sum_of_weights == number_of_deals);
+                if (card_assignments.size() > 1) {
+                    vector<WeightedCardAssignment> too_few;
+                    complete = card_assignment.enumerate_card_assignments(state, card_assignments.size() - 1, too_few);
+                    assert(!complete);
+                }
+                ++number_of_positions;
+                number_of_card_assignments += card_assignments.size();
+            }
+            return -1;
+        });
+    }
+    cout << "card assignment enumeration: " << number_of_card_assignments << " card assignments at " << number_of_positions
+         << " positions, weighted like all deals" << endl;
+}
+
+/*
+  Plays random regular games without announcements and searches the cards
+  of the first two tricks of player 0 with uct version 1, whose rollouts ask
+  the other players for announcements while their teams differ between the
+  card assignments. The successors of a node must not split on the team of
+  the player (see Node::add_successor), and the player to move of every node
+  must match the states of all rollouts passing through it (see
+  Uct::rollout).
+*/
+void test_uct_announcement_prompts(int number_of_games) {
+    vector<player_t> players_types(4, RANDOM);
+    players_types[0] = UCT;
+    vector<vector<int> > players_options(4);
+    players_options[0].assign(DEFAULT_PLAYER_OPTIONS, DEFAULT_PLAYER_OPTIONS + NUMBER_OF_PLAYER_OPTIONS);
+    players_options[0][5] = 300; // rollouts
+    Options options(4, false, false, players_types, true, 2012, XOSHIRO, false, false, false, false, players_options, false, 1, "", "");
+    RandomNumberGenerator rng(2012);
+    int number_of_searches = 0;
+    for (int game = 0; game < number_of_games; ++game) {
+        play_random_game(options, rng, [&](const RandomGame &random_game, const vector<Move> &legal_moves) {
+            if (legal_moves.empty())
+                return -1;
+            // a regular game without any announcements keeps the teams hidden
+            if (!legal_moves[0].is_card_move())
+                return 0;
+            const BeliefGameState &state = random_game.states[0];
+            if (state.get_player_to_move() == 0 && legal_moves.size() > 1 && state.get_number_of_completed_tricks() < 2) {
+                Uct uct(options, state, state.get_players_cards(), 0);
+                assert(uct.get_best_move() < legal_moves.size());
+                ++number_of_searches;
+            }
+            return -1;
+        });
+    }
+    cout << "uct announcement prompts: consistent trees in " << number_of_searches << " searches" << endl;
+}
+
 int main() {
+    Cards::setup_bit_count();
+    test_random_number_generator();
+    test_opening_book_keys(10000);
+    test_uct_formula(100000);
+    test_game_type_tables(5000);
+    test_card_assignment_enumeration(50);
+    test_uct_announcement_prompts(10);
+    test_best_move_index(1000);
+    test_card_equivalence(1000);
+    test_serialization(100, false, 1);
+    test_serialization(100, true, 0);
+    test_invalid_positions(30, 10, false, 1);
+    test_invalid_positions(30, 10, true, 0);
+    test_game_log_replay(500);
+    test_heuristic_player(200, false, true, 1);
+    test_heuristic_player(200, true, false, 0);
+
     announcement_t announcements[2] = { NONE, NONE };
     test(0, announcements, 120);
     announcements[0] = REKON;
@@ -30,12 +30,16 @@ class GameType;
 class Trick {
 private:
     const GameType *game_type;
-    int first_player;
-    Card cards[4]; // cards in the trick
+    signed char first_player;
+    signed char cards[4]; // indices of the cards in the trick (-1 if the player did not play a card yet). stored as indices rather than as Card to keep GameState small (see GameState::tricks)
 public:
+    Trick() {} // needed for the fixed size array of tricks in GameState
     Trick(const GameType *game_type, int first_player);
     void get_legal_cards_for_player(int player, std::vector<Move> &legal_moves, Cards players_cards) const;
-    void set_card(int player, Card card);
+    Cards get_legal_cards(Cards players_cards) const; // the cards of players_cards which can be played into the trick. added for BeliefGameState::get_best_move_index
+    void set_card(int player, Card card) {
+        cards[player] = card.get_index();
+    }
     // Updated for BeliefGameState to allow to be called even when the trick is not completed. The player returned is the player who would win the trick so far
     int taken_by() const;
     int get_value_() const;
@@ -50,6 +54,7 @@ public:
     }
     void dump() const;
     Cards get_trick_suit() const; // introduced for BeliefGameState
+    Cards get_cards() const; // added for BeliefGameState::merge_equivalent_cards
     bool operator==(const Trick &rhs) const { // added for BeliefGameState==
         assert(first_player == rhs.first_player);
         for (int i = 0; i < 4; ++i)
@@ -57,6 +62,13 @@ public:
         return true;
     }
     int get_size() const; // made public for BeliefGameState
+    // made public for the serialization of BeliefGameState
+    int get_first_player() const {
+        return first_player;
+    }
+    Card get_card(int player) const {
+        return cards[player] == -1 ? no_card : Card(cards[player]);
+    }
 };
 
 #endif
@@ -21,12 +21,14 @@
 
 #include "belief_game_state.h"
 #include "card_assignment.h"
+#include "logging.h"
 #include "move.h"
 #include "options.h"
+#include "uct_formula.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
-#include <iomanip>
 #include <iostream>
 #include <stdio.h>
 #include <stdlib.h>
@@ -36,7 +38,15 @@ using namespace std;
 
 const double EPSILON = 0.0000001;
 
-Node::Node(const int id_, int player_to_move_) : id(id_), player_to_move(player_to_move_), parent(0), num_visits(0)/**,
+// keeps only one of every class of strategically equivalent moves (see the documentation of Uct)
+static void merge_equivalent_moves(const BeliefGameState &state, vector<Move> &legal_moves) {
+    if (!legal_moves[0].is_card_move())
+        return;
+    merge_duplicate_cards(legal_moves);
+    state.merge_equivalent_cards(legal_moves);
+}
+
+Node::Node(const int id_, int player_to_move_) : id(id_), player_to_move(player_to_move_), parent(0), successor_index(0), num_visits(0), num_available(0)/**,
     player_to_move2(player_to_move_), parent2(0), num_visits2(0)*/ {
     for (int i = 0; i < 4; ++i) {
         accumulated_reward[i] = 0.0;
@@ -48,26 +58,76 @@ Node::~Node() {
     for (size_t i = 0; i < successors.size(); ++i) {
         delete successors[i];
     }
+    delete[] successor_index;
+}
+
+int Node::get_successor_index(const Move &move) const {
+    if (successor_index == 0) { // at most one successor
+        if (!moves.empty() && moves[0].get_merged_id() == move.get_merged_id())
+            return 0;
+        return -1;
+    }
+    return successor_index[move.get_merged_id()];
+}
+
+int Node::get_successor_index(const Move &move, int successor_player_to_move) const {
+    int first_index = get_successor_index(move);
+    if (first_index == -1)
+        return -1;
+    // only announcements can lead to several successors, which are at most a few
+    for (size_t i = first_index; i < successors.size(); ++i) {
+        if (moves[i].get_merged_id() == move.get_merged_id() && successors[i]->player_to_move == successor_player_to_move)
+            return i;
+    }
+    return -1;
+}
+
+void Node::add_successor(const Move &move, Node *successor) {
+    // successors must not split on hidden information: a move (independently of the team of an announcement, see Move::is_same_ignoring_team()) leads to at most one successor per player to move
+    for (size_t i = 0; i < successors.size(); ++i)
+        assert(!(moves[i].is_same_ignoring_team(move) && successors[i]->player_to_move == successor->player_to_move));
+    if (successors.size() == 1) { // most nodes never get a second successor, thus only allocate the lookup table now
+        successor_index = new signed char[NUM_MOVE_IDS];
+        for (int i = 0; i < NUM_MOVE_IDS; ++i)
+            successor_index[i] = -1;
+        successor_index[moves[0].get_merged_id()] = 0;
+    }
+    if (successor_index != 0 && successor_index[move.get_merged_id()] == -1)
+        successor_index[move.get_merged_id()] = static_cast<signed char>(successors.size());
+    moves.push_back(move);
+    successors.push_back(successor);
 }
 
 void Node::dump() const {
-    cout << "node id: " << id << endl;
-    cout << "player to move: " << player_to_move << endl;
+    log_stream() << "node id: " << id << '\n';
+    log_stream() << "player to move: " << player_to_move << '\n';
     ///cout << "player to move2: " << player_to_move2 << endl;
-    cout << "number of successors: " << successors.size() << endl;
+    log_stream() << "number of successors: " << successors.size() << '\n';
     ///cout << "number of successors2: " << successors2.size() << endl;
-    cout << "number of visits: " << num_visits << endl;
+    log_stream() << "number of visits: " << num_visits << '\n';
+    log_stream() << "number of times available: " << num_available << '\n';
     ///cout << "number of visits2: " << num_visits2 << endl;
-    cout << "accumulated players' rewards: ";
+    log_stream() << "accumulated players' rewards: ";
     for (int i = 0; i < 4; ++i)
-        cout << i << ": " << accumulated_reward[i] << " ";
-    cout << endl;
+        log_stream() << i << ": " << accumulated_reward[i] << " ";
+    log_stream() << '\n';
     /**cout << "accumulated players' rewards2: ";
     for (int i = 0; i < 4; ++i)
         cout << i << ": " << accumulated_reward2[i] << " ";
     cout << endl;*/
 }
 
+static size_t get_subtree_bytes(const Node *node) {
+    size_t bytes = sizeof(Node) + node->successors.capacity() * sizeof(Node *) + node->moves.capacity() * sizeof(Move);
+    if (node->successor_index != 0)
+        bytes += NUM_MOVE_IDS;
+    for (size_t i = 0; i < node->successors.size(); ++i) {
+        if (node->successors[i] != 0)
+            bytes += get_subtree_bytes(node->successors[i]);
+    }
+    return bytes;
+}
+
 /**static void check_node_consistency(Node *current_node) {
     assert(current_node->player_to_move == current_node->player_to_move2);
     assert(current_node->parent == current_node->parent2);
@@ -90,27 +150,45 @@ void Node::dump() const {
 }*/
 
 Uct::Uct(const Options &options_, const BeliefGameState &state, Cards players_cards, int move_number_)
-    : options(options_), uct_player(state.get_player_to_move()), rng(2011), move_number(move_number_),
-    nodes_counter(0) {
-    if (options.use_uct_verbose())
-        cout << endl << "uct instance " << uct_player << " beginning" << endl;
+    : options(options_), uct_player(state.get_player_to_move()),
+    rng(options.create_random_number_generator(UCT_STREAM, uct_player)), move_number(move_number_),
+    nodes_counter(0), number_of_nodes(0), tree_bytes(0), round_end(0),
+    enumerates_card_assignments(false) {
+    if (log_enabled(LOG_UCT, LOG_VERBOSE))
+        log_stream() << "\nuct instance " << uct_player << " beginning\n";
     assert(players_cards.size() >= 1);
 
+    CardAssignment card_assignment(state, players_cards);
+    RandomNumberGenerator card_assignment_rng(options.create_random_number_generator(CARD_ASSIGNMENT_STREAM, uct_player));
+    vector<WeightedCardAssignment> card_assignments;
+    if (options.get_card_assignments_limit(uct_player) > 0)
+        enumerates_card_assignments = card_assignment.enumerate_card_assignments(state, options.get_card_assignments_limit(uct_player),
+                                                                                 card_assignments);
     if (options.get_uct_version(uct_player) == 1) {
+        vector<int> schedule; // enumerated card assignments only: every card assignment as often as its weight, in random order
+        if (enumerates_card_assignments) {
+            for (size_t i = 0; i < card_assignments.size(); ++i)
+                schedule.insert(schedule.end(), card_assignments[i].weight, i);
+            random_shuffle(schedule.begin(), schedule.end(), rng);
+            if (log_enabled(LOG_UCT, LOG_VERBOSE))
+                log_stream() << "using all " << card_assignments.size() << " card assignments\n";
+        }
         root = new Node(0, uct_player);
-        CardAssignment card_assignment(options, state, players_cards);
         for (int i = 0; i < options.get_number_of_rollouts(uct_player); ++i) {
-            BeliefGameState *start_state = new BeliefGameState(state);
-            start_state->set_uct_output(false);
-            card_assignment.assign_cards_to_players(*start_state);
-            if (i == 0 && options.use_uct_verbose()) {
-                vector<Move> legal_moves;
-                start_state->get_legal_moves(legal_moves);
-                cout << legal_moves << endl;
+            BeliefGameState start_state(state); // BeliefGameState is trivially copyable, thus this is a plain memory copy without any heap allocation
+            start_state.set_uct_output(false);
+            if (enumerates_card_assignments)
+                start_state.set_other_players_cards(card_assignments[schedule[i % schedule.size()]].players_cards);
+            else
+                card_assignment.assign_cards_to_players(start_state, card_assignment_rng);
+            if (i == 0) {
+                start_state.get_legal_moves(legal_moves_at_root);
+                if (log_enabled(LOG_UCT, LOG_VERBOSE))
+                    log_stream() << legal_moves_at_root << '\n';
             }
-            rollout(start_state, i);
-            delete start_state;
+            rollout(&start_state, i);
         }
+        update_tree_size();
         if (average_rewards.empty()) {
             average_rewards.resize(root->successors.size(), 0.0);
             move_indices_count.resize(root->successors.size(), 0);
@@ -121,35 +199,47 @@ Uct::Uct(const Options &options_, const BeliefGameState &state, Cards players_ca
         unsigned int best_move = calculate_best_move_index(root, options.get_number_of_rollouts(uct_player));
         ++move_indices_count[best_move];
     } else {
-        CardAssignment card_assignment(options, state, players_cards);
-        for (int i = 0; i < options.get_number_of_simulations(uct_player); ++i) {
-            if (options.use_uct_debug() && move_number == 11)
-                cout << "starting simulation number " << i << endl;
+        int sum_of_weights = 0;
+        for (size_t i = 0; i < card_assignments.size(); ++i)
+            sum_of_weights += card_assignments[i].weight;
+        if (enumerates_card_assignments && log_enabled(LOG_UCT, LOG_VERBOSE))
+            log_stream() << "searching all " << card_assignments.size() << " card assignments\n";
+        int number_of_trees = enumerates_card_assignments ? card_assignments.size() : options.get_number_of_simulations(uct_player);
+        for (int i = 0; i < number_of_trees; ++i) {
+            if (log_enabled(LOG_UCT, LOG_DEBUG) && move_number == 11)
+                log_stream() << "starting simulation number " << i << '\n';
             root = new Node(0, uct_player);
             nodes_counter = 0;
+            root_candidates.clear();
             BeliefGameState *one_state = new BeliefGameState(state);
             one_state->set_uct_output(false);
-            card_assignment.assign_cards_to_players(*one_state);
-            if (i == 0 && options.use_uct_verbose()) {
-                vector<Move> legal_moves;
-                one_state->get_legal_moves(legal_moves);
-                cout << legal_moves << endl;
+            if (enumerates_card_assignments)
+                one_state->set_other_players_cards(card_assignments[i].players_cards);
+            else
+                card_assignment.assign_cards_to_players(*one_state, card_assignment_rng);
+            if (i == 0) {
+                one_state->get_legal_moves(legal_moves_at_root);
+                if (log_enabled(LOG_UCT, LOG_VERBOSE))
+                    log_stream() << legal_moves_at_root << '\n';
             }
             belief_game_states.push_back(one_state);
             for (int j = 0; j < options.get_number_of_rollouts(uct_player); ++j) {
-                BeliefGameState *start_state = new BeliefGameState(*one_state);
-                rollout(start_state, j);
-                delete start_state;
+                BeliefGameState start_state(*one_state);
+                rollout(&start_state, j);
             }
             ///check_node_consistency(root);
+            update_tree_size();
             if (average_rewards.empty()) {
                 average_rewards.resize(root->successors.size(), 0.0);
+                root_visits.resize(root->successors.size(), 0);
                 move_indices_count.resize(root->successors.size(), 0);
             }
+            double weight = enumerates_card_assignments ? static_cast<double>(card_assignments[i].weight) / sum_of_weights : 1.0; // the probability of the card assignment
             for (size_t j = 0; j < root->successors.size(); ++j) {
                 if (root->successors[j] == 0) // if number of rollouts is set to be smaller than the number of possible moves for the player then stop the loop as soon as encountering a non expanded node
                     break;
-                average_rewards[j] += root->successors[j]->accumulated_reward[uct_player] / root->successors[j]->num_visits;
+                average_rewards[j] += weight * root->successors[j]->accumulated_reward[uct_player] / root->successors[j]->num_visits;
+                root_visits[j] += root->successors[j]->num_visits;
             }
             ///unsigned int best_move2[1] = { 0 };
             unsigned int best_move = calculate_best_move_index(root, options.get_number_of_rollouts(uct_player)/**, best_move2*/);
@@ -160,6 +250,24 @@ Uct::Uct(const Options &options_, const BeliefGameState &state, Cards players_ca
             delete root;
         }
     }
+    if (log_enabled(LOG_UCT, LOG_VERBOSE))
+        log_stream() << "uct instance " << uct_player << ": largest tree with " << number_of_nodes << " nodes (" << tree_bytes
+             << " bytes)\n";
+}
+
+double Uct::get_sum_of_tree_weights() const {
+    return enumerates_card_assignments ? 1.0 : options.get_number_of_simulations(uct_player);
+}
+
+bool Uct::node_budget_reached() const {
+    return options.get_node_budget(uct_player) > 0 && nodes_counter >= options.get_node_budget(uct_player);
+}
+
+void Uct::update_tree_size() {
+    if (nodes_counter >= number_of_nodes) {
+        number_of_nodes = nodes_counter;
+        tree_bytes = get_subtree_bytes(root);
+    }
 }
 
 Uct::~Uct() {
@@ -172,7 +280,7 @@ Uct::~Uct() {
 }
 
 unsigned int Uct::calculate_best_move_index(Node *node,  int number_of_rollout, /*unsigned int *max_index2, */bool with_exploration_term,
-                                            const BeliefGameState *state, unsigned int *move_index) const {
+                                            const int *successor_to_move_index, unsigned int *move_index) const {
     /** for debugging purposes
     vector<pair<size_t, size_t> > correct_version;
     vector<pair<size_t, size_t> > wrong_version;
@@ -389,105 +497,143 @@ unsigned int Uct::calculate_best_move_index(Node *node,  int number_of_rollout,
     //    //exit(0);
     //}*/
 
-    int max_index = -1;
-    double best_reward_so_far = 0;
-    bool only_negative_rewards = true;
+    // gather the statistics of the successors for the uct formula (see uct_formula.h)
+    UctSuccessors successors;
+    successors.number_of_successors = node->successors.size();
+    double log_node_trials = log(options.use_wrong_uct_formula(uct_player) ? number_of_rollout : node->num_visits);
+    bool expanded = true;
     for (size_t i = 0; i < node->successors.size(); ++i) {
-        int current_move_index = -1; // for uct version 1, need to store the index of vector legal moves and write it to move_index in the end. max_index is still needed for accessing the right successor
+        const Node *successor = node->successors[i];
+        bool selectable = true;
         if (options.get_uct_version(uct_player) == 1) {
-            assert(node->successors[i] != 0);
+            assert(successor != 0);
             if (with_exploration_term) { // if this method is called by get_best_move, then node == root and at root, all card assignments  yield the same successors because the uct player himself is being asked to play, thus only for the other cases, need to check if the current successor is actually consistent to the current card assignment. if not, do not consider it for computations.
-                vector<Move> legal_moves;
-                state->get_legal_moves(legal_moves);
-                assert(legal_moves.size() > 0);
-                bool move_contained = false;
-                for (size_t j = 0; j < legal_moves.size(); ++j) {
-                    if (node->moves[i] == legal_moves[j]) {
-                        // NOTE: explanations about this extra check see "NOTE" below, at rollout(), line 512
-                        BeliefGameState state_copy(*state);
-                        state_copy.set_move(state_copy.get_player_to_move(), legal_moves[j]);
-                        if (state_copy.get_player_to_move() == node->successors[i]->player_to_move) {
-                            // NOTE: || node->successors[i]->player_to_move == -2 needs to be added as an additional check if also using version 0 to use this style of only adding successors to a node which are actually going to be visited and not all of them as it is done right now. No explanation found why version 1 does not require this extra check...
-                            move_contained = true;
-                            current_move_index = j;
-                            break;
-                        }
-                    }
-                }
-                if (!move_contained)
-                    continue;
-                assert(legal_moves[current_move_index] == node->moves[i]);
+                // successor_to_move_index has been computed by rollout() for the current card assignment
+                selectable = successor_to_move_index[i] != -1;
             }
         } else {
-            // if number of rollouts is set to be smaller than the number of possible moves for the player then stop the loop as soon as encountering a non expanded node (because nodes are expanded in the order of increasing indices)
-            if (node->successors[i] == 0)
-                break;
+            // if number of rollouts is set to be smaller than the number of possible moves for the player then ignore all successors from the first non expanded node on (because nodes are expanded in the order of increasing indices)
+            if (successor == 0)
+                expanded = false;
+            selectable = expanded;
         }
-
-        int num_visits = node->successors[i]->num_visits;
-        double current_reward = node->successors[i]->accumulated_reward[node->player_to_move] / num_visits;
-        if (options.get_announcement_option(uct_player) == 2 && !with_exploration_term
-            && root->moves[0].is_announcement_move() && current_reward > 0) {
-            only_negative_rewards = false;
+        if (!with_exploration_term && !is_root_candidate(node, i)) // sequential halving chooses among the remaining candidates
+            selectable = false;
+        successors.selectable[i] = selectable;
+        if (successor == 0) { // not selectable, any values avoiding a division by 0 do
+            successors.visits[i] = 1;
+            successors.accumulated_rewards[i] = 0;
+            successors.log_trials[i] = 0;
+            continue;
         }
-        double reward_copy = current_reward;
-        double exploration_term = static_cast<double>(options.get_exploration_constant(uct_player)) * sqrt(log(options.use_wrong_uct_formula(uct_player) ? number_of_rollout : node->num_visits) / num_visits);
-        if (options.use_uct_verbose() && (options.get_uct_version(uct_player) == 1 && !with_exploration_term)) {
-            cout << "index " << i << ":";
-            cout << " num visits: " << num_visits;
-            cout << " average reward: " << current_reward;
-            cout << " exploration term: " << exploration_term << endl;
-            cout << "index " << i << " yields a result of " << current_reward << endl;
+        successors.visits[i] = successor->num_visits;
+        successors.accumulated_rewards[i] = successor->accumulated_reward[node->player_to_move];
+        if (options.use_availability_counts(uct_player))
+            successors.log_trials[i] = log(successor->num_available);
+        else
+            successors.log_trials[i] = log_node_trials;
+    }
+    double exploration_constant = static_cast<double>(options.get_exploration_constant(uct_player));
+    int max_index = select_uct_successor(successors, with_exploration_term ? exploration_constant : 0.0, EPSILON);
+    assert(max_index >= 0);
+
+    if (!with_exploration_term) {
+        bool only_negative_rewards = true;
+        for (size_t i = 0; i < node->successors.size(); ++i) {
+            if (!successors.selectable[i])
+                continue;
+            double average_reward = successors.values[i];
+            if (average_reward > 0)
+                only_negative_rewards = false;
+            if (log_enabled(LOG_UCT, LOG_VERBOSE) && options.get_uct_version(uct_player) == 1) {
+                log_stream() << "index " << i << ":";
+                log_stream() << " num visits: " << successors.visits[i];
+                log_stream() << " average reward: " << average_reward;
+                log_stream() << " exploration term: "
+                             << exploration_constant * sqrt(successors.log_trials[i] / successors.visits[i]) << '\n';
+                log_stream() << "index " << i << " yields a result of " << average_reward << '\n';
+            }
         }
-        if (with_exploration_term) {
-            current_reward += static_cast<double>(options.get_exploration_constant(uct_player)) * sqrt(log(options.use_wrong_uct_formula(uct_player) ? number_of_rollout : node->num_visits) / num_visits);
-            reward_copy += exploration_term;
-            //assert(current_reward == reward_copy);
+        if (options.get_announcement_option(uct_player) == 2 && root->moves[0].is_announcement_move()
+            && only_negative_rewards) {
+            if (log_enabled(LOG_UCT, LOG_VERBOSE))
+                log_stream() << "all successors yield a negative reward, forbid announcing\n";
+            return 0;
         }
-        if (max_index == -1 || (current_reward - best_reward_so_far) > EPSILON) {
-            if ((current_reward - best_reward_so_far) > EPSILON && (reward_copy - best_reward_so_far) <= EPSILON) {
-                cout << setprecision(25);
-                cout << "ERROR" << endl;
-                cout << "best reward so far: " << best_reward_so_far << endl;
-                cout << "current reward: " << current_reward << endl;
-                cout << "reward copy: " << reward_copy << endl;
-                exit(2);
-            }
-            best_reward_so_far = current_reward;
-            if (options.get_uct_version(uct_player) == 1 && with_exploration_term) {
-                assert(current_move_index >= 0);
-                move_index[0] = static_cast<unsigned int>(current_move_index);
-            }
-            max_index = i;
+    } else if (options.get_uct_version(uct_player) == 1) { // need to store the index of vector legal moves in move_index. max_index is still needed for accessing the right successor
+        assert(successor_to_move_index[max_index] >= 0);
+        move_index[0] = static_cast<unsigned int>(successor_to_move_index[max_index]);
+    }
+    return static_cast<unsigned int>(max_index);
+}
+
+bool Uct::is_root_candidate(Node *node, int index) const {
+    if (node != root || root_candidates.empty())
+        return true;
+    return find(root_candidates.begin(), root_candidates.end(), index) != root_candidates.end();
+}
+
+void Uct::start_halving_round(int number_of_rollout) {
+    // the remaining rollouts are split evenly between the remaining rounds, each of which halves the candidates
+    int number_of_rounds = 0;
+    while ((1 << number_of_rounds) < static_cast<int>(root_candidates.size()))
+        ++number_of_rounds;
+    int number_of_rollouts = options.get_number_of_rollouts(uct_player);
+    if (number_of_rounds == 0)
+        round_end = number_of_rollouts;
+    else
+        round_end = number_of_rollout + max(static_cast<int>(root_candidates.size()),
+                                            (number_of_rollouts - number_of_rollout) / number_of_rounds);
+}
+
+unsigned int Uct::select_root_successor(int number_of_rollout) {
+    if (root_candidates.empty()) { // all successors of the root have been visited once: the first round starts
+        for (size_t i = 0; i < root->successors.size(); ++i)
+            root_candidates.push_back(i);
+        start_halving_round(number_of_rollout);
+    } else if (number_of_rollout >= round_end && root_candidates.size() > 1) { // discard the worse half of the candidates
+        vector<pair<double, int> > candidates; // negated average reward (to sort the best candidates first), index
+        for (size_t i = 0; i < root_candidates.size(); ++i) {
+            const Node *successor = root->successors[root_candidates[i]];
+            candidates.push_back(make_pair(-successor->accumulated_reward[uct_player] / successor->num_visits, root_candidates[i]));
         }
+        sort(candidates.begin(), candidates.end());
+        root_candidates.resize((root_candidates.size() + 1) / 2);
+        for (size_t i = 0; i < root_candidates.size(); ++i)
+            root_candidates[i] = candidates[i].second;
+        if (log_enabled(LOG_UCT, LOG_DEBUG))
+            log_stream() << "sequential halving: " << root_candidates.size() << " candidates left after rollout "
+                         << number_of_rollout << '\n';
+        start_halving_round(number_of_rollout);
     }
-    assert(max_index >= 0);
-    if (options.get_announcement_option(uct_player) == 2 && !with_exploration_term
-        && root->moves[0].is_announcement_move() && only_negative_rewards) {
-        if (options.use_uct_verbose())
-            cout << "all successors yield a negative reward, forbid announcing" << endl;
-        return 0;
+    // spread the rollouts of a round evenly over the candidates
+    int selected = root_candidates[0];
+    for (size_t i = 1; i < root_candidates.size(); ++i) {
+        if (root->successors[root_candidates[i]]->num_visits < root->successors[selected]->num_visits)
+            selected = root_candidates[i];
     }
-    return static_cast<unsigned int>(max_index);
+    return static_cast<unsigned int>(selected);
 }
 
 void Uct::propagate_values(Node *current_node, BeliefGameState *current_state) {
     // current_node is the last visited node (which is in most of the cases not coinciding with current_state!)
-    assert(current_state->game_finished());
     int score_points[4] = { 0, 0, 0, 0 };
     int players_points[4] = { 0, 0, 0, 0 };
     int team_points[2] = { 0, 0 };
     double uct_rewards[4];
-    current_state->get_score_points(score_points, players_points, team_points);
+    if (current_state->game_finished())
+        current_state->get_score_points(score_points, players_points, team_points);
+    else // truncated rollout
+        current_state->get_estimated_score_points(score_points, players_points, team_points);
     for (int i = 0; i < 4; ++i) {
         uct_rewards[i] = options.get_score_points_constant(uct_player) * score_points[i] + static_cast<double>((options.use_team_points(uct_player) ? team_points[current_state->get_players_team(i)] : players_points[i])) / options.get_playing_points_constant(uct_player);
-        if (options.use_uct_debug()) {
-            cout << "player " << i << "'s score points: " << score_points[i] << endl;
-            cout << "player " << i << "'s uct rewards: " << uct_rewards[i] << endl;
+        if (log_enabled(LOG_UCT, LOG_DEBUG)) {
+            log_stream() << "player " << i << "'s score points: " << score_points[i] << '\n';
+            log_stream() << "player " << i << "'s uct rewards: " << uct_rewards[i] << '\n';
         }
     }
-    if (options.use_uct_debug())
-        cout << endl;
+    if (log_enabled(LOG_UCT, LOG_DEBUG))
+        log_stream() << '\n';
     while (current_node != 0) { // go back to root (whose parent is 0)
         ++(current_node->num_visits);
         ///++(current_node->num_visits2);
@@ -500,20 +646,58 @@ void Uct::propagate_values(Node *current_node, BeliefGameState *current_state) {
     }
 }
 
+int Uct::get_node_player_to_move(const BeliefGameState &state) const {
+    return state.game_finished() ? -2 : state.get_player_to_move();
+}
+
+int Uct::get_successor_player_to_move(const BeliefGameState &state, const Move &move) const {
+    // like the rollout when following or adding the successor
+    BeliefGameState successor_state(state);
+    successor_state.set_move(successor_state.get_player_to_move(), move);
+    vector<Move> legal_moves;
+    apply_forced_moves(&successor_state, legal_moves);
+    return get_node_player_to_move(successor_state);
+}
+
+bool Uct::has_known_number_of_options(const BeliefGameState &state) const {
+    if (options.get_uct_version(uct_player) == 0) // all rollouts of a tree use the same card assignment
+        return true;
+    // the options of the uct player only depend on its own cards, and in the last trick, every player has exactly one card
+    return state.get_player_to_move() == uct_player || state.get_number_of_completed_tricks() == 11;
+}
+
+void Uct::apply_forced_moves(BeliefGameState *state, vector<Move> &legal_moves) const {
+    while (true) {
+        legal_moves.clear();
+        if (state->game_finished() || !has_known_number_of_options(*state))
+            return;
+        state->get_legal_moves(legal_moves);
+        merge_equivalent_moves(*state, legal_moves);
+        if (legal_moves.size() > 1)
+            return;
+        if (log_enabled(LOG_UCT, LOG_DEBUG))
+            log_stream() << "applying forced move " << legal_moves[0] << '\n';
+        state->set_move(state->get_player_to_move(), legal_moves[0]);
+    }
+}
+
 void Uct::rollout(BeliefGameState *current_state, int number_of_rollout) {
     assert(number_of_rollout == root->num_visits);
-    if (options.use_uct_debug() && move_number == 11)
-        cout << "\nstarting one rollout" << endl;
+    if (log_enabled(LOG_UCT, LOG_DEBUG) && move_number == 11)
+        log_stream() << "\nstarting one rollout\n";
     Node *current_node = root;
     ///BeliefGameState state2(*current_state);
     ///assert(*current_state == state2);
     bool added_new_node = false; // this will be set to true as soon as the first node needs to be inserted. from then on, a MC simulation will be carried out either with adding further nodes to the tree or not, depending on the chosen options
+    bool left_tree = false; // true if a node should have been added but the tree reached the node budget. from then on, current_node is the last node of the tree on the path of the rollout rather than the node of current_state
+    int last_trick_to_simulate = 12; // once a node was added, the MC simulation stops after this trick if rollouts are truncated
+    vector<Move> legal_moves; // of current_state, empty if they still need to be computed
     while (true) {
-        if (options.use_uct_debug()/* && !added_new_node*/) {
+        if (log_enabled(LOG_UCT, LOG_DEBUG)/* && !added_new_node*/) {
             // !added_new_node to avoid to print all newly created nodes as soon as a node was added (if the corresponding option to add all nodes is set)
             if (current_node != root)
-                cout << endl;
-            cout << "current node:" << endl;
+                log_stream() << '\n';
+            log_stream() << "current node:\n";
             current_node->dump();
         }
         ///check_node_consistency(current_node);
@@ -522,17 +706,27 @@ void Uct::rollout(BeliefGameState *current_state, int number_of_rollout) {
         // test if a terminal node or a terminal state (which is not the same if nodes are not added to tree as soon as one was added but the simulation is carried on) was reached
         if (current_node->player_to_move == -2 || current_state->game_finished()) {
             ///assert(current_node->player_to_move2 == -2);
-            if (options.use_uct_debug())
-                cout << "found an end of game leaf node or a terminal state was reached (when simulating and not adding nodes)" << endl;
+            if (log_enabled(LOG_UCT, LOG_DEBUG))
+                log_stream() << "found an end of game leaf node or a terminal state was reached (when simulating and not adding nodes)\n";
+            propagate_values(current_node, current_state);
+            return;
+        }
+        if (added_new_node && current_state->get_number_of_completed_tricks() >= last_trick_to_simulate
+            && current_state->score_points_can_be_estimated()) {
+            if (log_enabled(LOG_UCT, LOG_DEBUG))
+                log_stream() << "truncating the rollout\n";
             propagate_values(current_node, current_state);
             return;
         }
 
         // check if there are unvisited successors or if a node was already added and thus just choose an arbitrary move
-        vector<Move> legal_moves;
-        current_state->get_legal_moves(legal_moves);
-        if (options.use_uct_debug())
-            cout << "legal moves for current_state: " << legal_moves << endl;
+        int successor_to_move_index[NUM_MOVE_IDS]; // uct version 1 only: maps each successor of current_node to the index of its move in legal_moves (-1 if the move is not legal for the current card assignment)
+        if (legal_moves.empty()) { // otherwise, apply_forced_moves() already computed them
+            current_state->get_legal_moves(legal_moves);
+            merge_equivalent_moves(*current_state, legal_moves); // equivalent cards share the tree and its statistics
+        }
+        if (log_enabled(LOG_UCT, LOG_DEBUG))
+            log_stream() << "legal moves for current_state: " << legal_moves << '\n';
         int chosen_move = -1;
         if (!added_new_node) { // a leaf node was not reached yet, thus check if there are (consistent in the case of uct version 1) successors of the current_node which have not been visited yet and choose one
             assert(current_node->player_to_move == current_state->get_player_to_move());
@@ -540,22 +734,25 @@ void Uct::rollout(BeliefGameState *current_state, int number_of_rollout) {
             vector<size_t> not_contained_moves_indices; // stores the indices of all moves from legal_moves which are not already a successor of the current node
             ///vector<size_t> not_contained_moves_indices2;
             if (options.get_uct_version(uct_player) == 1) {
-                // iterate over legal moves and check if they already exists as a successor in the tree, i.e. find all moves which are not in the tree yet if therer exist some. contrary to the case of uct version 0, do not add any other moves as uninitialized successors because if the algorithm reaches the same node in another rollout again, it will have a different card assignment
+                // look up all legal moves in the successors of the current node, i.e. find all moves which are not in the tree yet if therer exist some. contrary to the case of uct version 0, do not add any other moves as uninitialized successors because if the algorithm reaches the same node in another rollout again, it will have a different card assignment
+                // NOTE: in some rare cases, it could happen that when a player announced black at a node and this node was reached again later with a different card assignment, then a different player was the player to play next, because depending on the teams, the team mate of the announcing player was not allowed to do anymore announcings. Successors are looked up by the merged id of their move, which does not distinguish the team of an announcement (it is hidden information for the other players), thus the successor of an announcement additionally needs to have the player to move of a copy of the current state after the announcement.
+                for (size_t i = 0; i < current_node->successors.size(); ++i)
+                    successor_to_move_index[i] = -1;
                 for (size_t i = 0; i < legal_moves.size(); ++i) {
-                    bool move_contained = false;
-                    for (size_t j = 0; j < current_node->moves.size(); ++j) {
-                        if (legal_moves[i] == current_node->moves[j]) {
-                            // NOTE: in some rare cases, it could happen that when a player announced black at a node and this node was reached again later with a different card assignment, then a different player was the player to play next, because depending on the teams, the team mate of the announcing player was not allowed to do anymore announcings. To fix this, the following check on equal player to move in both the current node and the current state has been introduced.
-                            BeliefGameState state_copy(*current_state);
-                            state_copy.set_move(state_copy.get_player_to_move(), legal_moves[i]);
-                            if (state_copy.get_player_to_move() == current_node->successors[j]->player_to_move) {
-                                move_contained = true;
-                                break;
-                            }
-                        }
-                    }
-                    if (!move_contained)
+                    int successor_index = current_node->get_successor_index(legal_moves[i]);
+                    if (successor_index != -1 && legal_moves[i].is_announcement_move())
+                        successor_index = current_node->get_successor_index(
+                            legal_moves[i], get_successor_player_to_move(*current_state, legal_moves[i]));
+                    if (successor_index == -1)
                         not_contained_moves_indices.push_back(i);
+                    else
+                        successor_to_move_index[successor_index] = i;
+                }
+                if (options.use_availability_counts(uct_player)) {
+                    for (size_t i = 0; i < current_node->successors.size(); ++i) {
+                        if (successor_to_move_index[i] != -1)
+                            ++(current_node->successors[i]->num_available);
+                    }
                 }
             } else {
                 /**if (current_node->successors2.empty()) { // node has not been expanded: insert ALL successors, because if at any time, the algorithm will encounter this same node again and find an unvisited leaf, it will still have the same card assignment (because after each simulation, a new tree is constructed)
@@ -632,7 +829,7 @@ void Uct::rollout(BeliefGameState *current_state, int number_of_rollout) {
             }
             else // TODO: improve the simulation. for now: no announcing, no solo play
                 chosen_move = 0;
-            if (options.get_simulation_option(uct_player) == 0) {
+            if (options.get_simulation_option(uct_player) == 0 && !left_tree) {
                 if (options.get_uct_version(uct_player) == 0) {
                     /**if (current_node->successors2.empty()) { // node has not been expanded: insert ALL successors, because if at any time, the algorithm will encounter this same node again and find an unvisited leaf, it will still have the same card assignment (because after each simulation, a new tree is constructed)
                         //if (options.use_uct_debug())
@@ -658,37 +855,52 @@ void Uct::rollout(BeliefGameState *current_state, int number_of_rollout) {
         ///assert(*current_state == state2);
         if (chosen_move != -1) { // already chose a node because there were either some unvisited successors left and no node was added so far or because a leaf node was reached and from then on it suffices to choose an arbitrary move (applying the uct formula would not work because no uct rewards are known for the successors of the current node)
             assert(chosen_move >= 0);
-            if (options.use_uct_debug()) {
+            if (log_enabled(LOG_UCT, LOG_DEBUG)) {
                 if (!added_new_node)
-                    cout << "found unvisited successor at index " << chosen_move << endl;
+                    log_stream() << "found unvisited successor at index " << chosen_move << '\n';
                 else
-                    cout << "choosing index " << chosen_move << endl;
+                    log_stream() << "choosing index " << chosen_move << '\n';
             }
             ///if (!added_new_node)
                 ///current_state->set_uct_output(true);
-            current_state->set_move(current_state->get_player_to_move(), legal_moves[chosen_move]);
+            Move move = legal_moves[chosen_move];
+            current_state->set_move(current_state->get_player_to_move(), move);
+            if (!left_tree && (!added_new_node || options.get_simulation_option(uct_player) == 0)) // a node will be added (unless the node budget is reached)
+                apply_forced_moves(current_state, legal_moves);
+            else
+                legal_moves.clear();
             ///state2.set_move(state2.get_player_to_move(), legal_moves[chosen_move]);
             ///current_state->set_uct_output(false);
             ///assert(*current_state == state2);
-            if (!added_new_node || options.get_simulation_option(uct_player) == 0) { // no node was added yet or the chosen option requires to add all nodes encountered during a rollout
+            if (!left_tree && (!added_new_node || options.get_simulation_option(uct_player) == 0) // no node was added yet or the chosen option requires to add all nodes encountered during a rollout
+                && node_budget_reached() && current_node != root) { // the successors of the root are always added so that every move at the root gets evaluated
+                // do not add any further nodes, but simulate the rest of the game like after adding a node, thus only refining the statistics of the nodes in the tree
+                if (log_enabled(LOG_UCT, LOG_DEBUG))
+                    log_stream() << "node budget reached, leaving the tree\n";
+                if (!added_new_node && options.get_rollout_truncation(uct_player) > 0)
+                    last_trick_to_simulate = current_state->get_number_of_completed_tricks()
+                        + options.get_rollout_truncation(uct_player);
+                added_new_node = true;
+                left_tree = true;
+            }
+            if (!left_tree && (!added_new_node || options.get_simulation_option(uct_player) == 0)) { // no node was added yet or the chosen option requires to add all nodes encountered during a rollout
                 ++nodes_counter;
-                Node *next_node = new Node(nodes_counter, current_state->get_player_to_move());
+                Node *next_node = new Node(nodes_counter, get_node_player_to_move(*current_state));
                 next_node->parent = current_node;
+                next_node->num_available = 1; // its move is legal now
                 ///next_node->parent2 = current_node;
                 if (options.get_uct_version(uct_player) == 1) {
-                    current_node->moves.push_back(legal_moves[chosen_move]);
-                    current_node->successors.push_back(next_node);
+                    current_node->add_successor(move, next_node);
                 } else {
                     ///assert(current_node->moves2[chosen_move] == legal_moves[chosen_move]);
                     ///current_node->successors2[chosen_move] = next_node;
-                    assert(current_node->moves[chosen_move] == legal_moves[chosen_move]);
+                    assert(current_node->moves[chosen_move] == move);
                     current_node->successors[chosen_move] = next_node;
                 }
                 current_node = next_node;
-                if (current_state->game_finished()) {
-                    current_node->player_to_move = -2;
-                    ///current_node->player_to_move2 = -2;
-                }
+                if (!added_new_node && options.get_rollout_truncation(uct_player) > 0)
+                    last_trick_to_simulate = current_state->get_number_of_completed_tricks()
+                        + options.get_rollout_truncation(uct_player);
                 added_new_node = true;
             }
         } else { // all successors of the current node have been visited at least once and thus need to follow the one with the highest value according the uct formula
@@ -696,14 +908,23 @@ void Uct::rollout(BeliefGameState *current_state, int number_of_rollout) {
                 //cout << legal_moves << endl;
             unsigned int move_index[1] = { 0 };
             ///unsigned int max_index2[1] = { 0 };
-            unsigned int max_index = calculate_best_move_index(current_node, number_of_rollout, /**max_index2, */
-                                                               true, current_state, move_index);
+            unsigned int max_index;
+            if (current_node == root && options.use_sequential_halving(uct_player)) {
+                max_index = select_root_successor(number_of_rollout);
+                if (options.get_uct_version(uct_player) == 1) {
+                    assert(successor_to_move_index[max_index] != -1);
+                    move_index[0] = static_cast<unsigned int>(successor_to_move_index[max_index]);
+                }
+            } else {
+                max_index = calculate_best_move_index(current_node, number_of_rollout, /**max_index2, */
+                                                      true, successor_to_move_index, move_index);
+            }
             // update current_state and current_node according to the chosen move
-            if (options.use_uct_debug())
-                cout << "applying uct formula, choosing index " << max_index << endl;
+            if (log_enabled(LOG_UCT, LOG_DEBUG))
+                log_stream() << "applying uct formula, choosing index " << max_index << '\n';
             if (options.get_uct_version(uct_player) == 1) {
-                if (options.use_uct_debug())
-                    cout << "move index is " << move_index[0] << endl;
+                if (log_enabled(LOG_UCT, LOG_DEBUG))
+                    log_stream() << "move index is " << move_index[0] << '\n';
                 current_state->set_move(current_state->get_player_to_move(), legal_moves[move_index[0]]);
             } else {
                 /**if (!added_new_node)
@@ -719,6 +940,7 @@ void Uct::rollout(BeliefGameState *current_state, int number_of_rollout) {
                 ///current_state->set_uct_output(false);
                 ///assert(*current_state == state2);
             }
+            apply_forced_moves(current_state, legal_moves); // like when the successor was added
             ///assert(current_node->successors[max_index] == current_node->successors2[max_index2[0]]);
             current_node = current_node->successors[max_index];
         }
@@ -751,10 +973,10 @@ void Uct::dot(int number_of_simulation) const {
     if (options.get_uct_version(uct_player) == 0)
         sstm << "_(" << number_of_simulation << ")";
     sstm << ".dot";
-    const char *file_name = sstm.str().c_str();
+    string file_name = sstm.str();
     int counter = 0;
     ofstream myfile;
-    myfile.open(file_name);
+    myfile.open(file_name.c_str());
     myfile << "digraph uct_tree {\n";
     dot_rec(root, counter, myfile);
     myfile << "}";
@@ -765,40 +987,69 @@ void Uct::_dump(Node *node) const {
     if (node == 0) { // root == 0
         return;
     }
-    cout << "node->player_to_move = " << node->player_to_move << endl;
-    cout << "accumulated rewards: ";
+    log_stream() << "node->player_to_move = " << node->player_to_move << '\n';
+    log_stream() << "accumulated rewards: ";
     for (int i = 0; i < 4; ++i) {
-        cout << i << ": " << node->accumulated_reward[i];
+        log_stream() << i << ": " << node->accumulated_reward[i];
         if (i != 3)
-            cout << ", ";
+            log_stream() << ", ";
     }
-    cout << endl;
+    log_stream() << '\n';
     if (node->successors.empty()) {
-        cout << "leaf node!" << endl;
+        log_stream() << "leaf node!\n";
     } else {
         for (size_t i = 0; i < node->successors.size(); ++i) {
             if (node->successors[i] == 0)
-                cout << "no child for index " << i << endl;
+                log_stream() << "no child for index " << i << '\n';
             else {
-                cout << "recursive call for child with index " << i << endl;
+                log_stream() << "recursive call for child with index " << i << '\n';
                 _dump(node->successors[i]);
-                cout << "back from recursive call (for successors[" << i << "]) to node with player_to_move = " << node->player_to_move << endl;
+                log_stream() << "back from recursive call (for successors[" << i << "]) to node with player_to_move = " << node->player_to_move << '\n';
             }
         }
     }
 }
 
 void Uct::dump() const {
-    cout << "Search tree:" << endl;
+    log_stream() << "Search tree:\n";
     _dump(root);
-    cout << "end of search tree" << endl;
+    log_stream() << "end of search tree\n";
+}
+
+unsigned int Uct::get_legal_move_index(const Move &move) const {
+    // the successors of the root only contain one move of every class of equivalent moves (see rollout()), which may be the other copy of a card than the one in legal_moves_at_root
+    for (size_t i = 0; i < legal_moves_at_root.size(); ++i) {
+        if (legal_moves_at_root[i].get_merged_id() == move.get_merged_id())
+            return static_cast<unsigned int>(i);
+    }
+    assert(false);
+    return 0;
+}
+
+void Uct::get_root_statistics(vector<Move> &moves, vector<int> &visits, vector<double> &rewards) const {
+    visits.clear();
+    rewards.clear();
+    if (options.get_uct_version(uct_player) == 1) {
+        moves = root->moves;
+        for (size_t i = 0; i < root->successors.size(); ++i) {
+            visits.push_back(root->successors[i]->num_visits);
+            rewards.push_back(root->successors[i]->accumulated_reward[uct_player] / root->successors[i]->num_visits);
+        }
+    } else {
+        moves = legal_moves_at_root;
+        merge_equivalent_moves(*belief_game_states[0], moves); // the successors of the root in every simulation
+        for (size_t i = 0; i < average_rewards.size(); ++i) {
+            visits.push_back(root_visits[i]);
+            rewards.push_back(average_rewards[i] / get_sum_of_tree_weights());
+        }
+    }
 }
 
 unsigned int Uct::get_best_move() const {
     if (options.get_uct_version(uct_player) == 1) {
         if (options.use_create_graph())
             dot();
-        return calculate_best_move_index(root, options.get_number_of_rollouts(uct_player));
+        return get_legal_move_index(root->moves[calculate_best_move_index(root, options.get_number_of_rollouts(uct_player))]);
     } else {
         int max_index = -1;
         double best_avg_reward;
@@ -806,38 +1057,40 @@ unsigned int Uct::get_best_move() const {
         int highest_count_so_far;
         bool only_negative_rewards = true;
         for (size_t i = 0; i < average_rewards.size(); ++i) {
-            double current_avg_reward = average_rewards[i] / options.get_number_of_simulations(uct_player);
+            double current_avg_reward = average_rewards[i] / get_sum_of_tree_weights();
             if (current_avg_reward > 0)
                 only_negative_rewards = false;
-            if (options.use_uct_verbose())
-                cout << "index " << i << " yields an average reward of " << current_avg_reward << endl;
+            if (log_enabled(LOG_UCT, LOG_VERBOSE))
+                log_stream() << "index " << i << " yields an average reward of " << current_avg_reward << '\n';
             if (max_index == -1 || current_avg_reward > best_avg_reward) {
                 best_avg_reward = current_avg_reward;
                 max_index = i;
             }
-            if (options.use_uct_verbose())
-                cout << "index " << i << " was chosen " << move_indices_count[i] << " times" << endl;
+            if (log_enabled(LOG_UCT, LOG_VERBOSE))
+                log_stream() << "index " << i << " was chosen " << move_indices_count[i] << " times\n";
             if (most_often_chosen_index == -1 || move_indices_count[i] > highest_count_so_far) {
                 highest_count_so_far = move_indices_count[i];
                 most_often_chosen_index = i;
             }
         }
         assert(max_index >= 0);
-        if (options.use_uct_verbose()) {
-            cout << "max index according to summed average calculation: " << max_index << endl;
-            cout << "most often chosen index: " << most_often_chosen_index << endl;
+        if (log_enabled(LOG_UCT, LOG_VERBOSE)) {
+            log_stream() << "max index according to summed average calculation: " << max_index << '\n';
+            log_stream() << "most often chosen index: " << most_often_chosen_index << '\n';
             if (max_index != most_often_chosen_index)
-                cout << "MAX INDEX != MOST OFTEN CHOSEN INDEX" << endl;
+                log_stream() << "MAX INDEX != MOST OFTEN CHOSEN INDEX\n";
         }
         if (options.get_announcement_option(uct_player) == 2 && only_negative_rewards) {
             vector<Move> legal_moves;
             belief_game_states[0]->get_legal_moves(legal_moves);
             if (legal_moves[0].is_announcement_move()) {
-                if (options.use_uct_verbose())
-                    cout << "all successors yield a negative reward, forbid announcing" << endl;
+                if (log_enabled(LOG_UCT, LOG_VERBOSE))
+                    log_stream() << "all successors yield a negative reward, forbid announcing\n";
                 return 0;
             }
         }
-        return static_cast<unsigned int>(max_index);
+        vector<Move> root_moves(legal_moves_at_root);
+        merge_equivalent_moves(*belief_game_states[0], root_moves); // the successors of the root in every simulation
+        return get_legal_move_index(root_moves[max_index]);
     }
 }
@@ -34,10 +34,15 @@ Version 0:
 This version uses "simulations" and "rollouts", i.e. a simulation consists of several rollouts. When the instance is created, a card assignment is computed and fixed for each simulation. All rollouts performed during one simulation then use the same card assignment to build a game tree. Thus when expanding a node, all successors are added to it (without expanding them) and thus successors are always in the order of the legal moves of the node. This is important when it comes to the part where a MC simulation is used or not (depending on the options). When reaching a leaf node, the algorithm continues to select random moves or selects a move based on a heuristic. Depending on chosen options, all nodes enounctered starting from a leaf node are added or only the first one. In both cases, when a terminal state is reached, the game values are computed, transfered into uct rewards (depending on several options, see below) and propagated back to the root. During back-propagation, all nodes visited on the path from the root to the last added node (i.e. the node corresponding to the terminal state or the node where the MC simulation was started) get updated (i.e. uct rewards get added, number of visits counter gets increased). The resulting average rewards of the root-node for each possible successor are summed up after each simulation, and if get_best_move() is called, the move with the highest (normalized by the number of simulations which would not be necessary, but which better reflects the actual reward value for each successor) average reward is returned. For comparison reasons, there is a counter for each possible move counting how many simulations would have chosen it if only this simulation was taken into account. Some tests have shown that the summed average approach is better than the "most often chosen move" approach.
 
 Version 1:
-This version is solely based on rollouts: for each rollout, a new card assignment is being used. As a consequence, nodes in the game tree from previous rollouts may become inconsistent with the current card assignment, because obviously at a player's node where he has to play  a card, the possible successors will differ from rollout to rollout with different card assignments for this player. Thus this version needs to deal nodes as information sets rather then a single state. Luckily, this can be simplified back to "node equals state" approach from version 0 for one rollout with a fixed card assignment by just ignoring all successors of a node which are not consistent with the current game world. Still there is a difference: when expanding a node, one can only add the successor that is also immediately chosen and not all of them, because the next time the algorithm encounters the same node again, the other successors that would have been added could be inconsistent again. Consequently, successors are NOT ordered like the legal moves for the corresponding state and thus when encountering a node, the algorithm first need to match the existing successors to the current legal moves. For the rest of the algorithm, this version is similar to version 0: a rollout either adds exactly one new node to the tree and then performs a simulation or it adds all nodes encountered during the simulation, depending on the chosen options. Then the game values are computed and propagated back along the visited path. There is a pitfall that needs to be taken care off: resulting from different card assignments, it can happen that in one rollout, applying a move to a state results in a different state in the means of a different player has to move next than in another rollout (e.g. when a player announces black and his teammate is already known, then this team mate cannot do any further announcements, thus this player is "jumped" in the next player is asked for an announcement. In the next rollout, this teammate may be a different player depending on the card assignment). When get_best_move() is called, the move (successor at the root node) with the best average reward is returned (no extra calculations needed).
+This version is solely based on rollouts: for each rollout, a new card assignment is being used. As a consequence, nodes in the game tree from previous rollouts may become inconsistent with the current card assignment, because obviously at a player's node where he has to play  a card, the possible successors will differ from rollout to rollout with different card assignments for this player. Thus this version needs to deal nodes as information sets rather then a single state. Luckily, this can be simplified back to "node equals state" approach from version 0 for one rollout with a fixed card assignment by just ignoring all successors of a node which are not consistent with the current game world. Still there is a difference: when expanding a node, one can only add the successor that is also immediately chosen and not all of them, because the next time the algorithm encounters the same node again, the other successors that would have been added could be inconsistent again. Consequently, successors are NOT ordered like the legal moves for the corresponding state and thus when encountering a node, the algorithm first need to match the existing successors to the current legal moves. For the rest of the algorithm, this version is similar to version 0: a rollout either adds exactly one new node to the tree and then performs a simulation or it adds all nodes encountered during the simulation, depending on the chosen options. Then the game values are computed and propagated back along the visited path. There is a pitfall that needs to be taken care off: resulting from different card assignments, it can happen that in one rollout, applying a move to a state results in a different state in the means of a different player has to move next than in another rollout (e.g. when a player announces black and his teammate is already known, then this team mate cannot do any further announcements, thus this player is "jumped" in the next player is asked for an announcement. In the next rollout, this teammate may be a different player depending on the card assignment). Successors are looked up by the merged id of their move (see Move::get_merged_id()), which makes matching the legal moves of a state against the successors of a node linear in the number of legal moves. The only hidden information that influences which player has to move next is the team of an announcing player, which the merged id deliberately ignores: otherwise, a node of another player would get one successor per team that player has in the card assignments, splitting the information set on hidden information. Instead, a node may have several successors for the same announcement, and the successor matching an announcement is the one whose player to move is the one of a copy of the state after the announcement. When get_best_move() is called, the move (successor at the root node) with the best average reward is returned (no extra calculations needed).
 
 Implementation details common for both versions:
 The result of a game gets transfered into "uct rewards" by multiplying the score points of a player by a constant (set via program options) and then adding up either the player's or the player's team points made during the game, divided by another constant (also set via options). Also the exploration constant for the uct formula can be configured via options, as can be number of simulations and rollouts.
+Every card exists twice and playing one or the other copy of a card makes no difference, thus whenever a player holds both copies of a legal card, only the first one is considered as a move (see merge_duplicate_cards()) and successors are looked up by Move::get_merged_id(). This way, both copies share their subtree and statistics, which reduces the branching factor. More generally, two cards of a player are equivalent if they have the same value and every card ranking between them has already been played or is held by the same player (see BeliefGameState::merge_equivalent_cards()), and again only the first card of every such class is considered. As a consequence, the successors of the root do not correspond one-to-one to the legal moves of the uct player, and get_best_move() translates the best successor back into the index of the (first) equivalent legal move. There is no option to turn merging off: it changes the trees, the random choices and thus the decisions of every configuration, i.e. a session with a fixed seed does not replay the games of versions without merging.
+At the root, the uct formula spends many rollouts on confirming that clearly bad moves are bad, although only the best move matters there. Optionally, the root therefore uses sequential halving instead (see select_root_successor()): once every successor of the root has been visited, the remaining rollouts are split into rounds, each of which spreads its rollouts evenly over the remaining candidates and then discards the worse half of them, until one candidate is left, which is the move chosen by get_best_move() (for version 0, every simulation does so in its own tree and get_best_move() still sums up the average rewards of all simulations). All other nodes still use the uct formula.
+For version 1, the uct formula normally uses the number of visits of a node for the exploration term of all of its successors. As the card assignment changes from rollout to rollout, a successor of a node of another player may only be legal in some of the visits of that node, and the exploration term of rarely legal successors keeps growing while they cannot be chosen. Optionally, every node therefore counts how often it was available, i.e. how often its move was legal when its parent was visited, and the uct formula uses this count instead of the visits of the parent (information set UCT with availability counts). The legal successors are known from matching the legal moves against the successors anyway, thus counting is only one increment per legal successor.
+Many moves are forced, e.g. every card of the last trick, a card if the player holds only one card (or one class of equivalent cards) of the trick suit or the answer to the question for a solo of a player with a reservation who does not have both queens of clubs (and thus cannot have a marriage). A node for such a move would only pass its single successor's statistics on, thus forced moves are applied right after the move leading to a node (see apply_forced_moves()) and every node is a state where the player to move has a choice (or a terminal state). For version 1, the options of the other players depend on the card assignment and a node needs to be the same for all of them, thus only moves of the uct player and the cards of the last trick are considered as forced there.
+In the last tricks, often only few card assignments are consistent with the game so far, and sampling them evaluates the same ones over and over again. Optionally, if there are at most a given number of them, all of them are computed instead (see CardAssignment::enumerate_card_assignments()). Version 0 then searches every card assignment once in its own tree instead of the simulations, and the average rewards of the successors of the root are weighted by the probability of the card assignment of the tree, i.e. get_best_move() chooses the move with the best expected reward without any sampling error of the card assignments. Version 1 cycles through a random order of the card assignments in which every card assignment occurs as often as its weight, thus every cycle uses every card assignment exactly in proportion to its probability. This also spares the random assignment of the cards in every rollout.
 As average rewards may be floating point numbers, the class uses double to store values. Some imprecisions have been encountered by doing the same calculations in different ways, i.e. once some intermediate results are stored, once not, this may result in "different" numbers (starting with maybe the 10th position after decimal point). Thus when comparing doubles, a difference smaller than some epsilon (0000001) is allowed and still the numbers are considered being the sames, making both methods of calculations equal (better reproducability).
 */
 
@@ -50,7 +55,9 @@ struct Node {
     Node *parent;
     std::vector<Node *> successors;
     std::vector<Move> moves;
+    signed char *successor_index; // version 1 only: maps the merged id of a move to the index of the first successor reached by it (-1 if there is none). only allocated once a second successor is added
     int num_visits;
+    int num_available; // version 1 only: the number of rollouts in which the move leading to this node was legal when its parent was visited (see availability counts)
     double accumulated_reward[4];
     /**int player_to_move2;
     Node *parent2;
@@ -60,6 +67,9 @@ struct Node {
     double accumulated_reward2[4];*/
     Node(const int id, int player_to_move);
     ~Node();
+    int get_successor_index(const Move &move) const; // the first successor reached by move, -1 if there is none
+    int get_successor_index(const Move &move, int successor_player_to_move) const; // the successor reached by move with the given player to move, -1 if there is none
+    void add_successor(const Move &move, Node *successor);
     void dump() const;
 };
 
@@ -75,13 +85,32 @@ private:
     mutable RandomNumberGenerator rng;
     std::vector<BeliefGameState *> belief_game_states; // TODO: just for debugging purposes to compare legal moves!
     std::vector<double> average_rewards;
+    std::vector<int> root_visits; // version 0 only: the visits of every successor of the root, summed over all simulations
     std::vector<int> move_indices_count; // only for comparison reasons, not actually used
     int move_number; // for creating the dot files in a numbered way
-    int nodes_counter;
+    int nodes_counter; // of the current tree
+    int number_of_nodes; // of the largest tree (version 0 builds one tree per simulation)
+    size_t tree_bytes; // memory used by the largest tree
+    std::vector<int> root_candidates; // sequential halving only: the successors of the root which have not been discarded yet (empty before the first round)
+    int round_end; // sequential halving only: the number of the rollout which starts the next round
+    std::vector<Move> legal_moves_at_root;
+    bool enumerates_card_assignments; // true if all card assignments are used instead of sampled ones (see above)
 
     unsigned int calculate_best_move_index(Node *node, int number_of_rollout, /*unsigned int *max_index2,*/
-                                           bool with_exploratin_term = false, const BeliefGameState *state = 0,
+                                           bool with_exploratin_term = false, const int *successor_to_move_index = 0,
                                            unsigned int *move_index = 0) const;
+    unsigned int get_legal_move_index(const Move &move) const; // index of the legal move at the root equivalent to move
+    bool is_root_candidate(Node *node, int index) const;
+    void start_halving_round(int number_of_rollout);
+    unsigned int select_root_successor(int number_of_rollout); // sequential halving
+    int get_node_player_to_move(const BeliefGameState &state) const; // the player to move of the node of state, -2 if the game is finished
+    int get_successor_player_to_move(const BeliefGameState &state, const Move &move) const; // the player to move of the successor of the node of state reached by move (version 1 only: differs between card assignments for announcements, see above)
+    bool has_known_number_of_options(const BeliefGameState &state) const; // true if the player to move has the same number of options for every card assignment of the tree
+    /* applies moves as long as the player to move has only one option which is the same for every card assignment of the tree (see above). leaves the legal moves of the resulting state in legal_moves if they have been computed and empties it otherwise */
+    void apply_forced_moves(BeliefGameState *state, std::vector<Move> &legal_moves) const;
+    double get_sum_of_tree_weights() const; // version 0: the average rewards at the root are summed up over the trees with these weights
+    bool node_budget_reached() const;
+    void update_tree_size(); // called when the current tree is complete
     void propagate_values(Node *current_node, BeliefGameState *current_state);
     void rollout(BeliefGameState *current_state, int number_of_rollout);
     void dot_rec(Node *node, int &counter, std::ofstream &myfile) const;
@@ -91,7 +120,15 @@ public:
     ~Uct();
     void dot(int number_of_simulation = -1) const; // creates a file called tree.dot which can be converted into a graph diagram using the dot tool
     void dump() const;
-    unsigned int get_best_move() const;
+    unsigned int get_best_move() const; // index into the legal moves of the state the instance was created with
+    /* the moves of the successors of the root (one per class of equivalent moves, see above), the number of times each was visited and its average reward for the uct player (for version 0 summed over all simulations and averaged over the simulations). added for the analysis server */
+    void get_root_statistics(std::vector<Move> &moves, std::vector<int> &visits, std::vector<double> &rewards) const;
+    int get_number_of_nodes() const { // added for benchmark
+        return number_of_nodes;
+    }
+    size_t get_tree_bytes() const { // added for benchmark
+        return tree_bytes;
+    }
     const std::vector<BeliefGameState *> &get_belief_game_states() const { // see above (belief_game_states)
         return belief_game_states;
     }
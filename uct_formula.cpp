@@ -0,0 +1,60 @@
+/*
+  doko is a C++ doppelkopf program with an integrated UCT player.
+  Copyright (c) 2011-2016 Silvan Sievers
+  For questions, please write to: silvan.sievers@unibas.ch
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "uct_formula.h"
+
+#include <cassert>
+#include <cmath>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+double compute_uct_value_reference(int visits, double accumulated_reward, double log_trials, double exploration_constant) {
+    double value = accumulated_reward / visits;
+    value += exploration_constant * sqrt(log_trials / visits);
+    return value;
+}
+
+int select_uct_successor(UctSuccessors &successors, double exploration_constant, double epsilon) {
+    int number_of_successors = successors.number_of_successors;
+    assert(number_of_successors >= 0 && number_of_successors <= MAX_NUMBER_OF_SUCCESSORS);
+    int i = 0;
+#ifdef __SSE2__
+    // the same operations as compute_uct_value_reference() for two successors at once (sqrt and division are exact, thus so are the values)
+    const __m128d constant = _mm_set1_pd(exploration_constant);
+    for (; i + 2 <= number_of_successors; i += 2) {
+        __m128d visits = _mm_cvtepi32_pd(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(successors.visits + i)));
+        __m128d average_rewards = _mm_div_pd(_mm_loadu_pd(successors.accumulated_rewards + i), visits);
+        __m128d exploration_terms = _mm_mul_pd(constant, _mm_sqrt_pd(_mm_div_pd(_mm_loadu_pd(successors.log_trials + i), visits)));
+        _mm_storeu_pd(successors.values + i, _mm_add_pd(average_rewards, exploration_terms));
+    }
+#endif
+    for (; i < number_of_successors; ++i)
+        successors.values[i] = compute_uct_value_reference(successors.visits[i], successors.accumulated_rewards[i],
+                                                           successors.log_trials[i], exploration_constant);
+
+    int best_index = -1;
+    for (i = 0; i < number_of_successors; ++i) {
+        if (successors.selectable[i] && (best_index == -1 || successors.values[i] - successors.values[best_index] > epsilon))
+            best_index = i;
+    }
+    return best_index;
+}
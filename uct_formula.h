@@ -0,0 +1,48 @@
+/*
+  doko is a C++ doppelkopf program with an integrated UCT player.
+  Copyright (c) 2011-2016 Silvan Sievers
+  For questions, please write to: silvan.sievers@unibas.ch
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef UCT_FORMULA_H
+#define UCT_FORMULA_H
+
+/**
+The uct formula evaluated for all successors of a node at once: Uct gathers the statistics of the successors into the contiguous arrays of UctSuccessors, and select_uct_successor() computes all uct values with SIMD instructions (if available, two values per instruction with SSE2) and returns the index of the best selectable successor. The value of successor i is
+    accumulated_rewards[i] / visits[i] + exploration_constant * sqrt(log_trials[i] / visits[i])
+where log_trials[i] is the logarithm of the number of trials of the exploration term (the visits of the node, the current number of rollout or the availability count of the successor, see the options of the uct formula). Unless availability counts are used, the logarithm is the same for all successors and thus only computed once per node. The operations are the same as the ones of the scalar formula in the same order, thus the values are exactly the same (see compute_uct_value_reference()).
+
+The best successor is the first selectable one whose value exceeds the value of the best selectable successor before it by more than epsilon, i.e. ties (up to epsilon, see Uct) are broken in favor of the lower index.
+*/
+
+const int MAX_NUMBER_OF_SUCCESSORS = 80; // at least NUM_MOVE_IDS (see move.h), rounded up to a multiple of the SIMD width
+
+struct UctSuccessors {
+    int number_of_successors;
+    int visits[MAX_NUMBER_OF_SUCCESSORS]; // greater 0 for all successors (also for the ones which are not selectable)
+    double accumulated_rewards[MAX_NUMBER_OF_SUCCESSORS]; // of the player to move at the node
+    double log_trials[MAX_NUMBER_OF_SUCCESSORS];
+    bool selectable[MAX_NUMBER_OF_SUCCESSORS]; // e.g. legal for the current card assignment
+    double values[MAX_NUMBER_OF_SUCCESSORS]; // computed by select_uct_successor()
+};
+
+/* fills successors.values and returns the index of the best selectable successor, -1 if none is selectable */
+int select_uct_successor(UctSuccessors &successors, double exploration_constant, double epsilon);
+
+/* the scalar formula for one successor, used to validate select_uct_successor() */
+double compute_uct_value_reference(int visits, double accumulated_reward, double log_trials, double exploration_constant);
+
+#endif
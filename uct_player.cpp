@@ -20,46 +20,41 @@
 #include "uct_player.h"
 
 #include "belief_game_state.h"
+#include "checkpoint.h"
+#include "logging.h"
+#include "opening_book.h"
 #include "options.h"
 #include "uct.h"
 
 #include <cassert>
-#include <iostream>
 
 using namespace std;
 
-UctPlayer::UctPlayer(int player_number, const Options &options_) : Player(player_number), options(options_),
-    current_belief_state(0), first_player(0), vorfuehrung(false), number_of_current_game(0), counter(0) {
-    for (int i = 0; i < 4; ++i) {
-        if (options.use_compulsory_solo())
-            played_compulsory_solo[i] = false;
-        else
-            played_compulsory_solo[i] = true;
-    }
+UctPlayer::UctPlayer(int player_number, const Options &options_, const OpeningBook *opening_book_)
+    : BeliefPlayer(player_number, options_), counter(0), opening_book(opening_book_) {
+    assert(opening_book == 0 || opening_book->is_compatible(options, id));
 }
 
-UctPlayer::~UctPlayer() {
-    delete current_belief_state;
+void UctPlayer::set_cards(Cards cards_) {
+    BeliefPlayer::set_cards(cards_);
+    game_type_determination_history.clear();
 }
 
-void UctPlayer::check_vorfuehrung(int number_of_remaining_games) {
-    int remaining_compulsory_solos = 0;
-    for (int i = 0; i < 4; ++i) {
-        if (!played_compulsory_solo[i])
-            ++remaining_compulsory_solos;
-    }
-    assert(remaining_compulsory_solos <= number_of_remaining_games);
-    if (remaining_compulsory_solos == number_of_remaining_games) {
-        vorfuehrung = true;
-    }
+uint64_t UctPlayer::get_opening_book_key() const {
+    bool played_compulsory_solo_by_position[4];
+    for (int i = 0; i < 4; ++i)
+        played_compulsory_solo_by_position[(i - first_player + 4) % 4] = played_compulsory_solo[i];
+    return OpeningBook::compute_key(cards, (id - first_player + 4) % 4, played_compulsory_solo_by_position,
+                                    vorfuehrung, game_type_determination_history);
 }
 
-void UctPlayer::set_cards(Cards cards_) {
-    Player::set_cards(cards_);
-    delete current_belief_state;
-    if (!vorfuehrung)
-        check_vorfuehrung(options.get_number_of_games() - number_of_current_game);
-    current_belief_state = new BeliefGameState(options, id, played_compulsory_solo, vorfuehrung, first_player, cards);
+int UctPlayer::get_opening_book_move_index(const vector<Move> &legal_moves) const {
+    int move_id = opening_book->lookup(get_opening_book_key());
+    for (size_t i = 0; i < legal_moves.size(); ++i) {
+        if (legal_moves[i].get_id() == move_id)
+            return i;
+    }
+    return -1;
 }
 
 size_t UctPlayer::ask_for_move(const vector<Move> &legal_moves) {
@@ -75,45 +70,42 @@ size_t UctPlayer::ask_for_move(const vector<Move> &legal_moves) {
     }
     if (options.get_announcement_option(id) == 0 && legal_moves[0].is_announcement_move()) { // if announcing is forbiden, no uct needed
         return 0;
-    } else {
-        Uct uct(options, *current_belief_state, cards, counter);
-        if (options.get_uct_version(id) == 1) {
-            const vector<BeliefGameState *> &compare_states = uct.get_belief_game_states();
-            for (size_t i = 0; i < compare_states.size(); ++i) {
-                vector<Move> legal_moves2;
-                compare_states[i]->get_legal_moves(legal_moves2);
-                assert(legal_moves.size() == legal_moves2.size());
-                for (size_t i = 0; i < legal_moves.size(); ++i) {
-                    assert(legal_moves[i] == legal_moves2[i]);
-                }
+    }
+    if (opening_book != 0 && (legal_moves[0].is_question_move() || legal_moves[0].is_game_type_move())) {
+        int move_index = get_opening_book_move_index(legal_moves);
+        if (move_index != -1) {
+            if (log_enabled(LOG_UCT, LOG_VERBOSE))
+                log_stream() << "uct player " << id << " uses the opening book\n";
+            return move_index;
+        }
+    }
+    Uct uct(options, *current_belief_state, cards, counter);
+    if (options.get_uct_version(id) == 1) {
+        const vector<BeliefGameState *> &compare_states = uct.get_belief_game_states();
+        for (size_t i = 0; i < compare_states.size(); ++i) {
+            vector<Move> legal_moves2;
+            compare_states[i]->get_legal_moves(legal_moves2);
+            assert(legal_moves.size() == legal_moves2.size());
+            for (size_t i = 0; i < legal_moves.size(); ++i) {
+                assert(legal_moves[i] == legal_moves2[i]);
             }
         }
-        return uct.get_best_move();
     }
+    return uct.get_best_move();
 }
 
 void UctPlayer::inform_about_move(int player, const Move &move) {
-    Player::inform_about_move(player, move);
-    //if (options.use_debug())
-        //cout << "uctplayer " << id << " setting move" << endl;
-    current_belief_state->set_move(player, move);
-    //if (options.use_debug())
-        //cout << endl;
+    if (move.is_question_move() || move.is_game_type_move())
+        game_type_determination_history.push_back(OpeningBook::get_history_entry((player - first_player + 4) % 4, move));
+    BeliefPlayer::inform_about_move(player, move);
 }
 
-void UctPlayer::inform_about_game_end(const int players_game_points[4]) {
-    ++number_of_current_game;
-    int new_points[4] = { 0, 0, 0, 0 };
-    int new_points2[4] = { 0, 0, 0, 0 };
-    // pass new_points2 as a dummy just to avoid output in GameState
-    current_belief_state->get_score_points(new_points, new_points2);
-    for (int i = 0; i < 4; ++i) {
-        assert(players_game_points[i] == new_points[i]);
-    }
-    if (current_belief_state->is_compulsory_solo()) {
-        int solo_player = current_belief_state->get_compulsory_solo_player();
-        played_compulsory_solo[solo_player] = true;
-    }
-    if (!current_belief_state->is_compulsory_solo() || vorfuehrung)
-        first_player = next_player(first_player);
+void UctPlayer::write_checkpoint(CheckpointWriter &writer) const {
+    BeliefPlayer::write_checkpoint(writer);
+    writer.write_int(counter);
+}
+
+void UctPlayer::read_checkpoint(CheckpointReader &reader) {
+    BeliefPlayer::read_checkpoint(reader);
+    counter = reader.read_int();
 }
@@ -20,28 +20,28 @@
 #ifndef UCT_PLAYER_H
 #define UCT_PLAYER_H
 
-#include "player.h"
-
-class BeliefGameState;
-class Options;
-
-class UctPlayer : public Player {
-    const Options &options;
-    BeliefGameState *current_belief_state;
-    bool played_compulsory_solo[4];
-    int first_player;
-    bool vorfuehrung;
-    int number_of_current_game;
+#include "belief_player.h"
+
+#include <cstdint>
+#include <vector>
+
+class OpeningBook;
+
+class UctPlayer : public BeliefPlayer {
     int counter;
+    const OpeningBook *opening_book; // 0 if no (compatible) opening book is used
+    std::vector<int> game_type_determination_history; // moves of the current game relevant for the opening book, see OpeningBook
 
-    void check_vorfuehrung(int number_of_remaining_games);
+    int get_opening_book_move_index(const std::vector<Move> &legal_moves) const; // returns -1 if the book contains no decision
+protected:
+    uint64_t get_opening_book_key() const; // key of the current game type determination decision, added for building opening books
 public:
-    UctPlayer(int player_number, const Options &options);
-    ~UctPlayer();
+    UctPlayer(int player_number, const Options &options, const OpeningBook *opening_book); // opening_book (owned by the caller) is 0 or compatible with the options of the player, see get_opening_book_for_player()
     void set_cards(Cards cards);
     size_t ask_for_move(const std::vector<Move> &legal_moves);
     void inform_about_move(int player, const Move &move);
-    void inform_about_game_end(const int players_game_points[4]);
+    void write_checkpoint(CheckpointWriter &writer) const;
+    void read_checkpoint(CheckpointReader &reader);
 };
 
 #endif